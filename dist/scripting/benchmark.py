@@ -0,0 +1,51 @@
+"""
+Compares the memory read throughput of the UDP and local RPC transports of a running Citra.
+
+Usage: python3 benchmark.py [address] [size]
+"""
+import sys
+import time
+
+from citra import Citra, CitraLocal
+
+def measure(name, read, size, duration=2.0):
+    reads = 0
+    start = time.perf_counter()
+    while time.perf_counter() - start < duration:
+        if read() is None:
+            print("{}: read failed".format(name))
+            return
+        reads += 1
+    elapsed = time.perf_counter() - start
+    print("{:<24} {:>10.1f} reads/s {:>10.2f} MiB/s".format(
+        name, reads / elapsed, reads * size / elapsed / (1024 * 1024)))
+
+def main():
+    address = int(sys.argv[1], 0) if len(sys.argv) > 1 else 0x100000
+    size = int(sys.argv[2], 0) if len(sys.argv) > 2 else 0x1000
+    ranges = [(address + offset, 0x100) for offset in range(0, size, 0x100)]
+
+    udp = Citra()
+    measure("UDP read", lambda: udp.read_memory(address, size), size)
+
+    local = CitraLocal()
+    measure("Local read", lambda: local.read_memory(address, size), size)
+    measure("Local batch read", lambda: local.read_memory_batch(ranges), size)
+
+    subscription_id = local.subscribe(ranges)
+    if subscription_id is None:
+        print("Subscribe failed")
+        return
+    frames = 0
+    start = time.perf_counter()
+    while time.perf_counter() - start < 2.0:
+        local.wait_for_update()
+        local.read_subscription(subscription_id)
+        frames += 1
+    elapsed = time.perf_counter() - start
+    print("{:<24} {:>10.1f} frames/s {:>9.2f} MiB/s".format(
+        "Subscription", frames / elapsed, frames * size / elapsed / (1024 * 1024)))
+    local.unsubscribe(subscription_id)
+
+if "__main__" == __name__:
+    main()
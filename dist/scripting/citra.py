@@ -2,20 +2,47 @@ import struct
 import random
 import enum
 import socket
+import mmap
+import os
 
 CURRENT_REQUEST_VERSION = 1
 MAX_REQUEST_DATA_SIZE = 32
 MAX_PACKET_SIZE = 48
+MAX_LOCAL_REQUEST_DATA_SIZE = 0x100000
 
 class RequestType(enum.IntEnum):
     ReadMemory = 1,
-    WriteMemory = 2
+    WriteMemory = 2,
+    ReadServiceStatistics = 3,
+    ReadMemoryBatch = 4,
+    Subscribe = 5,
+    Unsubscribe = 6,
+    SubscriptionUpdate = 7
 
 CITRA_PORT = 45987
 
+def default_local_socket_path():
+    """
+    Returns the path Citra serves the local socket on when rpc_socket_path is not configured.
+    """
+    runtime_dir = os.environ.get("XDG_RUNTIME_DIR")
+    if runtime_dir:
+        return os.path.join(runtime_dir, "citra-rpc.sock")
+    return "/tmp/citra-rpc-{}.sock".format(os.getuid())
+
+SNAPSHOT_MAGIC = 0x504E5343
+SNAPSHOT_HEADER_SIZE = 16
+
+REQUEST_TIMEOUT = 1.0
+REQUEST_ATTEMPTS = 4
+
 class Citra:
-    def __init__(self, address="127.0.0.1", port=CITRA_PORT):
+    max_request_data_size = MAX_REQUEST_DATA_SIZE
+
+    def __init__(self, address="127.0.0.1", port=CITRA_PORT, timeout=REQUEST_TIMEOUT):
         self.socket = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        # Datagrams may be lost, which would otherwise block the next recv forever
+        self.socket.settimeout(timeout)
         self.address = address
 
     def is_connected(self):
@@ -34,6 +61,27 @@ class Citra:
             return raw_reply[4*4:]
         return None
 
+    def _request(self, request_type, request_data):
+        """
+        Sends a request and returns the data of its reply, or None if it was rejected. The request
+        is sent again when no reply arrives in time, and socket.timeout is raised after the last
+        attempt.
+        """
+        request, request_id = self._generate_header(request_type, len(request_data))
+        request += request_data
+        for attempt in range(REQUEST_ATTEMPTS):
+            self.socket.sendto(request, (self.address, CITRA_PORT))
+            try:
+                while True:
+                    raw_reply = self.socket.recv(MAX_PACKET_SIZE)
+                    # Late replies to earlier attempts or requests are skipped
+                    if (len(raw_reply) >= 4*4 and
+                        struct.unpack("IIII", raw_reply[:4*4])[1] == request_id):
+                        return self._read_and_validate_header(raw_reply, request_id, request_type)
+            except socket.timeout:
+                if attempt + 1 == REQUEST_ATTEMPTS:
+                    raise
+
     def read_memory(self, read_address, read_size):
         """
         >>> c.read_memory(0x100000, 4)
@@ -43,12 +91,7 @@ class Citra:
         while read_size > 0:
             temp_read_size = min(read_size, MAX_REQUEST_DATA_SIZE)
             request_data = struct.pack("II", read_address, temp_read_size)
-            request, request_id = self._generate_header(RequestType.ReadMemory, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.ReadMemory)
+            reply_data = self._request(RequestType.ReadMemory, request_data)
 
             if reply_data:
                 result += reply_data
@@ -75,12 +118,7 @@ class Citra:
             temp_write_size = min(write_size, MAX_REQUEST_DATA_SIZE - 8)
             request_data = struct.pack("II", write_address, temp_write_size)
             request_data += write_contents[:temp_write_size]
-            request, request_id = self._generate_header(RequestType.WriteMemory, len(request_data))
-            request += request_data
-            self.socket.sendto(request, (self.address, CITRA_PORT))
-
-            raw_reply = self.socket.recv(MAX_PACKET_SIZE)
-            reply_data = self._read_and_validate_header(raw_reply, request_id, RequestType.WriteMemory)
+            reply_data = self._request(RequestType.WriteMemory, request_data)
 
             if None != reply_data:
                 write_address += temp_write_size
@@ -90,6 +128,164 @@ class Citra:
                 return False
         return True
 
+    def read_service_statistics(self):
+        """
+        Returns the HLE service call statistics as CSV text, with one line per command.
+
+        >>> c.read_service_statistics().splitlines()[0].split(",")[:3]
+        ['service', 'function', 'count']
+        """
+        result = bytes()
+        while True:
+            request_data = struct.pack("II", len(result), self.max_request_data_size)
+            reply_data = self._request(RequestType.ReadServiceStatistics, request_data)
+            if reply_data is None:
+                return None
+            if not reply_data:
+                return result.decode()
+            result += reply_data
+
+    def read_memory_batch(self, ranges):
+        """
+        Reads several (address, size) ranges of memory. Returns the contents of each range.
+
+        >>> c.read_memory_batch([(0x100000, 4), (0x100000, 2)])
+        [b'\\x07\\x00\\x00\\xeb', b'\\x07\\x00']
+        """
+        results = []
+        for address, size in ranges:
+            result = self.read_memory(address, size)
+            if result is None:
+                return None
+            results.append(result)
+        return results
+
+class CitraLocal(Citra):
+    """
+    Connects over the local socket, which allows large requests and subscriptions to memory
+    ranges that are delivered through shared memory at every frame.
+    """
+    max_request_data_size = MAX_LOCAL_REQUEST_DATA_SIZE
+
+    def __init__(self, path=None):
+        self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.socket.connect(path or default_local_socket_path())
+        self.subscriptions = {}
+        self.pending_updates = []
+
+    def _receive_exactly(self, size):
+        data = bytes()
+        while len(data) < size:
+            chunk = self.socket.recv(size - len(data))
+            if not chunk:
+                raise ConnectionError("Connection closed by Citra")
+            data += chunk
+        return data
+
+    def _receive_packet(self):
+        raw_header = self._receive_exactly(4*4)
+        data_size = struct.unpack("IIII", raw_header)[3]
+        return raw_header + self._receive_exactly(data_size)
+
+    def _request(self, request_type, request_data):
+        request, request_id = self._generate_header(request_type, len(request_data))
+        self.socket.sendall(request + request_data)
+        while True:
+            raw_reply = self._receive_packet()
+            if struct.unpack("IIII", raw_reply[:4*4])[2] == RequestType.SubscriptionUpdate:
+                self.pending_updates.append(struct.unpack("II", raw_reply[4*4:]))
+                continue
+            return self._read_and_validate_header(raw_reply, request_id, request_type)
+
+    def read_memory(self, read_address, read_size):
+        result = bytes()
+        while read_size > 0:
+            temp_read_size = min(read_size, MAX_LOCAL_REQUEST_DATA_SIZE)
+            reply_data = self._request(RequestType.ReadMemory,
+                                       struct.pack("II", read_address, temp_read_size))
+            if not reply_data:
+                return None
+            result += reply_data
+            read_size -= len(reply_data)
+            read_address += len(reply_data)
+        return result
+
+    def write_memory(self, write_address, write_contents):
+        while write_contents:
+            temp_write_size = min(len(write_contents), MAX_LOCAL_REQUEST_DATA_SIZE - 8)
+            request_data = struct.pack("II", write_address, temp_write_size)
+            request_data += write_contents[:temp_write_size]
+            if self._request(RequestType.WriteMemory, request_data) is None:
+                return False
+            write_address += temp_write_size
+            write_contents = write_contents[temp_write_size:]
+        return True
+
+    @staticmethod
+    def _pack_ranges(ranges):
+        request_data = struct.pack("I", len(ranges))
+        for address, size in ranges:
+            request_data += struct.pack("II", address, size)
+        return request_data
+
+    def read_memory_batch(self, ranges):
+        reply_data = self._request(RequestType.ReadMemoryBatch, self._pack_ranges(ranges))
+        if not reply_data:
+            return None
+        results = []
+        for _, size in ranges:
+            results.append(reply_data[:size])
+            reply_data = reply_data[size:]
+        return results
+
+    def subscribe(self, ranges):
+        """
+        Subscribes to (address, size) ranges of memory. Returns the id of the subscription, whose
+        contents can be read with read_subscription after every frame.
+        """
+        reply_data = self._request(RequestType.Subscribe, self._pack_ranges(ranges))
+        if not reply_data:
+            return None
+        subscription_id, shared_memory_size = struct.unpack("II", reply_data[:8])
+        name = reply_data[8:].decode()
+        with open("/dev/shm/" + name.lstrip("/"), "rb") as shared_memory_file:
+            shared_memory = mmap.mmap(shared_memory_file.fileno(), shared_memory_size,
+                                      access=mmap.ACCESS_READ)
+        self.subscriptions[subscription_id] = (shared_memory, [size for _, size in ranges])
+        return subscription_id
+
+    def unsubscribe(self, subscription_id):
+        shared_memory, _ = self.subscriptions.pop(subscription_id)
+        shared_memory.close()
+        return self._request(RequestType.Unsubscribe, struct.pack("I", subscription_id)) is not None
+
+    def wait_for_update(self):
+        """Waits until a subscription is updated. Returns its id and the frame number."""
+        if self.pending_updates:
+            return self.pending_updates.pop(0)
+        raw_update = self._receive_packet()
+        return struct.unpack("II", raw_update[4*4:])
+
+    def read_subscription(self, subscription_id):
+        """
+        Returns the frame number and the contents of the ranges of the latest snapshot.
+        """
+        shared_memory, sizes = self.subscriptions[subscription_id]
+        while True:
+            magic, sequence, frame, data_size = struct.unpack_from("IIII", shared_memory)
+            if magic != SNAPSHOT_MAGIC:
+                return None
+            if sequence % 2 != 0:
+                continue
+            data = shared_memory[SNAPSHOT_HEADER_SIZE:SNAPSHOT_HEADER_SIZE + data_size]
+            if struct.unpack_from("I", shared_memory, 4)[0] != sequence:
+                continue
+            results = []
+            for size in sizes:
+                results.append(data[:size])
+                data = data[size:]
+            return frame, results
+
 if "__main__" == __name__:
     import doctest
     doctest.testmod(extraglobs={'c': Citra()})
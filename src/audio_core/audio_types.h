@@ -6,7 +6,7 @@
 
 #include <array>
 #include <cstddef>
-#include <deque>
+#include <vector>
 #include "common/common_types.h"
 
 namespace AudioCore {
@@ -23,8 +23,9 @@ using StereoFrame16 = std::array<std::array<s16, 2>, samples_per_frame>;
 /// The DSP is quadraphonic internally.
 using QuadFrame32 = std::array<std::array<s32, 4>, samples_per_frame>;
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/// A variable length buffer of signed PCM16 stereo samples. Users keep these around and refill
+/// them, so that decoding a buffer does not allocate once the capacity has grown large enough.
+using StereoBuffer16 = std::vector<std::array<s16, 2>>;
 
 constexpr std::size_t num_dsp_pipe = 8;
 enum class DspPipe {
@@ -6,6 +6,9 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/audio_types.h"
 #include "audio_core/codec.h"
 #include "common/assert.h"
@@ -13,8 +16,9 @@
 
 namespace AudioCore::Codec {
 
-StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
-                           const std::array<s16, 16>& adpcm_coeff, ADPCMState& state) {
+void DecodeADPCM(const u8* const data, const std::size_t sample_count,
+                 const std::array<s16, 16>& adpcm_coeff, ADPCMState& state,
+                 StereoBuffer16& output) {
     // GC-ADPCM with scale factor and variable coefficients.
     // Frames are 8 bytes long containing 14 samples each.
     // Samples are 4 bits (one nibble) long.
@@ -26,7 +30,7 @@ StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
 
     const std::size_t ret_size =
         sample_count % 2 == 0 ? sample_count : sample_count + 1; // Ensure multiple of two.
-    StereoBuffer16 ret(ret_size);
+    output.resize(ret_size);
 
     int yn1 = state.yn1, yn2 = state.yn2;
 
@@ -61,11 +65,11 @@ StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
         std::size_t datai = framei * FRAME_LEN + 1;
         for (std::size_t i = 0; i < SAMPLES_PER_FRAME && outputi < sample_count; i += 2) {
             const s16 sample1 = decode_sample(SIGNED_NIBBLES[data[datai] >> 4]);
-            ret[outputi].fill(sample1);
+            output[outputi].fill(sample1);
             outputi++;
 
             const s16 sample2 = decode_sample(SIGNED_NIBBLES[data[datai] & 0xF]);
-            ret[outputi].fill(sample2);
+            output[outputi].fill(sample2);
             outputi++;
 
             datai++;
@@ -74,52 +78,85 @@ StereoBuffer16 DecodeADPCM(const u8* const data, const std::size_t sample_count,
 
     state.yn1 = static_cast<s16>(yn1);
     state.yn2 = static_cast<s16>(yn2);
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM8(const unsigned num_channels, const u8* const data,
-                          const std::size_t sample_count) {
+void DecodePCM8(const unsigned num_channels, const u8* const data, const std::size_t sample_count,
+                StereoBuffer16& output) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
     const auto decode_sample = [](u8 sample) {
         return static_cast<s16>(static_cast<u16>(sample) << 8);
     };
 
-    StereoBuffer16 ret(sample_count);
+    output.resize(sample_count);
 
+    std::size_t i = 0;
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i].fill(decode_sample(data[i]));
+#ifdef ARCHITECTURE_x86_64
+        // Interleaving a zero byte below each sample shifts it into the high byte, and the
+        // result is then interleaved with itself to fill both channels.
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 16 <= sample_count; i += 16) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            const __m128i lo = _mm_unpacklo_epi8(zero, bytes);
+            const __m128i hi = _mm_unpackhi_epi8(zero, bytes);
+            __m128i* const dest = reinterpret_cast<__m128i*>(&output[i]);
+            _mm_storeu_si128(dest + 0, _mm_unpacklo_epi16(lo, lo));
+            _mm_storeu_si128(dest + 1, _mm_unpackhi_epi16(lo, lo));
+            _mm_storeu_si128(dest + 2, _mm_unpacklo_epi16(hi, hi));
+            _mm_storeu_si128(dest + 3, _mm_unpackhi_epi16(hi, hi));
+        }
+#endif
+        for (; i < sample_count; i++) {
+            output[i].fill(decode_sample(data[i]));
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; i++) {
-            ret[i][0] = decode_sample(data[i * 2 + 0]);
-            ret[i][1] = decode_sample(data[i * 2 + 1]);
+#ifdef ARCHITECTURE_x86_64
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= sample_count; i += 8) {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 2));
+            __m128i* const dest = reinterpret_cast<__m128i*>(&output[i]);
+            _mm_storeu_si128(dest + 0, _mm_unpacklo_epi8(zero, bytes));
+            _mm_storeu_si128(dest + 1, _mm_unpackhi_epi8(zero, bytes));
+        }
+#endif
+        for (; i < sample_count; i++) {
+            output[i][0] = decode_sample(data[i * 2 + 0]);
+            output[i][1] = decode_sample(data[i * 2 + 1]);
         }
     }
-
-    return ret;
 }
 
-StereoBuffer16 DecodePCM16(const unsigned num_channels, const u8* const data,
-                           const std::size_t sample_count) {
+void DecodePCM16(const unsigned num_channels, const u8* const data, const std::size_t sample_count,
+                 StereoBuffer16& output) {
     ASSERT(num_channels == 1 || num_channels == 2);
 
-    StereoBuffer16 ret(sample_count);
+    output.resize(sample_count);
+
+    if (sample_count == 0) {
+        return;
+    }
 
     if (num_channels == 1) {
-        for (std::size_t i = 0; i < sample_count; i++) {
+        std::size_t i = 0;
+#ifdef ARCHITECTURE_x86_64
+        for (; i + 8 <= sample_count; i += 8) {
+            const __m128i samples =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * sizeof(s16)));
+            __m128i* const dest = reinterpret_cast<__m128i*>(&output[i]);
+            _mm_storeu_si128(dest + 0, _mm_unpacklo_epi16(samples, samples));
+            _mm_storeu_si128(dest + 1, _mm_unpackhi_epi16(samples, samples));
+        }
+#endif
+        for (; i < sample_count; i++) {
             s16 sample;
             std::memcpy(&sample, data + i * sizeof(s16), sizeof(s16));
-            ret[i].fill(sample);
+            output[i].fill(sample);
         }
     } else {
-        for (std::size_t i = 0; i < sample_count; ++i) {
-            std::memcpy(&ret[i], data + i * sizeof(s16) * 2, 2 * sizeof(s16));
-        }
+        // Interleaved stereo data already has the layout of the output buffer.
+        static_assert(sizeof(StereoBuffer16::value_type) == 2 * sizeof(s16));
+        std::memcpy(output.data(), data, sample_count * 2 * sizeof(s16));
     }
-
-    return ret;
 }
 } // namespace AudioCore::Codec
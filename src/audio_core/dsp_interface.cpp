@@ -2,23 +2,38 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <cstddef>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/sink.h"
 #include "audio_core/sink_details.h"
 #include "common/assert.h"
+#include "core/perf_stats.h"
 #include "core/settings.h"
 
 namespace AudioCore {
 
-DspInterface::DspInterface() = default;
-DspInterface::~DspInterface() = default;
+DspInterface::DspInterface()
+    : stretch_input(fifo_capacity * 2), stretch_output(fifo_capacity * 2),
+      stretch_thread([this] { StretchThread(); }) {}
+
+DspInterface::~DspInterface() {
+    stop_stretching = true;
+    stretch_event.Set();
+    stretch_thread.join();
+}
+
+void DspInterface::SetPerfStats(Core::PerfStats* perf_stats_) {
+    perf_stats = perf_stats_;
+}
 
 void DspInterface::SetSink(const std::string& sink_id, const std::string& audio_device) {
     sink = CreateSinkFromID(Settings::values.sink_id, Settings::values.audio_device_id);
     sink->SetCallback(
         [this](s16* buffer, std::size_t num_frames) { OutputCallback(buffer, num_frames); });
-    time_stretcher.SetOutputSampleRate(sink->GetNativeSampleRate());
+    emulated_time_sink = sink->IsEmulatedTime();
+    // The stretch thread passes the new rate on to the time stretcher
+    output_sample_rate = sink->GetNativeSampleRate();
 }
 
 Sink& DspInterface::GetSink() {
@@ -27,42 +42,63 @@ Sink& DspInterface::GetSink() {
 }
 
 void DspInterface::EnableStretching(bool enable) {
-    if (perform_time_stretching == enable)
-        return;
-
-    if (!enable) {
-        flushing_time_stretcher = true;
-    }
     perform_time_stretching = enable;
 }
 
-void DspInterface::OutputFrame(StereoFrame16& frame) {
+void DspInterface::OutputFrame(StereoFrame16& frame, std::chrono::nanoseconds generation_time) {
     if (!sink)
         return;
 
+    if (emulated_time_sink) {
+        sink->PushSamples(frame[0].data(), frame.size(), generation_time);
+        return;
+    }
+
     fifo.Push(frame.data(), frame.size());
+    produced_frames.fetch_add(frame.size(), std::memory_order_relaxed);
 }
 
 void DspInterface::OutputSample(std::array<s16, 2> sample) {
     if (!sink)
         return;
 
+    if (emulated_time_sink) {
+        sink->PushSamples(sample.data(), 1, {});
+        return;
+    }
+
     fifo.Push(&sample, 1);
+    produced_frames.fetch_add(1, std::memory_order_relaxed);
 }
 
 void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
-    std::size_t frames_written;
-    if (perform_time_stretching) {
-        const std::vector<s16> in{fifo.Pop()};
-        const std::size_t num_in{in.size() / 2};
-        frames_written = time_stretcher.Process(in.data(), num_in, buffer, num_frames);
-    } else if (flushing_time_stretcher) {
-        time_stretcher.Flush();
-        frames_written = time_stretcher.Process(nullptr, 0, buffer, num_frames);
-        frames_written += fifo.Pop(buffer, num_frames - frames_written);
-        flushing_time_stretcher = false;
+    std::size_t frames_written = output_fifo.Pop(buffer, num_frames);
+
+    // Only one thread may consume fifo. The stretch thread owns it from the first request to
+    // stretch until it has flushed the stretcher, and without stretching this callback plays fifo
+    // directly, so that unstretched audio does not wait for another thread.
+    const bool stretch = perform_time_stretching;
+    stretch_requested = stretch;
+    if (stretch) {
+        stretcher_owns_fifo = true;
+    }
+    if (stretcher_owns_fifo) {
+        requested_frames = num_frames;
+        stretch_event.Set();
     } else {
-        frames_written = fifo.Pop(buffer, num_frames);
+        frames_written += fifo.Pop(buffer + 2 * frames_written, num_frames - frames_written);
+    }
+
+    // When nothing was produced since the previous callback, the emulation is paused or not
+    // running yet, and running out of samples is expected rather than an underrun.
+    const u64 produced = produced_frames.load(std::memory_order_relaxed);
+    const bool emulation_running = produced != produced_frames_at_last_callback;
+    produced_frames_at_last_callback = produced;
+    if (perf_stats != nullptr && emulation_running) {
+        const std::size_t queued_frames = fifo.Size() + output_fifo.Size();
+        perf_stats->AddAudioCallback(
+            frames_written < num_frames,
+            std::chrono::microseconds(queued_frames * 1'000'000 / output_sample_rate));
     }
 
     if (frames_written > 0) {
@@ -86,4 +122,49 @@ void DspInterface::OutputCallback(s16* buffer, std::size_t num_frames) {
     }
 }
 
+void DspInterface::StretchThread() {
+    u32 stretcher_sample_rate = 0;
+
+    while (true) {
+        stretch_event.Wait();
+        if (stop_stretching) {
+            return;
+        }
+
+        const u32 sample_rate = output_sample_rate;
+        if (sample_rate != stretcher_sample_rate) {
+            time_stretcher.SetOutputSampleRate(sample_rate);
+            stretcher_sample_rate = sample_rate;
+        }
+
+        // Only ever produce as much as fits, so that the audio thread never has to wait for us.
+        const std::size_t queued_frames = output_fifo.Size();
+        const std::size_t free_frames = output_fifo.Capacity() - queued_frames;
+
+        if (!stretch_requested) {
+            // Play the stretcher's residual audio before unstretched audio resumes
+            time_stretcher.Flush();
+            const std::size_t frames =
+                time_stretcher.Process(nullptr, 0, stretch_output.data(), free_frames);
+            output_fifo.Push(stretch_output.data(), frames);
+            // Hands fifo back to OutputCallback
+            stretcher_owns_fifo = false;
+            continue;
+        }
+
+        // Keep two sink requests' worth of audio queued. In the steady state this asks for as
+        // many frames as the sink consumed since the last run.
+        const std::size_t target_frames =
+            std::min(2 * requested_frames.load(), output_fifo.Capacity());
+        if (target_frames <= queued_frames)
+            continue;
+
+        const std::size_t num_out = target_frames - queued_frames;
+        const std::size_t num_in = fifo.Pop(stretch_input.data(), fifo_capacity);
+        const std::size_t frames =
+            time_stretcher.Process(stretch_input.data(), num_in, stretch_output.data(), num_out);
+        output_fifo.Push(stretch_output.data(), frames);
+    }
+}
+
 } // namespace AudioCore
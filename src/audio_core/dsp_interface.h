@@ -4,14 +4,22 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <thread>
 #include <vector>
 #include "audio_core/audio_types.h"
 #include "audio_core/time_stretch.h"
 #include "common/common_types.h"
 #include "common/ring_buffer.h"
+#include "common/thread.h"
 #include "core/memory.h"
 
+namespace Core {
+class PerfStats;
+} // namespace Core
+
 namespace Service::DSP {
 class DSP_DSP;
 } // namespace Service::DSP
@@ -92,6 +100,8 @@ public:
     /// Unloads the DSP program
     virtual void UnloadComponent() = 0;
 
+    /// Sets where the statistics of the audio output are recorded. Must be called before SetSink.
+    void SetPerfStats(Core::PerfStats* perf_stats);
     /// Select the sink to use based on sink id.
     void SetSink(const std::string& sink_id, const std::string& audio_device);
     /// Get the current sink
@@ -100,19 +110,60 @@ public:
     void EnableStretching(bool enable);
 
 protected:
-    void OutputFrame(StereoFrame16& frame);
+    /**
+     * Outputs a frame of audio to the sink.
+     * @param frame The frame to output.
+     * @param generation_time Host time spent producing the frame, if known. This is passed on to
+     *                        sinks that run on emulated time.
+     */
+    void OutputFrame(StereoFrame16& frame, std::chrono::nanoseconds generation_time = {});
     void OutputSample(std::array<s16, 2> sample);
 
 private:
-    void FlushResidualStretcherAudio();
+    static constexpr std::size_t fifo_capacity = 0x2000;
+
+    /**
+     * Runs on the sink's audio thread. This must not block or allocate. It only takes the short
+     * lock of stretch_event while stretching.
+     */
     void OutputCallback(s16* buffer, std::size_t num_frames);
+    /**
+     * Runs on its own thread while stretching is enabled. Stretches the audio of fifo into
+     * output_fifo for OutputCallback.
+     */
+    void StretchThread();
 
+    Core::PerfStats* perf_stats = nullptr;
     std::unique_ptr<Sink> sink;
+    /// Whether sink runs on emulated time, in which case it is fed directly rather than via fifo.
+    bool emulated_time_sink = false;
     std::atomic<bool> perform_time_stretching = false;
-    std::atomic<bool> flushing_time_stretcher = false;
-    Common::RingBuffer<s16, 0x2000, 2> fifo;
+    /// Audio produced by the DSP, consumed by the stretch thread or OutputCallback.
+    Common::RingBuffer<s16, fifo_capacity, 2> fifo;
+    /// Audio waiting to be played, consumed by OutputCallback.
+    Common::RingBuffer<s16, fifo_capacity, 2> output_fifo;
     std::array<s16, 2> last_frame{};
+    std::atomic<u32> output_sample_rate{native_sample_rate};
+    /// Number of frames pushed to fifo, to tell underruns from a paused emulation.
+    std::atomic<u64> produced_frames{0};
+    /// Value of produced_frames at the previous OutputCallback, only used by the audio thread.
+    u64 produced_frames_at_last_callback = 0;
+
+    /// Size of the most recent sink request, used to decide how far ahead to fill output_fifo.
+    std::atomic<std::size_t> requested_frames{0};
+    /// Set by OutputCallback to wake the stretch thread.
+    Common::Event stretch_event;
+    /// Whether stretching was enabled at the most recent OutputCallback.
+    std::atomic<bool> stretch_requested{false};
+    /// Whether the stretch thread consumes fifo. Only cleared by the stretch thread.
+    std::atomic<bool> stretcher_owns_fifo{false};
+    std::atomic<bool> stop_stretching{false};
+
+    // Only accessed by the stretch thread
     TimeStretcher time_stretcher;
+    std::vector<s16> stretch_input;
+    std::vector<s16> stretch_output;
+    std::thread stretch_thread;
 };
 
 } // namespace AudioCore
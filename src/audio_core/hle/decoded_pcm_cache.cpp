@@ -0,0 +1,149 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/format.h>
+#include "audio_core/hle/adts.h"
+#include "audio_core/hle/decoded_pcm_cache.h"
+#include "common/cityhash.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+
+namespace AudioCore::HLE {
+
+namespace {
+constexpr u32 disk_entry_magic = 0x4D435044; // "DPCM"
+constexpr u32 disk_entry_version = 1;
+
+struct DiskEntryHeader {
+    u32_le magic;
+    u32_le version;
+    u32_le num_channels;
+    u32_le num_samples;
+    std::array<u32_le, 2> pcm_size;
+};
+static_assert(sizeof(DiskEntryHeader) == 24, "DiskEntryHeader has incorrect size");
+
+std::size_t EntrySize(const DecodedPCMCache::Entry& entry) {
+    return entry.pcm[0].size() + entry.pcm[1].size();
+}
+} // Anonymous namespace
+
+DecodedPCMCache::DecodedPCMCache(std::size_t memory_budget, std::string disk_path_)
+    : memory_budget(memory_budget), disk_path(std::move(disk_path_)) {
+    if (!disk_path.empty() && !FileUtil::CreateFullPath(disk_path)) {
+        LOG_ERROR(Audio_DSP, "Could not create decoded PCM cache directory {}", disk_path);
+        disk_path.clear();
+    }
+}
+
+DecodedPCMCache::~DecodedPCMCache() = default;
+
+u64 DecodedPCMCache::MakeKey(u64 previous_input_hash, u64 input_hash) {
+    return Common::Hash128to64({previous_input_hash, input_hash});
+}
+
+bool DecodedPCMCache::IsCacheable(const u8* data, std::size_t size) {
+    constexpr std::size_t adts_header_size = 7;
+
+    std::size_t offset = 0;
+    while (offset + adts_header_size <= size) {
+        const ADTSData header = ParseADTS(reinterpret_cast<const char*>(data + offset));
+        if (header.length == 0)
+            return false;
+        offset += header.length;
+    }
+    return offset == size && size != 0;
+}
+
+const DecodedPCMCache::Entry* DecodedPCMCache::Find(u64 key) {
+    const auto iter = index.find(key);
+    if (iter != index.end()) {
+        entries.splice(entries.begin(), entries, iter->second);
+        return &iter->second->second;
+    }
+
+    if (disk_path.empty())
+        return nullptr;
+
+    FileUtil::IOFile file(GetDiskPath(key), "rb");
+    if (!file.IsOpen())
+        return nullptr;
+
+    DiskEntryHeader header;
+    if (file.ReadBytes(&header, sizeof(header)) != sizeof(header) ||
+        header.magic != disk_entry_magic || header.version != disk_entry_version) {
+        return nullptr;
+    }
+
+    // The sizes come from the file, so they are checked before anything is allocated for them
+    const u64 data_size = file.GetSize() - sizeof(header);
+    if (static_cast<u64>(header.pcm_size[0]) + header.pcm_size[1] != data_size) {
+        LOG_WARNING(Audio_DSP, "Decoded PCM cache entry {:016X} is corrupt", key);
+        return nullptr;
+    }
+
+    Entry entry;
+    entry.num_channels = header.num_channels;
+    entry.num_samples = header.num_samples;
+    for (std::size_t channel = 0; channel < entry.pcm.size(); ++channel) {
+        entry.pcm[channel].resize(header.pcm_size[channel]);
+        if (file.ReadBytes(entry.pcm[channel].data(), entry.pcm[channel].size()) !=
+            entry.pcm[channel].size()) {
+            LOG_WARNING(Audio_DSP, "Decoded PCM cache entry {:016X} is truncated", key);
+            return nullptr;
+        }
+    }
+
+    return &InsertInMemory(key, std::move(entry));
+}
+
+void DecodedPCMCache::Insert(u64 key, Entry entry) {
+    if (!disk_path.empty()) {
+        FileUtil::IOFile file(GetDiskPath(key), "wb");
+        if (file.IsOpen()) {
+            DiskEntryHeader header{};
+            header.magic = disk_entry_magic;
+            header.version = disk_entry_version;
+            header.num_channels = entry.num_channels;
+            header.num_samples = entry.num_samples;
+            header.pcm_size = {static_cast<u32>(entry.pcm[0].size()),
+                               static_cast<u32>(entry.pcm[1].size())};
+            file.WriteObject(header);
+            file.WriteArray(entry.pcm[0].data(), entry.pcm[0].size());
+            file.WriteArray(entry.pcm[1].data(), entry.pcm[1].size());
+        }
+    }
+
+    InsertInMemory(key, std::move(entry));
+}
+
+const DecodedPCMCache::Entry& DecodedPCMCache::InsertInMemory(u64 key, Entry entry) {
+    const auto iter = index.find(key);
+    if (iter != index.end()) {
+        memory_usage -= EntrySize(iter->second->second);
+        entries.erase(iter->second);
+        index.erase(iter);
+    }
+
+    memory_usage += EntrySize(entry);
+    entries.emplace_front(key, std::move(entry));
+    index.emplace(key, entries.begin());
+
+    // Never evict the entry that was just added, even if it alone exceeds the budget.
+    while (memory_usage > memory_budget && entries.size() > 1) {
+        const auto& [oldest_key, oldest_entry] = entries.back();
+        memory_usage -= EntrySize(oldest_entry);
+        index.erase(oldest_key);
+        entries.pop_back();
+    }
+
+    return entries.front().second;
+}
+
+std::string DecodedPCMCache::GetDiskPath(u64 key) const {
+    return fmt::format("{}{:016X}.pcm", disk_path, key);
+}
+
+} // namespace AudioCore::HLE
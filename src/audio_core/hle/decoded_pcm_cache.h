@@ -0,0 +1,78 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace AudioCore::HLE {
+
+/**
+ * Cache of decoded AAC output, so that games replaying the same stretch of audio (e.g. looping
+ * BGM) do not pay for decoding it again. Entries are kept in memory up to a byte budget, evicting
+ * the least recently used, and are optionally persisted to disk as well.
+ *
+ * AAC frames overlap, so the same input decodes differently depending on what came before it.
+ * Keys therefore cover both the input and the input that preceded it; see MakeKey.
+ */
+class DecodedPCMCache {
+public:
+    struct Entry {
+        u32 num_channels = 0;
+        u32 num_samples = 0;
+        /// Decoded PCM16 for each channel
+        std::array<std::vector<u8>, 2> pcm;
+    };
+
+    /**
+     * @param memory_budget Maximum number of PCM bytes to keep in memory
+     * @param disk_path Directory entries are persisted to, ending in a path separator, or empty
+     *                  to keep them in memory only
+     */
+    explicit DecodedPCMCache(std::size_t memory_budget, std::string disk_path = "");
+    ~DecodedPCMCache();
+
+    /**
+     * Computes the cache key for a buffer.
+     * @param previous_input_hash Hash of the input decoded just before this one
+     * @param input_hash Hash of the input itself
+     */
+    static u64 MakeKey(u64 previous_input_hash, u64 input_hash);
+
+    /// Whether an input buffer consists of whole ADTS frames. Only those are worth caching.
+    static bool IsCacheable(const u8* data, std::size_t size);
+
+    /// Looks up an entry, loading it from disk if it is not in memory. Returns nullptr on miss.
+    const Entry* Find(u64 key);
+
+    /// Adds an entry, evicting older ones as needed to stay within the memory budget.
+    void Insert(u64 key, Entry entry);
+
+    /// Number of PCM bytes currently held in memory
+    std::size_t GetMemoryUsage() const {
+        return memory_usage;
+    }
+
+private:
+    using EntryList = std::list<std::pair<u64, Entry>>;
+
+    const Entry& InsertInMemory(u64 key, Entry entry);
+    std::string GetDiskPath(u64 key) const;
+
+    std::size_t memory_budget;
+    std::size_t memory_usage = 0;
+    std::string disk_path;
+
+    /// Most recently used first
+    EntryList entries;
+    std::unordered_map<u64, EntryList::iterator> index;
+};
+
+} // namespace AudioCore::HLE
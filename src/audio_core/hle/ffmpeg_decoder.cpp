@@ -2,8 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <fmt/format.h>
+#include "audio_core/hle/decoded_pcm_cache.h"
 #include "audio_core/hle/ffmpeg_decoder.h"
 #include "audio_core/hle/ffmpeg_dl.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "common/hash.h"
+#include "core/settings.h"
 
 namespace AudioCore::HLE {
 
@@ -20,6 +26,10 @@ private:
 
     std::optional<BinaryResponse> Decode(const BinaryRequest& request);
 
+    /// Runs data through the decoder, appending PCM16 to out_streams. Returns false on error.
+    bool DecodeBuffer(const u8* data, std::size_t data_size,
+                      std::array<std::vector<u8>, 2>& out_streams, BinaryResponse& response);
+
     struct AVPacketDeleter {
         void operator()(AVPacket* packet) const {
             av_packet_free_dl(&packet);
@@ -54,12 +64,32 @@ private:
     std::unique_ptr<AVCodecParserContext, AVCodecParserContextDeleter> parser;
     std::unique_ptr<AVPacket, AVPacketDeleter> av_packet;
     std::unique_ptr<AVFrame, AVFrameDeleter> decoded_frame;
+
+    DecodedPCMCache cache;
+    /// Hash of the input of the previous decode request
+    u64 previous_input_hash = 0;
+    /// Input of the previous request, if it was served from the cache and so never reached the
+    /// decoder. It has to be decoded before the next cache miss so the decoder state is right.
+    std::vector<u8> skipped_input;
 };
 
-FFMPEGDecoder::Impl::Impl(Memory::MemorySystem& memory) : memory(memory) {
-    have_ffmpeg_dl = InitFFmpegDL();
+/// Budget for decoded audio kept in memory. This is about three minutes of stereo audio.
+constexpr std::size_t decoded_pcm_cache_budget = 32 * 1024 * 1024;
+
+static std::string GetDecodedPCMCachePath(bool have_ffmpeg_dl) {
+    if (!Settings::values.enable_aac_disk_cache || !have_ffmpeg_dl)
+        return "";
+    // Other versions of FFmpeg may decode the same input differently, so each gets its own entries
+    const unsigned version = avcodec_version_dl();
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "aac" DIR_SEP +
+           fmt::format("avcodec-{}.{}.{}", version >> 16, (version >> 8) & 0xFF, version & 0xFF) +
+           DIR_SEP;
 }
 
+FFMPEGDecoder::Impl::Impl(Memory::MemorySystem& memory)
+    : have_ffmpeg_dl(InitFFmpegDL()), memory(memory),
+      cache(decoded_pcm_cache_budget, GetDecodedPCMCachePath(have_ffmpeg_dl)) {}
+
 FFMPEGDecoder::Impl::~Impl() = default;
 
 std::optional<BinaryResponse> FFMPEGDecoder::Impl::ProcessRequest(const BinaryRequest& request) {
@@ -138,6 +168,8 @@ void FFMPEGDecoder::Impl::Clear() {
     parser.reset();
     decoded_frame.reset();
     av_packet.reset();
+    previous_input_hash = 0;
+    skipped_input.clear();
 }
 
 std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& request) {
@@ -159,17 +191,71 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
         LOG_ERROR(Audio_DSP, "Got out of bounds src_addr {:08x}", request.src_addr);
         return {};
     }
-    u8* data = memory.GetFCRAMPointer(request.src_addr - Memory::FCRAM_PADDR);
+    const u8* data = memory.GetFCRAMPointer(request.src_addr - Memory::FCRAM_PADDR);
+
+    const u64 input_hash = Common::ComputeHash64(data, request.size);
+    const u64 cache_key = DecodedPCMCache::MakeKey(previous_input_hash, input_hash);
+    previous_input_hash = input_hash;
+
+    std::array<std::vector<u8>, 2> decoded_streams;
+    const DecodedPCMCache::Entry* entry = cache.Find(cache_key);
+    if (entry) {
+        response.num_channels = entry->num_channels;
+        response.num_samples = entry->num_samples;
+        skipped_input.assign(data, data + request.size);
+    } else {
+        if (!skipped_input.empty()) {
+            std::array<std::vector<u8>, 2> discarded_streams;
+            BinaryResponse discarded_response;
+            DecodeBuffer(skipped_input.data(), skipped_input.size(), discarded_streams,
+                         discarded_response);
+            skipped_input.clear();
+        }
 
-    std::array<std::vector<u8>, 2> out_streams;
+        if (!DecodeBuffer(data, request.size, decoded_streams, response)) {
+            return {};
+        }
 
-    std::size_t data_size = request.size;
+        if (DecodedPCMCache::IsCacheable(data, request.size)) {
+            cache.Insert(cache_key,
+                         {response.num_channels, response.num_samples, decoded_streams});
+        }
+    }
+    const auto& out_streams = entry ? entry->pcm : decoded_streams;
+
+    if (out_streams[0].size() != 0) {
+        if (request.dst_addr_ch0 < Memory::FCRAM_PADDR ||
+            request.dst_addr_ch0 + out_streams[0].size() >
+                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch0 {:08x}", request.dst_addr_ch0);
+            return {};
+        }
+        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch0 - Memory::FCRAM_PADDR),
+                    out_streams[0].data(), out_streams[0].size());
+    }
+
+    if (out_streams[1].size() != 0) {
+        if (request.dst_addr_ch1 < Memory::FCRAM_PADDR ||
+            request.dst_addr_ch1 + out_streams[1].size() >
+                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
+            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch1 {:08x}", request.dst_addr_ch1);
+            return {};
+        }
+        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch1 - Memory::FCRAM_PADDR),
+                    out_streams[1].data(), out_streams[1].size());
+    }
+    return response;
+}
+
+bool FFMPEGDecoder::Impl::DecodeBuffer(const u8* data, std::size_t data_size,
+                                       std::array<std::vector<u8>, 2>& out_streams,
+                                       BinaryResponse& response) {
     while (data_size > 0) {
         if (!decoded_frame) {
             decoded_frame.reset(av_frame_alloc_dl());
             if (!decoded_frame) {
                 LOG_ERROR(Audio_DSP, "Could not allocate audio frame");
-                return {};
+                return false;
             }
         }
 
@@ -178,7 +264,7 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
                                 data, data_size, AV_NOPTS_VALUE, AV_NOPTS_VALUE, 0);
         if (ret < 0) {
             LOG_ERROR(Audio_DSP, "Error while parsing");
-            return {};
+            return false;
         }
         data += ret;
         data_size -= ret;
@@ -186,7 +272,7 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
         ret = avcodec_send_packet_dl(av_context.get(), av_packet.get());
         if (ret < 0) {
             LOG_ERROR(Audio_DSP, "Error submitting the packet to the decoder");
-            return {};
+            return false;
         }
 
         if (av_packet->size) {
@@ -196,12 +282,12 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
                     break;
                 else if (ret < 0) {
                     LOG_ERROR(Audio_DSP, "Error during decoding");
-                    return {};
+                    return false;
                 }
                 int bytes_per_sample = av_get_bytes_per_sample_dl(av_context->sample_fmt);
                 if (bytes_per_sample < 0) {
                     LOG_ERROR(Audio_DSP, "Failed to calculate data size");
-                    return {};
+                    return false;
                 }
 
                 ASSERT(decoded_frame->channels <= out_streams.size());
@@ -229,28 +315,7 @@ std::optional<BinaryResponse> FFMPEGDecoder::Impl::Decode(const BinaryRequest& r
         }
     }
 
-    if (out_streams[0].size() != 0) {
-        if (request.dst_addr_ch0 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch0 + out_streams[0].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch0 {:08x}", request.dst_addr_ch0);
-            return {};
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch0 - Memory::FCRAM_PADDR),
-                    out_streams[0].data(), out_streams[0].size());
-    }
-
-    if (out_streams[1].size() != 0) {
-        if (request.dst_addr_ch1 < Memory::FCRAM_PADDR ||
-            request.dst_addr_ch1 + out_streams[1].size() >
-                Memory::FCRAM_PADDR + Memory::FCRAM_SIZE) {
-            LOG_ERROR(Audio_DSP, "Got out of bounds dst_addr_ch1 {:08x}", request.dst_addr_ch1);
-            return {};
-        }
-        std::memcpy(memory.GetFCRAMPointer(request.dst_addr_ch1 - Memory::FCRAM_PADDR),
-                    out_streams[1].data(), out_streams[1].size());
-    }
-    return response;
+    return true;
 }
 
 FFMPEGDecoder::FFMPEGDecoder(Memory::MemorySystem& memory) : impl(std::make_unique<Impl>(memory)) {}
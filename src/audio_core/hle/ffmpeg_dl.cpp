@@ -41,6 +41,7 @@ FuncDL<int(AVCodecParserContext*, AVCodecContext*, uint8_t**, int*, const uint8_
            int64_t, int64_t)>
     av_parser_parse2_dl;
 FuncDL<void(AVCodecParserContext*)> av_parser_close_dl;
+FuncDL<unsigned(void)> avcodec_version_dl;
 
 bool InitFFmpegDL() {
     std::string dll_path = FileUtil::GetUserPath(FileUtil::UserPath::DLLDir);
@@ -172,6 +173,12 @@ bool InitFFmpegDL() {
         return false;
     }
 
+    avcodec_version_dl = FuncDL<unsigned(void)>(dll_codec.get(), "avcodec_version");
+    if (!avcodec_version_dl) {
+        LOG_ERROR(Audio_DSP, "Can not load function avcodec_version");
+        return false;
+    }
+
     return true;
 }
 
@@ -50,6 +50,7 @@ extern FuncDL<int(AVCodecParserContext*, AVCodecContext*, uint8_t**, int*, const
                   int64_t, int64_t, int64_t)>
     av_parser_parse2_dl;
 extern FuncDL<void(AVCodecParserContext*)> av_parser_close_dl;
+extern FuncDL<unsigned(void)> avcodec_version_dl;
 
 bool InitFFmpegDL();
 
@@ -71,6 +72,7 @@ const auto avcodec_receive_frame_dl = &avcodec_receive_frame;
 const auto av_parser_init_dl = &av_parser_init;
 const auto av_parser_parse2_dl = &av_parser_parse2;
 const auto av_parser_close_dl = &av_parser_close;
+const auto avcodec_version_dl = &avcodec_version;
 
 bool InitFFmpegDL() {
     return true;
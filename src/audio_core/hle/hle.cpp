@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include "audio_core/audio_types.h"
 #ifdef HAVE_MF
 #include "audio_core/hle/wmf_decoder.h"
@@ -19,6 +20,7 @@
 #include "common/common_types.h"
 #include "common/hash.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 
@@ -377,14 +379,20 @@ StereoFrame16 DspHle::Impl::GenerateCurrentFrame() {
     return output_frame;
 }
 
+MICROPROFILE_DEFINE(Audio_DSPFrame, "Audio", "DSP Frame", MP_RGB(64, 160, 255));
+
 bool DspHle::Impl::Tick() {
+    MICROPROFILE_SCOPE(Audio_DSPFrame);
+    Core::PerfStats::ScopedComponent perf_component(Core::System::GetInstance().perf_stats,
+                                                    Core::PerfStats::Component::DSP);
     StereoFrame16 current_frame = {};
 
     // TODO: Check dsp::DSP semaphore (which indicates emulated application has finished writing to
     // shared memory region)
+    const auto start = std::chrono::steady_clock::now();
     current_frame = GenerateCurrentFrame();
 
-    parent.OutputFrame(current_frame);
+    parent.OutputFrame(current_frame, std::chrono::steady_clock::now() - start);
 
     return true;
 }
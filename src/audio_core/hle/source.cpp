@@ -4,6 +4,9 @@
 
 #include <algorithm>
 #include <array>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/codec.h"
 #include "audio_core/hle/common.h"
 #include "audio_core/hle/source.h"
@@ -14,6 +17,38 @@
 
 namespace AudioCore::HLE {
 
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains) {
+#ifdef ARCHITECTURE_x86_64
+    // Same computation as the scalar loop below, two stereo samples per iteration. Each sample is
+    // widened to {L, R, L, R} so all four quadraphonic channels are scaled at once.
+    static_assert(samples_per_frame % 2 == 0);
+    const __m128 gain = _mm_loadu_ps(gains.data());
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei += 2) {
+        const __m128i pair = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&source[samplei]));
+        const __m128i pair32 = _mm_srai_epi32(_mm_unpacklo_epi16(pair, pair), 16);
+
+        const __m128i quad0 = _mm_shuffle_epi32(pair32, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m128i quad1 = _mm_shuffle_epi32(pair32, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m128i mixed0 = _mm_cvttps_epi32(_mm_mul_ps(gain, _mm_cvtepi32_ps(quad0)));
+        const __m128i mixed1 = _mm_cvttps_epi32(_mm_mul_ps(gain, _mm_cvtepi32_ps(quad1)));
+
+        __m128i* const dest0 = reinterpret_cast<__m128i*>(&dest[samplei]);
+        __m128i* const dest1 = reinterpret_cast<__m128i*>(&dest[samplei + 1]);
+        _mm_storeu_si128(dest0, _mm_add_epi32(_mm_loadu_si128(dest0), mixed0));
+        _mm_storeu_si128(dest1, _mm_add_epi32(_mm_loadu_si128(dest1), mixed1));
+    }
+#else
+    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
+        // Conversion from stereo (source) to quadraphonic (dest) occurs here.
+        dest[samplei][0] += static_cast<s32>(gains[0] * source[samplei][0]);
+        dest[samplei][1] += static_cast<s32>(gains[1] * source[samplei][1]);
+        dest[samplei][2] += static_cast<s32>(gains[2] * source[samplei][0]);
+        dest[samplei][3] += static_cast<s32>(gains[3] * source[samplei][1]);
+    }
+#endif
+}
+
 SourceStatus::Status Source::Tick(SourceConfiguration::Configuration& config,
                                   const s16_le (&adpcm_coeffs)[16]) {
     ParseConfig(config, adpcm_coeffs);
@@ -29,14 +64,7 @@ void Source::MixInto(QuadFrame32& dest, std::size_t intermediate_mix_id) const {
     if (!state.enabled)
         return;
 
-    const std::array<float, 4>& gains = state.gain.at(intermediate_mix_id);
-    for (std::size_t samplei = 0; samplei < samples_per_frame; samplei++) {
-        // Conversion from stereo (current_frame) to quadraphonic (dest) occurs here.
-        dest[samplei][0] += static_cast<s32>(gains[0] * current_frame[samplei][0]);
-        dest[samplei][1] += static_cast<s32>(gains[1] * current_frame[samplei][1]);
-        dest[samplei][2] += static_cast<s32>(gains[2] * current_frame[samplei][0]);
-        dest[samplei][3] += static_cast<s32>(gains[3] * current_frame[samplei][1]);
-    }
+    MixStereoIntoQuad(dest, current_frame, state.gain.at(intermediate_mix_id));
 }
 
 void Source::Reset() {
@@ -232,7 +260,7 @@ void Source::ParseConfig(SourceConfiguration::Configuration& config,
 void Source::GenerateFrame() {
     current_frame.fill({});
 
-    if (state.current_buffer.empty() && !DequeueBuffer()) {
+    if (IsCurrentBufferConsumed() && !DequeueBuffer()) {
         state.enabled = false;
         state.buffer_update = true;
         state.current_buffer_id = 0;
@@ -243,24 +271,29 @@ void Source::GenerateFrame() {
 
     state.current_sample_number = state.next_sample_number;
     while (frame_position < current_frame.size()) {
-        if (state.current_buffer.empty() && !DequeueBuffer()) {
+        if (IsCurrentBufferConsumed() && !DequeueBuffer()) {
             break;
         }
 
+        const std::array<s16, 2>* input =
+            state.current_buffer.data() + state.current_buffer_position;
+        const std::size_t input_size = state.current_buffer.size() - state.current_buffer_position;
+
         switch (state.interpolation_mode) {
         case InterpolationMode::None:
-            AudioInterp::None(state.interp_state, state.current_buffer, state.rate_multiplier,
-                              current_frame, frame_position);
+            state.current_buffer_position +=
+                AudioInterp::None(state.interp_state, input, input_size, state.rate_multiplier,
+                                  current_frame, frame_position);
             break;
         case InterpolationMode::Linear:
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            state.current_buffer_position +=
+                AudioInterp::Linear(state.interp_state, input, input_size, state.rate_multiplier,
+                                    current_frame, frame_position);
             break;
         case InterpolationMode::Polyphase:
-            // TODO(merry): Implement polyphase interpolation
-            LOG_DEBUG(Audio_DSP, "Polyphase interpolation unimplemented; falling back to linear");
-            AudioInterp::Linear(state.interp_state, state.current_buffer, state.rate_multiplier,
-                                current_frame, frame_position);
+            state.current_buffer_position +=
+                AudioInterp::Polyphase(state.interp_state, input, input_size,
+                                       state.rate_multiplier, current_frame, frame_position);
             break;
         default:
             UNIMPLEMENTED();
@@ -273,7 +306,7 @@ void Source::GenerateFrame() {
 }
 
 bool Source::DequeueBuffer() {
-    ASSERT_MSG(state.current_buffer.empty(),
+    ASSERT_MSG(IsCurrentBufferConsumed(),
                "Shouldn't dequeue; we still have data in current_buffer");
 
     if (state.input_queue.empty())
@@ -290,22 +323,25 @@ bool Source::DequeueBuffer() {
     // This physical address masking occurs due to how the DSP DMA hardware is configured by the
     // firmware.
     const u8* const memory = memory_system->GetPhysicalPointer(buf.physical_address & 0xFFFFFFFC);
+    // The decoders refill current_buffer in place, so its storage is reused from buffer to buffer
+    state.current_buffer_position = 0;
     if (memory) {
         const unsigned num_channels = buf.mono_or_stereo == MonoOrStereo::Stereo ? 2 : 1;
         switch (buf.format) {
         case Format::PCM8:
-            state.current_buffer = Codec::DecodePCM8(num_channels, memory, buf.length);
+            Codec::DecodePCM8(num_channels, memory, buf.length, state.current_buffer);
             break;
         case Format::PCM16:
-            state.current_buffer = Codec::DecodePCM16(num_channels, memory, buf.length);
+            Codec::DecodePCM16(num_channels, memory, buf.length, state.current_buffer);
             break;
         case Format::ADPCM:
             DEBUG_ASSERT(num_channels == 1);
-            state.current_buffer =
-                Codec::DecodeADPCM(memory, buf.length, state.adpcm_coeffs, state.adpcm_state);
+            Codec::DecodeADPCM(memory, buf.length, state.adpcm_coeffs, state.adpcm_state,
+                               state.current_buffer);
             break;
         default:
             UNIMPLEMENTED();
+            state.current_buffer.clear();
             break;
         }
     } else {
@@ -332,6 +368,10 @@ bool Source::DequeueBuffer() {
     return true;
 }
 
+bool Source::IsCurrentBufferConsumed() const {
+    return state.current_buffer_position >= state.current_buffer.size();
+}
+
 SourceStatus::Status Source::GetCurrentStatus() {
     SourceStatus::Status ret;
 
@@ -20,6 +20,13 @@ class MemorySystem;
 
 namespace AudioCore::HLE {
 
+/**
+ * Mixes a stereo frame into a quadraphonic frame, scaling the four channels by their gains. This
+ * is how sources are mixed into the intermediate mixes.
+ */
+void MixStereoIntoQuad(QuadFrame32& dest, const StereoFrame16& source,
+                       const std::array<float, 4>& gains);
+
 /**
  * This module performs:
  * - Buffer management
@@ -115,7 +122,9 @@ private:
 
         u32 current_sample_number = 0;
         u32 next_sample_number = 0;
-        AudioInterp::StereoBuffer16 current_buffer;
+        StereoBuffer16 current_buffer;
+        /// Index of the first sample in current_buffer that hasn't been resampled yet
+        std::size_t current_buffer_position = 0;
 
         // buffer_id state
 
@@ -148,6 +157,8 @@ private:
     /// INTERNAL: Dequeues a buffer and does preprocessing on it (decoding, resampling). Puts it
     /// into current_buffer.
     bool DequeueBuffer();
+    /// INTERNAL: Returns true if every sample of current_buffer has been resampled.
+    bool IsCurrentBufferConsumed() const;
     /// INTERNAL: Generates a SourceStatus::Status based on our internal state.
     SourceStatus::Status GetCurrentStatus();
 };
@@ -3,6 +3,10 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cmath>
+#ifdef ARCHITECTURE_x86_64
+#include <emmintrin.h>
+#endif
 #include "audio_core/interpolate.h"
 #include "common/assert.h"
 
@@ -14,16 +18,34 @@ constexpr u64 scale_factor = 1 << 24;
 constexpr u64 scale_mask = scale_factor - 1;
 
 /// Here we step over the input in steps of rate, until we consume all of the input.
-/// Three adjacent samples are passed to fn each step.
-template <typename Function>
-static void StepOverSamples(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-                            std::size_t& outputi, Function fn) {
+/// A window of window_size adjacent samples is passed to fn each step. The historical samples in
+/// state precede the input, so windows that overlap them are assembled in a small local buffer
+/// instead of copying the history in front of the input.
+template <std::size_t window_size, typename Function>
+static std::size_t StepOverSamples(State& state, const std::array<s16, 2>* input,
+                                   std::size_t input_size, float rate, StereoFrame16& output,
+                                   std::size_t& outputi, Function fn) {
+    static_assert(window_size >= 2 && window_size - 1 <= history_size);
     ASSERT(rate > 0);
 
-    if (input.empty())
-        return;
-
-    input.insert(input.begin(), {state.xn2, state.xn1});
+    if (input_size == 0)
+        return 0;
+
+    // Index i refers to the sequence formed by the last lookbehind historical samples followed by
+    // the input. The window for position i covers samples i to i + lookbehind of that sequence.
+    constexpr std::size_t lookbehind = window_size - 1;
+    const auto history_sample = [&](std::size_t i) -> const std::array<s16, 2>& {
+        return i < history_size ? state.history[i] : input[i - history_size];
+    };
+
+    std::array<std::array<s16, 2>, window_size> window_buffer;
+    const auto window = [&](std::size_t i) -> const std::array<s16, 2>* {
+        if (i >= lookbehind)
+            return input + (i - lookbehind);
+        for (std::size_t j = 0; j < window_size; ++j)
+            window_buffer[j] = history_sample(history_size - lookbehind + i + j);
+        return window_buffer.data();
+    };
 
     const u64 step_size = static_cast<u64>(rate * scale_factor);
     u64 fposition = state.fposition;
@@ -32,45 +54,150 @@ static void StepOverSamples(State& state, StereoBuffer16& input, float rate, Ste
     while (outputi < output.size()) {
         inputi = static_cast<std::size_t>(fposition / scale_factor);
 
-        if (inputi + 2 >= input.size()) {
-            inputi = input.size() - 2;
+        if (inputi >= input_size) {
+            inputi = input_size;
             break;
         }
 
         u64 fraction = fposition & scale_mask;
-        output[outputi++] = fn(fraction, input[inputi], input[inputi + 1], input[inputi + 2]);
+        output[outputi++] = fn(fraction, window(inputi));
 
         fposition += step_size;
     }
 
-    state.xn2 = input[inputi];
-    state.xn1 = input[inputi + 1];
+    std::array<std::array<s16, 2>, history_size> new_history;
+    for (std::size_t j = 0; j < history_size; ++j)
+        new_history[j] = history_sample(inputi + j);
+    state.history = new_history;
     state.fposition = fposition - inputi * scale_factor;
 
-    input.erase(input.begin(), std::next(input.begin(), inputi + 2));
+    return inputi;
 }
 
-void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-          std::size_t& outputi) {
-    StepOverSamples(
-        state, input, rate, output, outputi,
-        [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) { return x0; });
+std::size_t None(State& state, const std::array<s16, 2>* input, std::size_t input_size,
+                 float rate, StereoFrame16& output, std::size_t& outputi) {
+    return StepOverSamples<3>(state, input, input_size, rate, output, outputi,
+                              [](u64 fraction, const std::array<s16, 2>* x) { return x[0]; });
 }
 
-void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-            std::size_t& outputi) {
+std::size_t Linear(State& state, const std::array<s16, 2>* input, std::size_t input_size,
+                   float rate, StereoFrame16& output, std::size_t& outputi) {
     // Note on accuracy: Some values that this produces are +/- 1 from the actual firmware.
-    StepOverSamples(state, input, rate, output, outputi,
-                    [](u64 fraction, const auto& x0, const auto& x1, const auto& x2) {
-                        // This is a saturated subtraction. (Verified by black-box fuzzing.)
-                        s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
-                        s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
-
-                        return std::array<s16, 2>{
-                            static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
-                            static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
-                        };
-                    });
+    return StepOverSamples<3>(state, input, input_size, rate, output, outputi,
+                              [](u64 fraction, const std::array<s16, 2>* x) {
+                                  const auto& x0 = x[0];
+                                  const auto& x1 = x[1];
+
+                                  // This is a saturated subtraction. (Verified by black-box
+                                  // fuzzing.)
+                                  s64 delta0 = std::clamp<s64>(x1[0] - x0[0], -32768, 32767);
+                                  s64 delta1 = std::clamp<s64>(x1[1] - x0[1], -32768, 32767);
+
+                                  return std::array<s16, 2>{
+                                      static_cast<s16>(x0[0] + fraction * delta0 / scale_factor),
+                                      static_cast<s16>(x0[1] + fraction * delta1 / scale_factor),
+                                  };
+                              });
+}
+
+namespace {
+
+constexpr std::size_t polyphase_taps = 8;
+constexpr std::size_t polyphase_phase_bits = 8;
+constexpr std::size_t polyphase_phases = 1 << polyphase_phase_bits;
+/// Filter coefficients are Q14 fixed point.
+constexpr int polyphase_coeff_bits = 14;
+
+struct PolyphaseTable {
+    /// One set of taps per phase. The extra phase covers fractions that round up to 1.0.
+    alignas(16) std::array<std::array<s16, polyphase_taps>, polyphase_phases + 1> coeffs;
+
+    PolyphaseTable() {
+        // Lanczos window (a = 4) applied to a sinc low-pass filter. Tap k sits at offset k - 3
+        // from the sample the fraction is measured from.
+        constexpr double a = polyphase_taps / 2;
+        constexpr double pi = 3.14159265358979323846;
+        const auto sinc = [pi](double x) { return x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x); };
+
+        for (std::size_t phase = 0; phase <= polyphase_phases; ++phase) {
+            const double fraction = static_cast<double>(phase) / polyphase_phases;
+
+            std::array<double, polyphase_taps> taps;
+            double sum = 0.0;
+            for (std::size_t k = 0; k < polyphase_taps; ++k) {
+                const double x = static_cast<double>(k) - (a - 1) - fraction;
+                taps[k] = std::abs(x) < a ? sinc(x) * sinc(x / a) : 0.0;
+                sum += taps[k];
+            }
+
+            // Normalise so that each phase has unity gain at DC, then fold the rounding error into
+            // the centre tap so a constant input passes through unchanged.
+            int total = 0;
+            for (std::size_t k = 0; k < polyphase_taps; ++k) {
+                coeffs[phase][k] =
+                    static_cast<s16>(std::lround(taps[k] / sum * (1 << polyphase_coeff_bits)));
+                total += coeffs[phase][k];
+            }
+            const std::size_t centre = fraction < 0.5 ? 3 : 4;
+            coeffs[phase][centre] += static_cast<s16>((1 << polyphase_coeff_bits) - total);
+        }
+    }
+};
+
+const PolyphaseTable& GetPolyphaseTable() {
+    static const PolyphaseTable table;
+    return table;
+}
+
+std::array<s16, 2> PolyphaseFilter(const std::array<s16, polyphase_taps>& c,
+                                   const std::array<s16, 2>* x) {
+    constexpr s32 rounding = 1 << (polyphase_coeff_bits - 1);
+#ifdef ARCHITECTURE_x86_64
+    // Reorder each pair of stereo samples to L0 L1 R0 R1 so that pmaddwd against the coefficient
+    // pairs c0 c1 c0 c1 accumulates each channel separately.
+    const __m128i coeffs = _mm_load_si128(reinterpret_cast<const __m128i*>(c.data()));
+    const __m128i c_lo = _mm_unpacklo_epi32(coeffs, coeffs);
+    const __m128i c_hi = _mm_unpackhi_epi32(coeffs, coeffs);
+
+    const auto deinterleave = [](__m128i v) {
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 1, 2, 0));
+        return _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 1, 2, 0));
+    };
+    const __m128i x_lo = deinterleave(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x)));
+    const __m128i x_hi = deinterleave(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 4)));
+
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(x_lo, c_lo), _mm_madd_epi16(x_hi, c_hi));
+    sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+    sum = _mm_add_epi32(sum, _mm_set1_epi32(rounding));
+    sum = _mm_srai_epi32(sum, polyphase_coeff_bits);
+    const s32 packed = _mm_cvtsi128_si32(_mm_packs_epi32(sum, sum));
+
+    return {static_cast<s16>(packed & 0xFFFF), static_cast<s16>(packed >> 16)};
+#else
+    std::array<s16, 2> result;
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+        s32 sum = rounding;
+        for (std::size_t k = 0; k < polyphase_taps; ++k)
+            sum += c[k] * x[k][channel];
+        result[channel] = static_cast<s16>(std::clamp(sum >> polyphase_coeff_bits, -32768, 32767));
+    }
+    return result;
+#endif
+}
+
+} // Anonymous namespace
+
+std::size_t Polyphase(State& state, const std::array<s16, 2>* input, std::size_t input_size,
+                      float rate, StereoFrame16& output, std::size_t& outputi) {
+    const PolyphaseTable& table = GetPolyphaseTable();
+    constexpr std::size_t phase_shift = 24 - polyphase_phase_bits;
+
+    return StepOverSamples<polyphase_taps>(
+        state, input, input_size, rate, output, outputi,
+        [&table](u64 fraction, const std::array<s16, 2>* x) {
+            const std::size_t phase = (fraction + (1 << (phase_shift - 1))) >> phase_shift;
+            return PolyphaseFilter(table.coeffs[phase], x);
+        });
 }
 
 } // namespace AudioCore::AudioInterp
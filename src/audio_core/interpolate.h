@@ -5,19 +5,18 @@
 #pragma once
 
 #include <array>
-#include <deque>
+#include <cstddef>
 #include "audio_core/audio_types.h"
 #include "common/common_types.h"
 
 namespace AudioCore::AudioInterp {
 
-/// A variable length buffer of signed PCM16 stereo samples.
-using StereoBuffer16 = std::deque<std::array<s16, 2>>;
+/// Number of historical samples kept between calls. The polyphase filter needs the most.
+constexpr std::size_t history_size = 7;
 
 struct State {
-    /// Two historical samples.
-    std::array<s16, 2> xn1 = {}; ///< x[n-1]
-    std::array<s16, 2> xn2 = {}; ///< x[n-2]
+    /// Historical samples, oldest first. history.back() is x[n-1].
+    std::array<std::array<s16, 2>, history_size> history = {};
     /// Current fractional position.
     u64 fposition = 0;
 };
@@ -25,25 +24,44 @@ struct State {
 /**
  * No interpolation. This is equivalent to a zero-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
- * @param input Input buffer.
+ * @param input Input samples.
+ * @param input_size Number of samples available at input.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
  * @param outputi The index of output to start writing to.
+ * @return The number of input samples consumed.
  */
-void None(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-          std::size_t& outputi);
+std::size_t None(State& state, const std::array<s16, 2>* input, std::size_t input_size,
+                 float rate, StereoFrame16& output, std::size_t& outputi);
 
 /**
  * Linear interpolation. This is equivalent to a first-order hold. There is a two-sample predelay.
  * @param state Interpolation state.
- * @param input Input buffer.
+ * @param input Input samples.
+ * @param input_size Number of samples available at input.
  * @param rate Stretch factor. Must be a positive non-zero value.
  *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
  * @param output The resampled audio buffer.
  * @param outputi The index of output to start writing to.
+ * @return The number of input samples consumed.
  */
-void Linear(State& state, StereoBuffer16& input, float rate, StereoFrame16& output,
-            std::size_t& outputi);
+std::size_t Linear(State& state, const std::array<s16, 2>* input, std::size_t input_size,
+                   float rate, StereoFrame16& output, std::size_t& outputi);
+
+/**
+ * Polyphase interpolation using an 8-tap windowed-sinc filter with precomputed coefficients.
+ * There is a four-sample predelay.
+ * @param state Interpolation state.
+ * @param input Input samples.
+ * @param input_size Number of samples available at input.
+ * @param rate Stretch factor. Must be a positive non-zero value.
+ *             rate > 1.0 performs decimation and rate < 1.0 performs upsampling.
+ * @param output The resampled audio buffer.
+ * @param outputi The index of output to start writing to.
+ * @return The number of input samples consumed.
+ */
+std::size_t Polyphase(State& state, const std::array<s16, 2>* input, std::size_t input_size,
+                      float rate, StereoFrame16& output, std::size_t& outputi);
 
 } // namespace AudioCore::AudioInterp
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <functional>
 #include "common/common_types.h"
 
@@ -30,6 +32,23 @@ public:
      * @param sample_count Number of samples.
      */
     virtual void SetCallback(std::function<void(s16*, std::size_t)> cb) = 0;
+
+    /**
+     * Whether this sink runs on emulated time rather than wall-clock time. Such sinks are not
+     * driven by the callback; the DSP hands each frame to PushSamples as soon as it is produced.
+     */
+    virtual bool IsEmulatedTime() const {
+        return false;
+    }
+
+    /**
+     * Receives samples directly from the DSP. Only called for sinks that run on emulated time.
+     * @param samples Samples in interleaved stereo PCM16 format.
+     * @param sample_count Number of samples.
+     * @param generation_time Host time the DSP spent producing these samples, or zero if unknown.
+     */
+    virtual void PushSamples(const s16* samples, std::size_t sample_count,
+                             std::chrono::nanoseconds generation_time) {}
 };
 
 } // namespace AudioCore
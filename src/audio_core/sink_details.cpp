@@ -8,6 +8,7 @@
 #include <vector>
 #include "audio_core/null_sink.h"
 #include "audio_core/sink_details.h"
+#include "audio_core/wave_sink.h"
 #ifdef HAVE_SDL2
 #include "audio_core/sdl2_sink.h"
 #endif
@@ -51,6 +52,11 @@ constexpr SinkDetails sink_details[] = {
                     return std::make_unique<NullSink>(device_id);
                 },
                 [] { return std::vector<std::string>{"null"}; }},
+    SinkDetails{"wav",
+                [](std::string_view device_id) -> std::unique_ptr<Sink> {
+                    return std::make_unique<WaveSink>(device_id);
+                },
+                [] { return std::vector<std::string>{default_wave_sink_path}; }},
 };
 
 const SinkDetails& GetSinkDetails(std::string_view sink_id) {
@@ -0,0 +1,108 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <fmt/format.h>
+#include "audio_core/audio_types.h"
+#include "audio_core/wave_sink.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+
+namespace AudioCore {
+
+namespace {
+struct WaveHeader {
+    std::array<char, 4> riff_id;
+    u32_le riff_size;
+    std::array<char, 4> wave_id;
+
+    std::array<char, 4> fmt_id;
+    u32_le fmt_size;
+    u16_le format;
+    u16_le num_channels;
+    u32_le sample_rate;
+    u32_le byte_rate;
+    u16_le block_align;
+    u16_le bits_per_sample;
+
+    std::array<char, 4> data_id;
+    u32_le data_size;
+};
+static_assert(sizeof(WaveHeader) == 44, "WaveHeader has incorrect size");
+
+constexpr u16 wave_format_pcm = 1;
+constexpr u16 bytes_per_sample = 2 * sizeof(s16);
+} // Anonymous namespace
+
+WaveSink::WaveSink(std::string_view path_) {
+    const std::string path{path_.empty() || path_ == auto_device_name ? default_wave_sink_path
+                                                                       : path_};
+
+    if (!file.Open(path, "wb")) {
+        LOG_ERROR(Audio_Sink, "Could not open {} for writing", path);
+        return;
+    }
+    // Written again with the final sizes on destruction.
+    WriteHeader();
+
+    if (timing_file.Open(path + ".timing.csv", "wb")) {
+        timing_file.WriteString("frame,samples,dsp_ns\n");
+    }
+}
+
+WaveSink::~WaveSink() {
+    if (!file.IsOpen())
+        return;
+
+    file.Seek(0, SEEK_SET);
+    WriteHeader();
+}
+
+unsigned int WaveSink::GetNativeSampleRate() const {
+    return native_sample_rate;
+}
+
+void WaveSink::PushSamples(const s16* samples, std::size_t count,
+                           std::chrono::nanoseconds generation_time) {
+    if (!file.IsOpen())
+        return;
+
+    file.WriteArray(samples, 2 * count);
+    samples_written += count;
+
+    // Samples output one at a time (e.g. by DSP LLE) carry no timing information.
+    if (timing_file.IsOpen() && generation_time.count() != 0) {
+        timing_file.WriteString(
+            fmt::format("{},{},{}\n", frame_count, count, generation_time.count()));
+        frame_count++;
+    }
+}
+
+void WaveSink::WriteHeader() {
+    // The RIFF size fields are 32 bits wide. Longer recordings are written in full, but their
+    // header is clamped and most tools will stop reading at that point.
+    const u64 data_size = std::min<u64>(samples_written * bytes_per_sample,
+                                        std::numeric_limits<u32>::max() - sizeof(WaveHeader));
+
+    WaveHeader header{};
+    header.riff_id = {'R', 'I', 'F', 'F'};
+    header.riff_size = static_cast<u32>(sizeof(WaveHeader) - 8 + data_size);
+    header.wave_id = {'W', 'A', 'V', 'E'};
+    header.fmt_id = {'f', 'm', 't', ' '};
+    header.fmt_size = 16;
+    header.format = wave_format_pcm;
+    header.num_channels = 2;
+    header.sample_rate = native_sample_rate;
+    header.byte_rate = native_sample_rate * bytes_per_sample;
+    header.block_align = bytes_per_sample;
+    header.bits_per_sample = 16;
+    header.data_id = {'d', 'a', 't', 'a'};
+    header.data_size = static_cast<u32>(data_size);
+
+    file.WriteObject(header);
+}
+
+} // namespace AudioCore
@@ -0,0 +1,50 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "audio_core/sink.h"
+#include "common/file_util.h"
+
+namespace AudioCore {
+
+/// Default output path of WaveSink, also listed as its only device.
+constexpr char default_wave_sink_path[] = "citra_audio.wav";
+
+/**
+ * Writes audio output to a WAV file instead of a host audio device. This sink runs on emulated
+ * time, so its output does not depend on host timing and it never throttles emulation.
+ *
+ * The time the DSP spent producing each frame is written alongside, to "<path>.timing.csv".
+ */
+class WaveSink final : public Sink {
+public:
+    /// @param path Path of the WAV file to write, or "auto" for the default
+    explicit WaveSink(std::string_view path);
+    ~WaveSink() override;
+
+    unsigned int GetNativeSampleRate() const override;
+
+    void SetCallback(std::function<void(s16*, std::size_t)> cb) override {}
+
+    bool IsEmulatedTime() const override {
+        return true;
+    }
+
+    void PushSamples(const s16* samples, std::size_t sample_count,
+                     std::chrono::nanoseconds generation_time) override;
+
+private:
+    void WriteHeader();
+
+    FileUtil::IOFile file;
+    FileUtil::IOFile timing_file;
+    u64 frame_count = 0;
+    u64 samples_written = 0;
+};
+
+} // namespace AudioCore
@@ -0,0 +1,51 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#if defined(HAVE_MF) || defined(HAVE_FFMPEG)
+
+#include <cstring>
+#include <memory>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/decoder.h"
+#ifdef HAVE_MF
+#include "audio_core/hle/wmf_decoder.h"
+#elif HAVE_FFMPEG
+#include "audio_core/hle/ffmpeg_decoder.h"
+#endif
+#include "core/memory.h"
+#include "tests/audio_core/audio_fixures.h"
+
+namespace AudioCore::HLE {
+
+TEST_CASE("DSP HLE audio decoder", "[audio_core][hle]") {
+    Memory::MemorySystem memory;
+    auto decoder =
+#ifdef HAVE_MF
+        std::make_unique<WMFDecoder>(memory);
+#elif HAVE_FFMPEG
+        std::make_unique<FFMPEGDecoder>(memory);
+#endif
+    BinaryRequest request;
+    request.codec = DecoderCodec::AAC;
+    request.cmd = DecoderCommand::Init;
+    decoder->ProcessRequest(request);
+
+    std::memcpy(memory.GetFCRAMPointer(0), fixure_buffer, fixure_buffer_size);
+    request.cmd = DecoderCommand::Decode;
+    request.src_addr = Memory::FCRAM_PADDR;
+    request.dst_addr_ch0 = Memory::FCRAM_PADDR + 1024;
+    request.dst_addr_ch1 = Memory::FCRAM_PADDR + 1048576; // 1 MB
+    request.size = fixure_buffer_size;
+    REQUIRE(decoder->ProcessRequest(request).has_value());
+
+    // The same frame is submitted repeatedly, as when a game loops a stretch of BGM. With FFmpeg,
+    // every decode after the first two is served from the decoded PCM cache.
+    BENCHMARK("Decode a looping AAC frame") {
+        return decoder->ProcessRequest(request).has_value();
+    };
+}
+
+} // namespace AudioCore::HLE
+
+#endif
@@ -0,0 +1,88 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/mixers.h"
+#include "audio_core/hle/shared_memory.h"
+#include "audio_core/hle/source.h"
+#include "core/memory.h"
+
+namespace AudioCore::HLE {
+
+using Configuration = SourceConfiguration::Configuration;
+
+/// Length of the looping buffer of every source, in samples
+constexpr u32 BUFFER_LENGTH = 4096;
+constexpr u32 BUFFER_SIZE = BUFFER_LENGTH * 2 * sizeof(s16);
+
+TEST_CASE("DSP HLE frame", "[audio_core][hle]") {
+    Memory::MemorySystem memory;
+    std::mt19937 rng(0xA0D);
+    std::generate_n(memory.GetFCRAMPointer(0), BUFFER_SIZE * num_sources,
+                    [&rng] { return rng() & 0xFF; });
+
+    // Every source plays a looping stereo PCM16 buffer that has to be resampled, which is what
+    // GenerateCurrentFrame does in a busy scene.
+    auto configs = std::make_unique<SourceConfiguration>();
+    std::memset(configs.get(), 0, sizeof(SourceConfiguration));
+    std::vector<std::unique_ptr<Source>> sources;
+    for (std::size_t i = 0; i < num_sources; ++i) {
+        auto& config = configs->config[i];
+        config.enable_dirty.Assign(1);
+        config.enable = 1;
+        config.interpolation_dirty.Assign(1);
+        config.interpolation_mode = i % 2 == 0 ? Configuration::InterpolationMode::Linear
+                                               : Configuration::InterpolationMode::Polyphase;
+        config.rate_multiplier_dirty.Assign(1);
+        config.rate_multiplier = 0.75f + 0.02f * i;
+        config.gain_0_dirty.Assign(1);
+        config.gain[0][0] = 1.0f;
+        config.gain[0][1] = 1.0f;
+        config.embedded_buffer_dirty.Assign(1);
+        config.physical_address = static_cast<u32>(Memory::FCRAM_PADDR + BUFFER_SIZE * i);
+        config.length = BUFFER_LENGTH;
+        config.mono_or_stereo.Assign(Configuration::MonoOrStereo::Stereo);
+        config.format.Assign(Configuration::Format::PCM16);
+        config.is_looping.Assign(1);
+        config.buffer_id = static_cast<u16>(i + 1);
+
+        sources.push_back(std::make_unique<Source>(i));
+        sources.back()->SetMemory(memory);
+    }
+
+    auto adpcm_coefficients = std::make_unique<AdpcmCoefficients>();
+    std::memset(adpcm_coefficients.get(), 0, sizeof(AdpcmCoefficients));
+
+    auto dsp_config = std::make_unique<DspConfiguration>();
+    std::memset(dsp_config.get(), 0, sizeof(DspConfiguration));
+    dsp_config->volume_0_dirty.Assign(1);
+    dsp_config->output_format_dirty.Assign(1);
+    dsp_config->volume[0] = 1.0f;
+    dsp_config->output_format = DspConfiguration::OutputFormat::Stereo;
+
+    auto read_samples = std::make_unique<IntermediateMixSamples>();
+    auto write_samples = std::make_unique<IntermediateMixSamples>();
+    std::memset(read_samples.get(), 0, sizeof(IntermediateMixSamples));
+    Mixers mixers;
+
+    BENCHMARK("Audio frame with all sources playing") {
+        std::array<QuadFrame32, 3> intermediate_mixes{};
+        for (std::size_t i = 0; i < num_sources; ++i) {
+            sources[i]->Tick(configs->config[i], adpcm_coefficients->coeff[i]);
+            for (std::size_t mix = 0; mix < 3; ++mix) {
+                sources[i]->MixInto(intermediate_mixes[mix], mix);
+            }
+        }
+        mixers.Tick(*dsp_config, *read_samples, *write_samples, intermediate_mixes);
+        return mixers.GetOutput()[0][0];
+    };
+}
+
+} // namespace AudioCore::HLE
@@ -0,0 +1,59 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/interpolate.h"
+
+namespace AudioCore::AudioInterp {
+
+using InterpFunction = std::size_t (*)(State&, const std::array<s16, 2>*, std::size_t, float,
+                                       StereoFrame16&, std::size_t&);
+
+/// Resamples input into one frame, wrapping around at its end like a looping buffer.
+static void ResampleFrame(InterpFunction fn, State& state,
+                          const std::vector<std::array<s16, 2>>& input, std::size_t& position,
+                          float rate, StereoFrame16& frame) {
+    std::size_t outputi = 0;
+    while (outputi < frame.size()) {
+        position += fn(state, input.data() + position, input.size() - position, rate, frame,
+                       outputi);
+        if (position == input.size()) {
+            position = 0;
+        }
+    }
+}
+
+TEST_CASE("Interpolation", "[audio_core]") {
+    std::mt19937 rng(0x1E7);
+    std::vector<std::array<s16, 2>> input(4096);
+    for (auto& sample : input) {
+        sample = {static_cast<s16>(rng()), static_cast<s16>(rng())};
+    }
+
+    // Rates below and above 1, as games pitch sounds both ways
+    for (const float rate : {0.75f, 1.3f}) {
+        State state;
+        std::size_t position = 0;
+        StereoFrame16 frame{};
+        const auto rate_name = rate < 1.0f ? " (upsampling)" : " (decimation)";
+
+        BENCHMARK(std::string("None") + rate_name) {
+            ResampleFrame(None, state, input, position, rate, frame);
+            return frame[0][0];
+        };
+        BENCHMARK(std::string("Linear") + rate_name) {
+            ResampleFrame(Linear, state, input, position, rate, frame);
+            return frame[0][0];
+        };
+        BENCHMARK(std::string("Polyphase") + rate_name) {
+            ResampleFrame(Polyphase, state, input, position, rate, frame);
+            return frame[0][0];
+        };
+    }
+}
+
+} // namespace AudioCore::AudioInterp
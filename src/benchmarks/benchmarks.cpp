@@ -0,0 +1,10 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+// Catch provides the main function since we've given it the CATCH_CONFIG_MAIN preprocessor
+// directive. Run with --benchmark-samples to trade accuracy for time, or with a tag such as
+// [video_core] to only run some of the benchmarks.
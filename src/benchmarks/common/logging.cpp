@@ -0,0 +1,56 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+
+namespace Log {
+
+namespace {
+/// Backend that drops every message, to measure the cost of the logging front end.
+class NullBackend : public Backend {
+public:
+    const char* GetName() const override {
+        return "null";
+    }
+    void Write(const Entry&) override {}
+};
+} // Anonymous namespace
+
+TEST_CASE("Logging", "[common]") {
+    const std::string path = "./binary_log_benchmark.bin";
+    SetGlobalFilter(Filter(Level::Trace));
+    AddBackend(std::make_unique<NullBackend>());
+
+    int i = 0;
+    BENCHMARK("Text log message") {
+        LOG_DEBUG(Service, "Request {:08X} from {} took {} us", i++, "benchmark", 1.5);
+    };
+
+    REQUIRE(StartBinaryLog(path));
+    const int first_binary = i;
+    BENCHMARK("Binary log message") {
+        LOG_DEBUG(Service, "Request {:08X} from {} took {} us", i++, "benchmark", 1.5);
+    };
+    StopBinaryLog();
+
+    // Full staging buffers wait for the writer, so no message is dropped
+    int logged = 0;
+    REQUIRE(ReadBinaryLog(path, [&logged](const Entry& entry) {
+        logged += entry.log_class == Class::Service ? 1 : 0;
+    }));
+    FileUtil::Delete(path);
+    REQUIRE(logged == i - first_binary);
+
+    RemoveBackend("null");
+    SetGlobalFilter(Filter(Level::Info));
+}
+
+} // namespace Log
@@ -0,0 +1,60 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/core_timing.h"
+
+constexpr int NUM_EVENTS = 64;
+
+TEST_CASE("Timing", "[core]") {
+    Core::Timing timing;
+
+    u64 fired = 0;
+    Core::TimingEventType* event =
+        timing.RegisterEvent("benchmark", [&fired](u64, int) { ++fired; });
+
+    BENCHMARK("ScheduleEvent and Advance") {
+        // Schedules events out of order so that the queue has to be reordered, then runs the
+        // slices until all of them were fired.
+        const u64 target = fired + NUM_EVENTS;
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            timing.ScheduleEvent(((i * 37) % NUM_EVENTS + 1) * 1000, event, i);
+        }
+        while (fired < target) {
+            timing.AddTicks(timing.GetDowncount());
+            timing.Advance();
+        }
+        return fired;
+    };
+
+    BENCHMARK("UnscheduleEvent") {
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            timing.ScheduleEvent(1000 + i, event, i);
+        }
+        for (int i = 0; i < NUM_EVENTS; ++i) {
+            timing.UnscheduleEvent(event, i);
+        }
+    };
+
+    // Like the periodic events of the emulated hardware, which reschedule themselves
+    u64 periodic_fired = 0;
+    Core::TimingEventType* periodic_event = nullptr;
+    periodic_event = timing.RegisterEvent(
+        "benchmark_periodic", [&timing, &periodic_fired, &periodic_event](u64, int cycles_late) {
+            ++periodic_fired;
+            timing.ScheduleEvent(500 - cycles_late, periodic_event);
+        });
+    timing.ScheduleEvent(500, periodic_event);
+
+    BENCHMARK("Periodic event") {
+        const u64 target = periodic_fired + NUM_EVENTS;
+        while (periodic_fired < target) {
+            timing.AddTicks(timing.GetDowncount());
+            timing.Advance();
+        }
+        return periodic_fired;
+    };
+
+    timing.UnscheduleEvent(periodic_event, 0);
+}
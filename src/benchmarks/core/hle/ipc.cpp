@@ -0,0 +1,74 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/core_timing.h"
+#include "core/hle/ipc.h"
+#include "core/hle/kernel/event.h"
+#include "core/hle/kernel/handle_table.h"
+#include "core/hle/kernel/hle_ipc.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/server_session.h"
+#include "core/hle/result.h"
+#include "core/memory.h"
+
+namespace Kernel {
+
+TEST_CASE("HLERequestContext", "[core][kernel]") {
+    Core::Timing timing;
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    auto [server, client] = kernel.CreateSessionPair();
+    HLERequestContext context(kernel, std::move(server), nullptr);
+
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    auto event = kernel.CreateEvent(ResetType::OneShot);
+    const Handle event_handle = process->handle_table.Create(event).Unwrap();
+
+    BENCHMARK("Round-trip with regular params") {
+        const u32_le request[]{
+            IPC::MakeHeader(0x1234, 3, 0),
+            0x12345678,
+            0x21122112,
+            0xAABBCCDD,
+        };
+        context.PopulateFromIncomingCommandBuffer(request, *process);
+
+        u32* cmd_buf = context.CommandBuffer();
+        cmd_buf[0] = IPC::MakeHeader(0x1234, 2, 0);
+        cmd_buf[1] = RESULT_SUCCESS.raw;
+        cmd_buf[2] = cmd_buf[2] ^ cmd_buf[3];
+
+        u32_le reply[IPC::COMMAND_BUFFER_LENGTH];
+        context.WriteToOutgoingCommandBuffer(reply, *process);
+        return reply[2];
+    };
+
+    BENCHMARK("Round-trip with handles") {
+        // Sends a handle to the service and gets a copy of it back, as e.g. event getters do
+        const u32_le request[]{
+            IPC::MakeHeader(0x1234, 0, 2),
+            IPC::CopyHandleDesc(1),
+            event_handle,
+        };
+        context.PopulateFromIncomingCommandBuffer(request, *process);
+        auto object = context.GetIncomingHandle(context.CommandBuffer()[2]);
+        context.ClearIncomingObjects();
+
+        u32* cmd_buf = context.CommandBuffer();
+        cmd_buf[0] = IPC::MakeHeader(0x1234, 1, 2);
+        cmd_buf[1] = RESULT_SUCCESS.raw;
+        cmd_buf[2] = IPC::CopyHandleDesc(1);
+        cmd_buf[3] = context.AddOutgoingHandle(std::move(object));
+
+        u32_le reply[IPC::COMMAND_BUFFER_LENGTH];
+        context.WriteToOutgoingCommandBuffer(reply, *process);
+        process->handle_table.Close(reply[3]);
+        context.ClearIncomingObjects();
+        return reply[3];
+    };
+}
+
+} // namespace Kernel
@@ -0,0 +1,67 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <catch2/catch.hpp>
+#include "core/core_timing.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/service/y2r_u.h"
+#include "core/hw/y2r.h"
+#include "core/memory.h"
+
+using namespace Service::Y2R;
+
+// A frame of the top screen, the usual size of the videos decoded by games
+constexpr u16 WIDTH = 400;
+constexpr u16 HEIGHT = 240;
+constexpr u32 BUFFER_SIZE = 0x100000;
+
+TEST_CASE("Y2R", "[core][hw]") {
+    Core::Timing timing;
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    process->vm_manager
+        .MapBackingMemory(Memory::HEAP_VADDR, memory.GetFCRAMPointer(0), BUFFER_SIZE,
+                          Kernel::MemoryState::Private)
+        .Unwrap();
+    memory.SetCurrentPageTable(&process->vm_manager.page_table);
+
+    std::mt19937 rng(0x2B2);
+    std::generate_n(memory.GetFCRAMPointer(0), BUFFER_SIZE / 2, [&rng] { return rng() & 0xFF; });
+
+    // Planes of the YUV422 input, followed by the output. Every transfer moves one row of tiles.
+    ConversionConfiguration config{};
+    config.input_format = InputFormat::YUV422_Indiv8;
+    config.output_format = OutputFormat::RGBA8;
+    config.rotation = Rotation::None;
+    config.alpha = 0xFF;
+    REQUIRE(config.SetInputLineWidth(WIDTH).IsSuccess());
+    REQUIRE(config.SetInputLines(HEIGHT).IsSuccess());
+    REQUIRE(config.SetStandardCoefficient(StandardCoefficient::ITU_Rec601).IsSuccess());
+    VAddr address = Memory::HEAP_VADDR;
+    const auto set_buffer = [&address](ConversionBuffer& buffer, u32 size, u16 transfer_unit) {
+        buffer = {address, size, transfer_unit, 0};
+        address += size;
+    };
+    set_buffer(config.src_Y, WIDTH * HEIGHT, WIDTH * 8);
+    set_buffer(config.src_U, WIDTH * HEIGHT / 2, WIDTH * 4);
+    set_buffer(config.src_V, WIDTH * HEIGHT / 2, WIDTH * 4);
+    set_buffer(config.dst, WIDTH * HEIGHT * 4, WIDTH * 8 * 4);
+
+    for (const auto block_alignment : {BlockAlignment::Linear, BlockAlignment::Block8x8}) {
+        config.block_alignment = block_alignment;
+        const char* name = block_alignment == BlockAlignment::Linear
+                               ? "PerformConversion YUV422 to RGBA8, linear"
+                               : "PerformConversion YUV422 to RGBA8, 8x8 blocks";
+        BENCHMARK(name) {
+            // The conversion advances the buffers, so every run starts from a copy
+            ConversionConfiguration cvt = config;
+            HW::Y2R::PerformConversion(memory, cvt);
+            return cvt.dst.address;
+        };
+    }
+}
@@ -0,0 +1,66 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <catch2/catch.hpp>
+#include "core/core_timing.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+constexpr u32 HEAP_SIZE = 0x100000;
+
+TEST_CASE("MemorySystem", "[core][memory]") {
+    Core::Timing timing;
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    auto process = kernel.CreateProcess(kernel.CreateCodeSet("", 0));
+    process->vm_manager
+        .MapBackingMemory(Memory::HEAP_VADDR, memory.GetFCRAMPointer(0), HEAP_SIZE,
+                          Kernel::MemoryState::Private)
+        .Unwrap();
+    memory.SetCurrentPageTable(&process->vm_manager.page_table);
+
+    BENCHMARK("Read8") {
+        u32 sum = 0;
+        for (VAddr addr = Memory::HEAP_VADDR; addr < Memory::HEAP_VADDR + 0x1000; ++addr) {
+            sum += memory.Read8(addr);
+        }
+        return sum;
+    };
+
+    BENCHMARK("Read32") {
+        u32 sum = 0;
+        for (VAddr addr = Memory::HEAP_VADDR; addr < Memory::HEAP_VADDR + 0x4000; addr += 4) {
+            sum += memory.Read32(addr);
+        }
+        return sum;
+    };
+
+    BENCHMARK("Read32 across pages") {
+        // Touches every page of the heap, as a game walking a large data structure would
+        u32 sum = 0;
+        for (VAddr addr = Memory::HEAP_VADDR; addr < Memory::HEAP_VADDR + HEAP_SIZE;
+             addr += Memory::PAGE_SIZE + 4) {
+            sum += memory.Read32(addr);
+        }
+        return sum;
+    };
+
+    BENCHMARK("Write32") {
+        for (VAddr addr = Memory::HEAP_VADDR; addr < Memory::HEAP_VADDR + 0x4000; addr += 4) {
+            memory.Write32(addr, addr);
+        }
+    };
+
+    std::array<u8, 0x4000> buffer{};
+    BENCHMARK("ReadBlock") {
+        memory.ReadBlock(*process, Memory::HEAP_VADDR + 0x10, buffer.data(), buffer.size());
+        return buffer[0];
+    };
+
+    BENCHMARK("WriteBlock") {
+        memory.WriteBlock(*process, Memory::HEAP_VADDR + 0x10, buffer.data(), buffer.size());
+    };
+}
@@ -0,0 +1,77 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/verify_user.h"
+
+namespace Network {
+
+TEST_CASE("Room", "[network]") {
+    constexpr u16 port = 24873;
+    constexpr int num_members = 4;
+    constexpr int frames_per_member = 100;
+
+    REQUIRE(Network::Init());
+    Room room;
+    REQUIRE(room.Create("Benchmark", "", "", port, "", num_members, "", "", 0,
+                        std::make_unique<VerifyUser::NullBackend>()));
+
+    std::atomic<int> received{0};
+    std::vector<std::unique_ptr<RoomMember>> members;
+    for (int i = 0; i < num_members; ++i) {
+        auto member = std::make_unique<RoomMember>();
+        member->BindOnWifiPacketReceived([&received](const WifiPacket&) { ++received; });
+        member->Join("Bench-" + std::to_string(i), "bench-" + std::to_string(i), "127.0.0.1",
+                     port);
+        members.push_back(std::move(member));
+    }
+    for (const auto& member : members) {
+        for (int i = 0; i < 500 && !member->IsConnected(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(member->IsConnected());
+    }
+
+    WifiPacket packet{};
+    packet.type = WifiPacket::PacketType::Data;
+    packet.data.resize(128);
+    packet.destination_address = BroadcastMac;
+
+    // Every broadcast frame is relayed to all other members
+    const int expected = num_members * frames_per_member * (num_members - 1);
+    bool all_received = true;
+    BENCHMARK("Relay 100 broadcast WiFi frames per member") {
+        received = 0;
+        for (int i = 0; i < frames_per_member; ++i) {
+            for (const auto& member : members) {
+                packet.transmitter_address = member->GetMacAddress();
+                member->SendWifiPacket(packet);
+            }
+        }
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (received < expected && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        all_received &= received == expected;
+    };
+    REQUIRE(all_received);
+
+    for (const auto& member : members) {
+        member->Leave();
+    }
+    members.clear();
+    room.Destroy();
+    Network::Shutdown();
+}
+
+} // namespace Network
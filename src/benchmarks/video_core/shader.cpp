@@ -0,0 +1,111 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <random>
+#include <catch2/catch.hpp>
+#include <nihstro/inline_assembly.h>
+#include "video_core/pica_types.h"
+#include "video_core/shader/shader.h"
+#include "video_core/shader/shader_interpreter.h"
+#ifdef ARCHITECTURE_x86_64
+#include "video_core/shader/shader_jit_x64.h"
+#endif
+
+using float24 = Pica::float24;
+using Pica::Shader::ShaderEngine;
+using Pica::Shader::ShaderSetup;
+using Pica::Shader::UnitState;
+
+using DestRegister = nihstro::DestRegister;
+using OpCode = nihstro::OpCode;
+using SourceRegister = nihstro::SourceRegister;
+
+constexpr std::size_t NUM_VERTICES = 64;
+
+/// A vertex shader in the style of games: a matrix transform followed by some per-vertex math.
+static std::unique_ptr<ShaderSetup> MakeShaderSetup() {
+    const auto v = [](int index) { return SourceRegister::MakeInput(index); };
+    const auto c = [](int index) { return SourceRegister::MakeFloat(index); };
+    const auto r = [](int index) { return SourceRegister::MakeTemporary(index); };
+    const auto dest_r = [](int index) { return DestRegister::MakeTemporary(index); };
+    const auto dest_o = [](int index) { return DestRegister::MakeOutput(index); };
+
+    const auto shbin = nihstro::InlineAsm::CompileToRawBinary({
+        // clang-format off
+        {OpCode::Id::DP4, dest_r(0), v(0), c(0)},
+        {OpCode::Id::DP4, dest_r(1), v(0), c(1)},
+        {OpCode::Id::DP4, dest_r(2), v(0), c(2)},
+        {OpCode::Id::DP4, dest_r(3), v(0), c(3)},
+        {OpCode::Id::MUL, dest_r(4), r(0), c(4)},
+        {OpCode::Id::ADD, dest_r(4), r(4), r(1)},
+        {OpCode::Id::ADD, dest_o(0), r(4), r(2)},
+        {OpCode::Id::DP3, dest_r(5), v(1), c(5)},
+        {OpCode::Id::MAX, dest_r(5), r(5), c(6)},
+        {OpCode::Id::MIN, dest_o(1), r(5), c(7)},
+        {OpCode::Id::RCP, dest_r(6), r(3)},
+        {OpCode::Id::MUL, dest_o(2), v(2), r(6)},
+        {OpCode::Id::MOV, dest_o(3), v(1)},
+        {OpCode::Id::END},
+        // clang-format on
+    });
+
+    auto setup = std::make_unique<ShaderSetup>();
+    std::transform(shbin.program.begin(), shbin.program.end(), setup->program_code.begin(),
+                   [](const auto& x) { return x.hex; });
+    std::transform(shbin.swizzle_table.begin(), shbin.swizzle_table.end(),
+                   setup->swizzle_data.begin(), [](const auto& x) { return x.hex; });
+
+    std::mt19937 rng(0x5AD);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    for (auto& uniform : setup->uniforms.f) {
+        for (std::size_t i = 0; i < 4; ++i) {
+            uniform[i] = float24::FromFloat32(distribution(rng));
+        }
+    }
+    return setup;
+}
+
+static std::array<UnitState, NUM_VERTICES> MakeInputs() {
+    std::mt19937 rng(0x5AE);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    std::array<UnitState, NUM_VERTICES> states;
+    for (auto& state : states) {
+        for (auto& input : state.registers.input) {
+            for (std::size_t i = 0; i < 4; ++i) {
+                input[i] = float24::FromFloat32(distribution(rng));
+            }
+        }
+    }
+    return states;
+}
+
+static float24 RunVertices(const ShaderEngine& engine, const ShaderSetup& setup,
+                           std::array<UnitState, NUM_VERTICES>& states) {
+    for (auto& state : states) {
+        engine.Run(setup, state);
+    }
+    return states[0].registers.output[0].x;
+}
+
+TEST_CASE("Shader engines", "[video_core][shader]") {
+    auto setup = MakeShaderSetup();
+    auto states = MakeInputs();
+
+    Pica::Shader::InterpreterEngine interpreter;
+    interpreter.SetupBatch(*setup, 0);
+    BENCHMARK("InterpreterEngine::Run") {
+        return RunVertices(interpreter, *setup, states);
+    };
+
+#ifdef ARCHITECTURE_x86_64
+    Pica::Shader::JitX64Engine jit;
+    jit.SetupBatch(*setup, 0);
+    BENCHMARK("JitX64Engine::Run") {
+        return RunVertices(jit, *setup, states);
+    };
+#endif
+}
@@ -0,0 +1,109 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/memory.h"
+#include "video_core/pica_state.h"
+#include "video_core/pica_types.h"
+#include "video_core/regs.h"
+#include "video_core/shader/shader.h"
+#include "video_core/swrasterizer/clipper.h"
+#include "video_core/video_core.h"
+
+using Pica::float24;
+using Pica::Shader::OutputVertex;
+
+constexpr u32 FRAMEBUFFER_SIZE = 256;
+
+/// Converts a positive float to the raw float24 format of the viewport registers.
+static u32 ToFloat24Raw(float value) {
+    u32 hex;
+    std::memcpy(&hex, &value, sizeof(hex));
+    const u32 exponent = ((hex >> 23) & 0xFF) - 127 + 63;
+    return (exponent << 16) | ((hex >> 7) & 0xFFFF);
+}
+
+static OutputVertex MakeVertex(float x, float y, float r, float g, float b) {
+    OutputVertex vertex{};
+    vertex.pos = {float24::FromFloat32(x), float24::FromFloat32(y), float24::FromFloat32(-0.5f),
+                  float24::FromFloat32(1.0f)};
+    vertex.color = {float24::FromFloat32(r), float24::FromFloat32(g), float24::FromFloat32(b),
+                    float24::FromFloat32(1.0f)};
+    return vertex;
+}
+
+/**
+ * Makes a scene with many small triangles that cover the framebuffer, a few large overlapping
+ * ones and some that have to be clipped, in clip space.
+ */
+static std::vector<std::array<OutputVertex, 3>> MakeTriangles() {
+    std::vector<std::array<OutputVertex, 3>> triangles;
+    constexpr int GRID_SIZE = 16;
+    constexpr float CELL_SIZE = 2.0f / GRID_SIZE;
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            const float x0 = -1.0f + x * CELL_SIZE;
+            const float y0 = -1.0f + y * CELL_SIZE;
+            const float x1 = x0 + CELL_SIZE;
+            const float y1 = y0 + CELL_SIZE;
+            const float shade = static_cast<float>(x + y) / (2 * GRID_SIZE);
+            triangles.push_back({MakeVertex(x0, y0, shade, 0.0f, 1.0f),
+                                 MakeVertex(x1, y0, shade, 1.0f, 0.0f),
+                                 MakeVertex(x0, y1, 1.0f, shade, 0.0f)});
+            triangles.push_back({MakeVertex(x1, y0, shade, 1.0f, 0.0f),
+                                 MakeVertex(x1, y1, 0.0f, shade, 1.0f),
+                                 MakeVertex(x0, y1, 1.0f, shade, 0.0f)});
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        const float offset = i * 0.25f;
+        triangles.push_back({MakeVertex(-0.9f + offset, -0.9f, 1.0f, 0.0f, 0.0f),
+                             MakeVertex(0.9f, -0.5f + offset, 0.0f, 1.0f, 0.0f),
+                             MakeVertex(-0.5f, 0.9f - offset, 0.0f, 0.0f, 1.0f)});
+    }
+    triangles.push_back({MakeVertex(-1.5f, -1.5f, 1.0f, 1.0f, 0.0f),
+                         MakeVertex(1.5f, -0.5f, 0.0f, 1.0f, 1.0f),
+                         MakeVertex(0.0f, 1.5f, 1.0f, 0.0f, 1.0f)});
+    triangles.push_back({MakeVertex(0.5f, -2.0f, 0.5f, 0.5f, 0.5f),
+                         MakeVertex(2.0f, 2.0f, 0.5f, 0.5f, 0.5f),
+                         MakeVertex(-2.0f, 0.5f, 0.5f, 0.5f, 0.5f)});
+    return triangles;
+}
+
+TEST_CASE("SWRasterizer", "[video_core]") {
+    Memory::MemorySystem memory;
+    VideoCore::g_memory = &memory;
+
+    // Draws the interpolated vertex colors to an RGBA8 color buffer in VRAM, without depth,
+    // textures or lighting.
+    Pica::g_state.Reset();
+    auto& regs = Pica::g_state.regs;
+    regs.rasterizer.viewport_size_x.Assign(ToFloat24Raw(FRAMEBUFFER_SIZE / 2));
+    regs.rasterizer.viewport_size_y.Assign(ToFloat24Raw(FRAMEBUFFER_SIZE / 2));
+    regs.lighting.disable.Assign(1);
+    regs.framebuffer.output_merger.logic_op.Assign(Pica::FramebufferRegs::LogicOp::Copy);
+    regs.framebuffer.output_merger.red_enable.Assign(1);
+    regs.framebuffer.output_merger.green_enable.Assign(1);
+    regs.framebuffer.output_merger.blue_enable.Assign(1);
+    regs.framebuffer.output_merger.alpha_enable.Assign(1);
+    regs.framebuffer.framebuffer.allow_color_write.Assign(1);
+    regs.framebuffer.framebuffer.color_format.Assign(Pica::FramebufferRegs::ColorFormat::RGBA8);
+    regs.framebuffer.framebuffer.color_buffer_address.Assign(Memory::VRAM_PADDR / 8);
+    regs.framebuffer.framebuffer.width.Assign(FRAMEBUFFER_SIZE);
+    regs.framebuffer.framebuffer.height.Assign(FRAMEBUFFER_SIZE - 1);
+
+    const auto triangles = MakeTriangles();
+    BENCHMARK("Clipper::ProcessTriangle") {
+        for (const auto& triangle : triangles) {
+            Pica::Clipper::ProcessTriangle(triangle[0], triangle[1], triangle[2]);
+        }
+        return memory.GetPhysicalPointer(Memory::VRAM_PADDR)[0];
+    };
+
+    Pica::g_state.Reset();
+    VideoCore::g_memory = nullptr;
+}
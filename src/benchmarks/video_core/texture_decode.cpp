@@ -0,0 +1,50 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "video_core/regs_texturing.h"
+#include "video_core/texture/texture_decode.h"
+
+using Pica::TexturingRegs;
+using TextureFormat = TexturingRegs::TextureFormat;
+
+constexpr unsigned int TEXTURE_SIZE = 128;
+
+TEST_CASE("Texture decoding", "[video_core]") {
+    std::mt19937 rng(0x7E7);
+
+    const std::pair<TextureFormat, const char*> formats[] = {
+        {TextureFormat::RGBA8, "RGBA8"}, {TextureFormat::RGB565, "RGB565"},
+        {TextureFormat::RGBA4, "RGBA4"}, {TextureFormat::IA8, "IA8"},
+        {TextureFormat::I4, "I4"},       {TextureFormat::ETC1, "ETC1"},
+        {TextureFormat::ETC1A4, "ETC1A4"},
+    };
+
+    for (const auto& [format, format_name] : formats) {
+        Pica::Texture::TextureInfo info{};
+        info.width = TEXTURE_SIZE;
+        info.height = TEXTURE_SIZE;
+        info.format = format;
+        info.SetDefaultStride();
+
+        std::vector<u8> texture(info.stride * (TEXTURE_SIZE / 8));
+        std::generate(texture.begin(), texture.end(), [&rng] { return rng() & 0xFF; });
+
+        // Decodes the whole texture, as the rasterizer cache does when it loads a surface
+        BENCHMARK(std::string("LookupTexture ") + format_name) {
+            u32 sum = 0;
+            for (unsigned int y = 0; y < TEXTURE_SIZE; ++y) {
+                for (unsigned int x = 0; x < TEXTURE_SIZE; ++x) {
+                    sum += Pica::Texture::LookupTexture(texture.data(), x, y, info).r();
+                }
+            }
+            return sum;
+        };
+    }
+}
@@ -0,0 +1,59 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <catch2/catch.hpp>
+#include "core/memory.h"
+#include "video_core/debug_utils/debug_utils.h"
+#include "video_core/regs_pipeline.h"
+#include "video_core/shader/shader.h"
+#include "video_core/vertex_loader.h"
+#include "video_core/video_core.h"
+
+using Pica::PipelineRegs;
+using VertexAttributeFormat = PipelineRegs::VertexAttributeFormat;
+
+constexpr int NUM_VERTICES = 1024;
+
+TEST_CASE("VertexLoader", "[video_core]") {
+    Memory::MemorySystem memory;
+    VideoCore::g_memory = &memory;
+
+    // A common vertex layout: a float position, a byte color and a short texture coordinate,
+    // interleaved in a single array.
+    auto regs = std::make_unique<PipelineRegs>();
+    auto& attributes = regs->vertex_attributes;
+    attributes.format0.Assign(VertexAttributeFormat::FLOAT);
+    attributes.size0.Assign(2);
+    attributes.format1.Assign(VertexAttributeFormat::UBYTE);
+    attributes.size1.Assign(3);
+    attributes.format2.Assign(VertexAttributeFormat::SHORT);
+    attributes.size2.Assign(1);
+    attributes.max_attribute_index.Assign(2);
+    auto& loader = attributes.attribute_loaders[0];
+    loader.comp0.Assign(0);
+    loader.comp1.Assign(1);
+    loader.comp2.Assign(2);
+    loader.component_count.Assign(3);
+    loader.byte_count.Assign(20);
+
+    std::mt19937 rng(0x7E8);
+    u8* vertex_data = memory.GetPhysicalPointer(Memory::VRAM_PADDR);
+    std::generate_n(vertex_data, NUM_VERTICES * 20, [&rng] { return rng() & 0xFF; });
+
+    Pica::VertexLoader vertex_loader(*regs);
+    Pica::DebugUtils::MemoryAccessTracker memory_accesses;
+    Pica::Shader::AttributeBuffer input;
+
+    BENCHMARK("LoadVertex") {
+        for (int vertex = 0; vertex < NUM_VERTICES; ++vertex) {
+            vertex_loader.LoadVertex(Memory::VRAM_PADDR, vertex, vertex, input, memory_accesses);
+        }
+        return input.attr[0][0];
+    };
+
+    VideoCore::g_memory = nullptr;
+}
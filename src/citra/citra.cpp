@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <regex>
@@ -24,20 +25,30 @@
 #include "common/detached_tasks.h"
 #include "common/file_util.h"
 #include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
+#include "common/metrics.h"
 #include "common/scm_rev.h"
 #include "common/scope_exit.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/file_sys/cia_container.h"
+#include "core/frame_hasher.h"
 #include "core/frontend/applets/default_applets.h"
 #include "core/gdbstub/gdbstub.h"
+#include "core/guest_sampler.h"
 #include "core/hle/service/am/am.h"
 #include "core/hle/service/cfg/cfg.h"
+#include "core/hle/service/service_stats.h"
 #include "core/loader/loader.h"
+#include "core/metrics_server.h"
 #include "core/movie.h"
+#include "core/netplay.h"
 #include "core/settings.h"
+#include "core/tracer/player.h"
+#include "core/tracer/reader.h"
 #include "network/network.h"
 
 #undef _UNICODE
@@ -45,6 +56,9 @@
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
+#ifndef _WIN32
+#include <csignal>
+#endif
 
 #ifdef _WIN32
 extern "C" {
@@ -60,8 +74,26 @@ static void PrintHelp(const char* argv0) {
                  "-i, --install=FILE    Installs a specified CIA file\n"
                  "-m, --multiplayer=nick:password@address:port"
                  " Nickname, password, address and port for multiplayer\n"
+                 "-n, --netplay=PLAYERS Play in lockstep with PLAYERS instances in the room"
+                 " given with --multiplayer\n"
                  "-r, --movie-record=[file]  Record a movie (game inputs) to the given file\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
+                 "-s, --service-stats=FILE   Write HLE service call statistics as CSV to FILE"
+                 " on exit\n"
+                 "-P, --profile-guest=FILE   Sample the emulated code and write folded stacks"
+                 " for flame graphs to FILE on exit\n"
+                 "-t, --replay-trace=FILE    Replay a CiTrace GPU trace instead of a ROM and"
+                 " print the frame times\n"
+                 "-H, --hash-frames=FILE     Write hashes of both screens at every frame to FILE,"
+                 " and exit at the end of the movie given with --movie-play\n"
+                 "-d, --dump-frames=DIR      With --hash-frames, also write the screens as PNG"
+                 " images to DIR\n"
+                 "-I, --dump-interval=NUMBER Number of frames between two dumped frames"
+                 " (default 60)\n"
+                 "-M, --metrics-port=PORT    Serve live metrics in the Prometheus format on"
+                 " 127.0.0.1:PORT\n"
+                 "-F, --metrics-file=FILE    Write live metrics in the Prometheus format to FILE"
+                 " every few seconds\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
@@ -173,11 +205,41 @@ static void InitializeLogging() {
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
     Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.use_binary_log) {
+        Log::StartBinaryLog(log_dir + BINARY_LOG_FILE);
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
 }
 
+/// Replays a CiTrace GPU trace and prints how fast its frames were rendered
+static int ReplayTrace(Core::System& system, EmuWindow_SDL2& emu_window, const std::string& path) {
+    const auto trace = CiTrace::LoadTrace(path);
+    if (!trace) {
+        LOG_CRITICAL(Frontend, "Failed to load trace {}", path);
+        return -1;
+    }
+    if (system.InitForTraceReplay(emu_window) != Core::System::ResultStatus::Success) {
+        LOG_CRITICAL(Frontend, "Failed to initialize the system for replaying the trace");
+        return -1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const u32 frames = CiTrace::Replay(system, *trace);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto stats = system.perf_stats.GetFrameTimeStats();
+    std::cout << fmt::format("Replayed {} frames in {:.3f} s ({:.1f} FPS) with the {} renderer\n",
+                             frames, elapsed.count(), frames / elapsed.count(),
+                             Settings::values.use_hw_renderer ? "hardware" : "software")
+              << fmt::format("Frame time p50 / p95 / p99 / max: {:.2f} / {:.2f} / {:.2f} / "
+                             "{:.2f} ms of the last {} frames\n",
+                             stats.p50 * 1000, stats.p95 * 1000, stats.p99 * 1000,
+                             stats.max * 1000, stats.frames);
+    return 0;
+}
+
 /// Application entry point
 int main(int argc, char** argv) {
     Common::DetachedTasks detached_tasks;
@@ -187,6 +249,15 @@ int main(int argc, char** argv) {
     u32 gdb_port = static_cast<u32>(Settings::values.gdbstub_port);
     std::string movie_record;
     std::string movie_play;
+    std::string service_stats_path;
+    std::string guest_profile_path;
+    std::string replay_trace_path;
+    std::string frame_hashes_path;
+    std::string frame_dump_directory;
+    u32 frame_dump_interval = 60;
+    u32 metrics_port = 0;
+    std::string metrics_path;
+    u32 netplay_players = 0;
 
     InitializeLogging();
 
@@ -213,8 +284,17 @@ int main(int argc, char** argv) {
         {"gdbport", required_argument, 0, 'g'},
         {"install", required_argument, 0, 'i'},
         {"multiplayer", required_argument, 0, 'm'},
+        {"netplay", required_argument, 0, 'n'},
         {"movie-record", required_argument, 0, 'r'},
         {"movie-play", required_argument, 0, 'p'},
+        {"service-stats", required_argument, 0, 's'},
+        {"profile-guest", required_argument, 0, 'P'},
+        {"replay-trace", required_argument, 0, 't'},
+        {"hash-frames", required_argument, 0, 'H'},
+        {"dump-frames", required_argument, 0, 'd'},
+        {"dump-interval", required_argument, 0, 'I'},
+        {"metrics-port", required_argument, 0, 'M'},
+        {"metrics-file", required_argument, 0, 'F'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
@@ -222,7 +302,8 @@ int main(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:i:m:r:p:fhv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:i:m:n:r:p:s:P:t:H:d:I:M:F:fhv",
+                              long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -279,12 +360,60 @@ int main(int argc, char** argv) {
                 }
                 break;
             }
+            case 'n':
+                errno = 0;
+                netplay_players = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || netplay_players < 2)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--netplay");
+                    exit(1);
+                }
+                break;
             case 'r':
                 movie_record = optarg;
                 break;
             case 'p':
                 movie_play = optarg;
                 break;
+            case 's':
+                service_stats_path = optarg;
+                break;
+            case 'P':
+                guest_profile_path = optarg;
+                break;
+            case 't':
+                replay_trace_path = optarg;
+                break;
+            case 'H':
+                frame_hashes_path = optarg;
+                break;
+            case 'd':
+                frame_dump_directory = optarg;
+                break;
+            case 'I':
+                errno = 0;
+                frame_dump_interval = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || frame_dump_interval == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--dump-interval");
+                    exit(1);
+                }
+                break;
+            case 'M':
+                errno = 0;
+                metrics_port = strtoul(optarg, &endarg, 0);
+                if (endarg == optarg || metrics_port == 0 || metrics_port > 0xFFFF)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror("--metrics-port");
+                    exit(1);
+                }
+                break;
+            case 'F':
+                metrics_path = optarg;
+                break;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -312,8 +441,12 @@ int main(int argc, char** argv) {
 
     MicroProfileOnThreadCreate("EmuThread");
     SCOPE_EXIT({ MicroProfileShutdown(); });
+    Common::Trace::SetThreadName("EmuThread");
+#ifndef _WIN32
+    std::signal(SIGUSR1, [](int) { Common::Trace::RequestDump(); });
+#endif
 
-    if (filepath.empty()) {
+    if (filepath.empty() && replay_trace_path.empty()) {
         LOG_CRITICAL(Frontend, "Failed to load ROM: No ROM specified");
         return -1;
     }
@@ -323,6 +456,24 @@ int main(int argc, char** argv) {
         return -1;
     }
 
+    if (netplay_players != 0) {
+        if (!use_multiplayer) {
+            LOG_CRITICAL(Frontend, "Netplay requires a room given with --multiplayer");
+            return -1;
+        }
+        if (!movie_record.empty() || !movie_play.empty()) {
+            LOG_CRITICAL(Frontend, "Cannot use netplay together with movies");
+            return -1;
+        }
+        // All players have to start from the same state
+        Settings::values.init_clock = Settings::InitClock::FixedTime;
+    }
+
+    if (!frame_hashes_path.empty() && movie_play.empty()) {
+        // Movies set the clock themselves, otherwise the hashes would depend on the current time
+        Settings::values.init_clock = Settings::InitClock::FixedTime;
+    }
+
     if (!movie_record.empty()) {
         Core::Movie::GetInstance().PrepareForRecording();
     }
@@ -333,6 +484,11 @@ int main(int argc, char** argv) {
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (!replay_trace_path.empty()) {
+        // Render the trace as fast as possible
+        Settings::values.use_frame_limit = false;
+        Settings::values.vsync_enabled = false;
+    }
     Settings::Apply();
 
     // Register frontend applets
@@ -344,6 +500,10 @@ int main(int argc, char** argv) {
 
     SCOPE_EXIT({ system.Shutdown(); });
 
+    if (!replay_trace_path.empty()) {
+        return ReplayTrace(system, *emu_window, replay_trace_path);
+    }
+
     const Core::System::ResultStatus load_result{system.Load(*emu_window, filepath)};
 
     switch (load_result) {
@@ -385,25 +545,89 @@ int main(int argc, char** argv) {
             member->BindOnError(OnNetworkError);
             LOG_DEBUG(Network, "Start connection to {}:{} with nickname {}", address, port,
                       nickname);
-            member->Join(nickname, Service::CFG::GetConsoleIdHash(system), address.c_str(), port, 0,
-                         Network::NoPreferredMac, password);
+            std::string console_id = Service::CFG::GetConsoleIdHash(system);
+            if (netplay_players != 0) {
+                // Several instances on the same machine share the console ID
+                console_id += ":" + nickname;
+            }
+            member->Join(nickname, console_id, address.c_str(), port, 0, Network::NoPreferredMac,
+                         password);
         } else {
             LOG_ERROR(Network, "Could not access RoomMember");
             return 0;
         }
     }
 
+    bool movie_finished = false;
     if (!movie_play.empty()) {
-        Core::Movie::GetInstance().StartPlayback(movie_play);
+        if (frame_hashes_path.empty()) {
+            Core::Movie::GetInstance().StartPlayback(movie_play);
+        } else {
+            Core::Movie::GetInstance().StartPlayback(movie_play,
+                                                     [&movie_finished] { movie_finished = true; });
+        }
     }
     if (!movie_record.empty()) {
         Core::Movie::GetInstance().StartRecording(movie_record);
     }
 
-    while (emu_window->IsOpen()) {
+    std::unique_ptr<Core::NetPlay> netplay;
+    if (netplay_players != 0) {
+        netplay = std::make_unique<Core::NetPlay>(system, Settings::values.netplay_input_delay);
+        if (!netplay->Start(netplay_players)) {
+            LOG_CRITICAL(Frontend, "Failed to start netplay");
+            return -1;
+        }
+    }
+
+    if (!guest_profile_path.empty()) {
+        system.GuestSampler().Start(1000);
+    }
+
+    std::unique_ptr<Core::FrameHasher> frame_hasher;
+    if (!frame_hashes_path.empty()) {
+        frame_hasher = std::make_unique<Core::FrameHasher>(
+            system.Memory(), frame_hashes_path, frame_dump_directory, frame_dump_interval);
+        if (!frame_hasher->IsOpen()) {
+            return -1;
+        }
+    }
+
+    std::unique_ptr<Core::MetricsServer> metrics_server;
+    if (metrics_port != 0) {
+        try {
+            metrics_server = std::make_unique<Core::MetricsServer>(static_cast<u16>(metrics_port));
+        } catch (const std::exception& e) {
+            LOG_ERROR(Frontend, "Could not serve the metrics on port {}: {}", metrics_port,
+                      e.what());
+        }
+    }
+    std::unique_ptr<Common::Metrics::FileExporter> metrics_exporter;
+    if (!metrics_path.empty()) {
+        metrics_exporter =
+            std::make_unique<Common::Metrics::FileExporter>(metrics_path, std::chrono::seconds(5));
+    }
+
+    while (emu_window->IsOpen() && !movie_finished) {
         system.RunLoop();
     }
 
+    frame_hasher.reset();
+
+    if (!guest_profile_path.empty()) {
+        system.GuestSampler().Stop();
+        const std::string stacks = system.GuestSampler().GetFoldedStacks();
+        if (FileUtil::WriteStringToFile(true, guest_profile_path, stacks) != stacks.size()) {
+            LOG_ERROR(Frontend, "Could not write the guest profile to {}", guest_profile_path);
+        }
+    }
+
+    if (!service_stats_path.empty() &&
+        !FileUtil::WriteStringToFile(true, service_stats_path,
+                                     Service::GetCallStatistics().FormatCSV())) {
+        LOG_ERROR(Frontend, "Could not write the service statistics to {}", service_stats_path);
+    }
+
     Core::Movie::GetInstance().Shutdown();
 
     detached_tasks.WaitForAllTasks();
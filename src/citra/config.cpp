@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <iomanip>
 #include <memory>
 #include <sstream>
@@ -167,6 +168,8 @@ void Config::ReadValues() {
         sdl2_config->GetBoolean("Audio", "enable_audio_stretching", true);
     Settings::values.audio_device_id = sdl2_config->GetString("Audio", "output_device", "auto");
     Settings::values.volume = static_cast<float>(sdl2_config->GetReal("Audio", "volume", 1));
+    Settings::values.enable_aac_disk_cache =
+        sdl2_config->GetBoolean("Audio", "enable_aac_disk_cache", false);
     Settings::values.mic_input_device =
         sdl2_config->GetString("Audio", "mic_input_device", "Default");
     Settings::values.mic_input_type =
@@ -175,6 +178,8 @@ void Config::ReadValues() {
     // Data Storage
     Settings::values.use_virtual_sd =
         sdl2_config->GetBoolean("Data Storage", "use_virtual_sd", true);
+    Settings::values.fs_delay_percentage = static_cast<u16>(std::clamp<long>(
+        sdl2_config->GetInteger("Data Storage", "fs_delay_percentage", 100), 0, 0xFFFF));
 
     // System
     Settings::values.is_new_3ds = sdl2_config->GetBoolean("System", "is_new_3ds", false);
@@ -226,17 +231,28 @@ void Config::ReadValues() {
 
     // Miscellaneous
     Settings::values.log_filter = sdl2_config->GetString("Miscellaneous", "log_filter", "*:Info");
+    Settings::values.use_binary_log =
+        sdl2_config->GetBoolean("Miscellaneous", "use_binary_log", false);
 
     // Debugging
     Settings::values.use_gdbstub = sdl2_config->GetBoolean("Debugging", "use_gdbstub", false);
     Settings::values.gdbstub_port =
         static_cast<u16>(sdl2_config->GetInteger("Debugging", "gdbstub_port", 24689));
+    Settings::values.trace_buffer_size =
+        static_cast<u32>(sdl2_config->GetInteger("Debugging", "trace_buffer_size", 0));
+    Settings::values.trace_slow_frame_ms =
+        static_cast<u32>(sdl2_config->GetInteger("Debugging", "trace_slow_frame_ms", 0));
+    Settings::values.rpc_socket_path = sdl2_config->GetString("Debugging", "rpc_socket_path", "");
 
     for (const auto& service_module : Service::service_module_map) {
         bool use_lle = sdl2_config->GetBoolean("Debugging", "LLE\\" + service_module.name, false);
         Settings::values.lle_modules.emplace(service_module.name, use_lle);
     }
 
+    // Netplay
+    Settings::values.netplay_input_delay = static_cast<u16>(
+        std::clamp<long>(sdl2_config->GetInteger("Netplay", "input_delay", 2), 0, 60));
+
     // Web Service
     Settings::values.enable_telemetry =
         sdl2_config->GetBoolean("WebService", "enable_telemetry", true);
@@ -183,7 +183,8 @@ enable_dsp_lle_thread =
 
 
 # Which audio output engine to use.
-# auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available)
+# auto (default): Auto-select, null: No audio output, sdl2: SDL2 (if available),
+# wav: Write audio to a WAV file on emulated time, without throttling emulation
 output_engine =
 
 # Whether or not to enable the audio-stretching post-processing effect.
@@ -192,7 +193,7 @@ output_engine =
 # 0: No, 1 (default): Yes
 enable_audio_stretching =
 
-# Which audio device to use.
+# Which audio device to use. For the wav engine, this is the path of the file to write.
 # auto (default): Auto-select
 output_device =
 
@@ -200,11 +201,25 @@ output_device =
 # 1.0 (default): 100%, 0.0; mute
 volume =
 
+# Whether to keep decoded AAC audio in the user cache directory, so it is not decoded again
+# in later sessions. Decoded audio is always cached in memory.
+# 0 (default): No, 1: Yes
+enable_aac_disk_cache =
+
 [Data Storage]
 # Whether to create a virtual SD card.
 # 1 (default): Yes, 0: No
 use_virtual_sd =
 
+# Scales the emulated latency of file system requests, in percent of the hardware timing.
+# Lower values speed up loading, but some titles break when reads complete too fast.
+# Titles can override this, and the timing of opens and reads, with a profile named after their
+# program ID, such as fs_delay_profiles/0004000000055D00.txt in the user directory. Profiles hold
+# any of the keys percentage, open_ns, read_base_ns and read_ns_per_byte, one "key = value" per
+# line. Reads then take read_base_ns + read_ns_per_byte * size before scaling.
+# 0: Instant, 100 (default): Hardware timing
+fs_delay_percentage =
+
 [System]
 # The system model that Citra will try to emulate
 # 0: Old 3DS (default), 1: New 3DS
@@ -250,12 +265,32 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Whether to write log messages below Warning to citra_log.bin instead of the text log. This is
+# much cheaper when many messages are logged. Decode the file with citra-log-decoder.
+# 0 (default): No, 1: Yes
+use_binary_log =
+
 [Debugging]
 # Port for listening to GDB connections.
 use_gdbstub=false
 gdbstub_port=24689
+# Number of timed events (MicroProfile scopes, HLE requests, frames) to keep per thread for traces.
+# Traces are written to the log directory as Chrome trace files, which Perfetto can open. On Linux
+# and macOS, sending SIGUSR1 to citra writes a trace at the end of the current frame.
+# 0 (default): Disables tracing
+trace_buffer_size =
+# Writes a trace when a frame takes longer than this many milliseconds. 0 (default): Never
+trace_slow_frame_ms =
+# Path of the local socket that scripts can connect to. The default is citra-rpc.sock in
+# $XDG_RUNTIME_DIR, or /tmp/citra-rpc-<user id>.sock when it isn't set
+rpc_socket_path =
 # To LLE a service module add "LLE\<module name>=true"
 
+[Netplay]
+# Number of frames that the input of all players is delayed by when playing with --netplay.
+# Higher values hide more network latency, but make the game less responsive. Default: 2
+input_delay =
+
 [WebService]
 # Whether or not to enable telemetry
 # 0: No, 1 (default): Yes
@@ -8,6 +8,7 @@
 #include "citra_qt/bootmanager.h"
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
+#include "common/trace.h"
 #include "core/3ds.h"
 #include "core/core.h"
 #include "core/settings.h"
@@ -25,6 +26,7 @@ void EmuThread::run() {
     render_window->MakeCurrent();
 
     MicroProfileOnThreadCreate("EmuThread");
+    Common::Trace::SetThreadName("EmuThread");
 
     // Holds whether the cpu was running during the last iteration,
     // so that the DebugModeLeft signal can be emitted before the
@@ -198,6 +198,7 @@ void Config::ReadValues() {
     Settings::values.audio_device_id =
         ReadSetting("output_device", "auto").toString().toStdString();
     Settings::values.volume = ReadSetting("volume", 1).toFloat();
+    Settings::values.enable_aac_disk_cache = ReadSetting("enable_aac_disk_cache", false).toBool();
     Settings::values.mic_input_type =
         static_cast<Settings::MicInputType>(ReadSetting("mic_input_type", 0).toInt());
     Settings::values.mic_input_device =
@@ -227,6 +228,8 @@ void Config::ReadValues() {
 
     qt_config->beginGroup("Data Storage");
     Settings::values.use_virtual_sd = ReadSetting("use_virtual_sd", true).toBool();
+    Settings::values.fs_delay_percentage =
+        static_cast<u16>(std::clamp(ReadSetting("fs_delay_percentage", 100).toInt(), 0, 0xFFFF));
     qt_config->endGroup();
 
     qt_config->beginGroup("System");
@@ -240,11 +243,15 @@ void Config::ReadValues() {
 
     qt_config->beginGroup("Miscellaneous");
     Settings::values.log_filter = ReadSetting("log_filter", "*:Info").toString().toStdString();
+    Settings::values.use_binary_log = ReadSetting("use_binary_log", false).toBool();
     qt_config->endGroup();
 
     qt_config->beginGroup("Debugging");
     Settings::values.use_gdbstub = ReadSetting("use_gdbstub", false).toBool();
     Settings::values.gdbstub_port = ReadSetting("gdbstub_port", 24689).toInt();
+    Settings::values.trace_buffer_size = ReadSetting("trace_buffer_size", 0).toUInt();
+    Settings::values.trace_slow_frame_ms = ReadSetting("trace_slow_frame_ms", 0).toUInt();
+    Settings::values.rpc_socket_path = ReadSetting("rpc_socket_path", "").toString().toStdString();
 
     qt_config->beginGroup("LLE");
     for (const auto& service_module : Service::service_module_map) {
@@ -377,6 +384,8 @@ void Config::ReadValues() {
     UISettings::values.room_nickname = ReadSetting("room_nickname", "").toString();
     UISettings::values.room_name = ReadSetting("room_name", "").toString();
     UISettings::values.room_port = ReadSetting("room_port", "24872").toString();
+    Settings::values.netplay_input_delay =
+        static_cast<u16>(std::clamp(ReadSetting("netplay_input_delay", 2).toInt(), 0, 60));
     bool ok;
     UISettings::values.host_type = ReadSetting("host_type", 0).toUInt(&ok);
     if (!ok) {
@@ -484,6 +493,7 @@ void Config::SaveValues() {
     WriteSetting("enable_audio_stretching", Settings::values.enable_audio_stretching, true);
     WriteSetting("output_device", QString::fromStdString(Settings::values.audio_device_id), "auto");
     WriteSetting("volume", Settings::values.volume, 1.0f);
+    WriteSetting("enable_aac_disk_cache", Settings::values.enable_aac_disk_cache, false);
     WriteSetting("mic_input_device", QString::fromStdString(Settings::values.mic_input_device),
                  "Default");
     WriteSetting("mic_input_type", static_cast<int>(Settings::values.mic_input_type), 0);
@@ -510,6 +520,7 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Data Storage");
     WriteSetting("use_virtual_sd", Settings::values.use_virtual_sd, true);
+    WriteSetting("fs_delay_percentage", Settings::values.fs_delay_percentage, 100);
     qt_config->endGroup();
 
     qt_config->beginGroup("System");
@@ -523,11 +534,15 @@ void Config::SaveValues() {
 
     qt_config->beginGroup("Miscellaneous");
     WriteSetting("log_filter", QString::fromStdString(Settings::values.log_filter), "*:Info");
+    WriteSetting("use_binary_log", Settings::values.use_binary_log, false);
     qt_config->endGroup();
 
     qt_config->beginGroup("Debugging");
     WriteSetting("use_gdbstub", Settings::values.use_gdbstub, false);
     WriteSetting("gdbstub_port", Settings::values.gdbstub_port, 24689);
+    WriteSetting("trace_buffer_size", Settings::values.trace_buffer_size, 0);
+    WriteSetting("trace_slow_frame_ms", Settings::values.trace_slow_frame_ms, 0);
+    WriteSetting("rpc_socket_path", QString::fromStdString(Settings::values.rpc_socket_path), "");
 
     qt_config->beginGroup("LLE");
     for (const auto& service_module : Settings::values.lle_modules) {
@@ -621,6 +636,7 @@ void Config::SaveValues() {
     WriteSetting("room_nickname", UISettings::values.room_nickname, "");
     WriteSetting("room_name", UISettings::values.room_name, "");
     WriteSetting("room_port", UISettings::values.room_port, "24872");
+    WriteSetting("netplay_input_delay", Settings::values.netplay_input_delay, 2);
     WriteSetting("host_type", UISettings::values.host_type, 0);
     WriteSetting("max_player", UISettings::values.max_player, 8);
     WriteSetting("game_id", UISettings::values.game_id, 0);
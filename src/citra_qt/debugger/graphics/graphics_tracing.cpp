@@ -62,6 +62,14 @@ void GraphicsTracingWidget::StartRecording() {
     if (!context)
         return;
 
+    QString filename = QFileDialog::getSaveFileName(this, tr("Save CiTrace"), "citrace.ctf",
+                                                    tr("CiTrace File (*.ctf)"));
+
+    if (filename.isEmpty()) {
+        // If the user canceled the dialog, don't start recording
+        return;
+    }
+
     auto shader_binary = Pica::g_state.vs.program_code;
     auto swizzle_data = Pica::g_state.vs.swizzle_data;
 
@@ -96,8 +104,7 @@ void GraphicsTracingWidget::StartRecording() {
     // boost::copy(TODO: Not implemented, std::back_inserter(state.gs_swizzle_data));
     // boost::copy(TODO: Not implemented, std::back_inserter(state.gs_float_uniforms));
 
-    auto recorder = new CiTrace::Recorder(state);
-    context->recorder = std::shared_ptr<CiTrace::Recorder>(recorder);
+    context->recorder = std::make_shared<CiTrace::Recorder>(state, filename.toStdString());
 
     emit SetStartTracingButtonEnabled(false);
     emit SetStopTracingButtonEnabled(true);
@@ -109,15 +116,7 @@ void GraphicsTracingWidget::StopRecording() {
     if (!context)
         return;
 
-    QString filename = QFileDialog::getSaveFileName(this, tr("Save CiTrace"), "citrace.ctf",
-                                                    tr("CiTrace File (*.ctf)"));
-
-    if (filename.isEmpty()) {
-        // If the user canceled the dialog, keep recording
-        return;
-    }
-
-    context->recorder->Finish(filename.toStdString());
+    context->recorder->Finish();
     context->recorder = nullptr;
 
     emit SetStopTracingButtonEnabled(false);
@@ -130,6 +129,7 @@ void GraphicsTracingWidget::AbortRecording() {
     if (!context)
         return;
 
+    context->recorder->Abort();
     context->recorder = nullptr;
 
     emit SetStopTracingButtonEnabled(false);
@@ -49,6 +49,7 @@
 #include "common/detached_tasks.h"
 #include "common/file_util.h"
 #include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
@@ -117,6 +118,9 @@ static void InitializeLogging() {
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
     Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.use_binary_log) {
+        Log::StartBinaryLog(log_dir + BINARY_LOG_FILE);
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -1612,6 +1616,24 @@ void GMainWindow::UpdateStatusBar() {
     game_fps_label->setText(tr("Game: %1 FPS").arg(results.game_fps, 0, 'f', 0));
     emu_frametime_label->setText(tr("Frame: %1 ms").arg(results.frametime * 1000.0, 0, 'f', 2));
 
+    using Component = Core::PerfStats::Component;
+    const auto& frame_time = results.frame_time;
+    const auto ms = [](double seconds) { return QString::number(seconds * 1000.0, 'f', 2); };
+    const auto component_ms = [&frame_time, &ms](Component component) {
+        return ms(frame_time.component_time[static_cast<std::size_t>(component)]);
+    };
+    emu_frametime_label->setToolTip(
+        tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
+           "full-speed emulation this should be at most 16.67 ms.") +
+        tr("\n\nFrame time p50 / p95 / p99 / max: %1 / %2 / %3 / %4 ms\nHitches: %5")
+            .arg(ms(frame_time.p50), ms(frame_time.p95), ms(frame_time.p99), ms(frame_time.max))
+            .arg(frame_time.hitches) +
+        tr("\nPer frame: CPU %1 ms, GPU %2 ms, rasterizer flushes %3 ms, DSP %4 ms, "
+           "frame limiting %5 ms, other %6 ms")
+            .arg(component_ms(Component::CPU), component_ms(Component::GPU),
+                 component_ms(Component::RasterizerFlush), component_ms(Component::DSP),
+                 component_ms(Component::FrameLimiting), ms(frame_time.other_time)));
+
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
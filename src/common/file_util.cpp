@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <array>
+#include <cerrno>
+#include <cstring>
 #include <memory>
 #include <unordered_map>
 #include "common/assert.h"
@@ -88,9 +90,8 @@ static void StripTailDirSlashes(std::string& fname) {
     fname.resize(i);
 }
 
-bool Exists(const std::string& filename) {
-    struct stat file_info;
-
+// Calls stat on filename, with the platform specific handling of paths
+static int StatPath(const std::string& filename, struct stat& file_info) {
     std::string copy(filename);
     StripTailDirSlashes(copy);
 
@@ -99,38 +100,41 @@ bool Exists(const std::string& filename) {
     if (copy.size() != 0 && copy.back() == ':')
         copy += DIR_SEP_CHR;
 
-    int result = _wstat64(Common::UTF8ToUTF16W(copy).c_str(), &file_info);
+    return _wstat64(Common::UTF8ToUTF16W(copy).c_str(), &file_info);
 #else
-    int result = stat(copy.c_str(), &file_info);
+    return stat(copy.c_str(), &file_info);
 #endif
+}
 
-    return (result == 0);
+bool Exists(const std::string& filename) {
+    struct stat file_info;
+    return StatPath(filename, file_info) == 0;
 }
 
 bool IsDirectory(const std::string& filename) {
     struct stat file_info;
-
-    std::string copy(filename);
-    StripTailDirSlashes(copy);
-
-#ifdef _WIN32
-    // Windows needs a slash to identify a driver root
-    if (copy.size() != 0 && copy.back() == ':')
-        copy += DIR_SEP_CHR;
-
-    int result = _wstat64(Common::UTF8ToUTF16W(copy).c_str(), &file_info);
-#else
-    int result = stat(copy.c_str(), &file_info);
-#endif
-
-    if (result < 0) {
-        LOG_DEBUG(Common_Filesystem, "stat failed on {}: {}", filename, GetLastErrorMsg());
+    if (StatPath(filename, file_info) < 0) {
+        // stat sets errno on every platform. A missing path is an answer rather than a failure,
+        // and CreateFullPath asks about every component that it is about to create.
+        const int err = errno;
+        if (err != ENOENT && err != ENOTDIR) {
+            LOG_DEBUG(Common_Filesystem, "stat failed on {}: {}", filename, strerror(err));
+        }
         return false;
     }
 
     return S_ISDIR(file_info.st_mode);
 }
 
+EntryType GetEntryType(const std::string& filename) {
+    struct stat file_info;
+    if (StatPath(filename, file_info) < 0) {
+        return EntryType::NotFound;
+    }
+
+    return S_ISDIR(file_info.st_mode) ? EntryType::Directory : EntryType::File;
+}
+
 bool Delete(const std::string& filename) {
     LOG_TRACE(Common_Filesystem, "file {}", filename);
 
@@ -317,29 +321,19 @@ bool Copy(const std::string& srcFilename, const std::string& destFilename) {
 }
 
 u64 GetSize(const std::string& filename) {
-    if (!Exists(filename)) {
-        LOG_ERROR(Common_Filesystem, "failed {}: No such file", filename);
+    struct stat buf;
+    if (StatPath(filename, buf) != 0) {
+        LOG_ERROR(Common_Filesystem, "failed {}: {}", filename, strerror(errno));
         return 0;
     }
 
-    if (IsDirectory(filename)) {
+    if (S_ISDIR(buf.st_mode)) {
         LOG_ERROR(Common_Filesystem, "failed {}: is a directory", filename);
         return 0;
     }
 
-    struct stat buf;
-#ifdef _WIN32
-    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
-#else
-    if (stat(filename.c_str(), &buf) == 0)
-#endif
-    {
-        LOG_TRACE(Common_Filesystem, "{}: {}", filename, buf.st_size);
-        return buf.st_size;
-    }
-
-    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
-    return 0;
+    LOG_TRACE(Common_Filesystem, "{}: {}", filename, buf.st_size);
+    return buf.st_size;
 }
 
 u64 GetSize(const int fd) {
@@ -445,7 +439,16 @@ u64 ScanDirectoryTree(const std::string& directory, FSTEntry& parent_entry,
         entry.virtualName = virtual_name;
         entry.physicalName = directory + DIR_SEP + virtual_name;
 
-        if (IsDirectory(entry.physicalName)) {
+        // A single stat call gives both the type and the size of the entry, which matters for
+        // directories holding many small files
+        struct stat file_info;
+        const int result = StatPath(entry.physicalName, file_info);
+        if (result != 0) {
+            LOG_DEBUG(Common_Filesystem, "stat failed on {}: {}", entry.physicalName,
+                      strerror(errno));
+        }
+
+        if (result == 0 && S_ISDIR(file_info.st_mode)) {
             entry.isDirectory = true;
             // is a directory, lets go inside if we didn't recurse to often
             if (recursion > 0) {
@@ -456,7 +459,7 @@ u64 ScanDirectoryTree(const std::string& directory, FSTEntry& parent_entry,
             }
         } else { // is a file
             entry.isDirectory = false;
-            entry.size = GetSize(entry.physicalName);
+            entry.size = result == 0 ? static_cast<u64>(file_info.st_size) : 0;
         }
         (*num_entries_out)++;
 
@@ -711,6 +714,7 @@ void SetUserPath(const std::string& path) {
     g_paths.emplace(UserPath::LogDir, user_path + LOG_DIR DIR_SEP);
     g_paths.emplace(UserPath::CheatsDir, user_path + CHEATS_DIR DIR_SEP);
     g_paths.emplace(UserPath::DLLDir, user_path + DLL_DIR DIR_SEP);
+    g_paths.emplace(UserPath::FSDelayProfilesDir, user_path + FS_DELAY_PROFILES_DIR DIR_SEP);
 }
 
 const std::string& GetUserPath(UserPath path) {
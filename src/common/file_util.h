@@ -26,6 +26,7 @@ enum class UserPath {
     CheatsDir,
     ConfigDir,
     DLLDir,
+    FSDelayProfilesDir,
     LogDir,
     NANDDir,
     RootDir,
@@ -49,6 +50,12 @@ bool Exists(const std::string& filename);
 // Returns true if filename is a directory
 bool IsDirectory(const std::string& filename);
 
+enum class EntryType { NotFound, File, Directory };
+
+// Returns the type of the entry at filename, with a single stat call instead of the two that
+// Exists and IsDirectory take together
+EntryType GetEntryType(const std::string& filename);
+
 // Returns the size of filename (64bit)
 u64 GetSize(const std::string& filename);
 
@@ -8,7 +8,6 @@
 #include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <regex>
 #include <thread>
 #include <vector>
 #ifdef _WIN32
@@ -19,6 +18,7 @@
 #endif
 #include "common/assert.h"
 #include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
 #include "common/logging/log.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
@@ -115,15 +115,12 @@ private:
         using std::chrono::duration_cast;
         using std::chrono::steady_clock;
 
-        // matches from the beginning up to the last '../' or 'src/'
-        static const std::regex trim_source_path(R"(.*([\/\\]|^)((\.\.)|(src))[\/\\])");
-
         Entry entry;
         entry.timestamp =
             duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
         entry.log_class = log_class;
         entry.log_level = log_level;
-        entry.filename = std::regex_replace(filename, trim_source_path, "");
+        entry.filename = filename;
         entry.line_num = line_nr;
         entry.function = function;
         entry.message = std::move(message);
@@ -290,6 +287,24 @@ Backend* GetBackend(std::string_view backend_name) {
     return Impl::Instance().GetBackend(backend_name);
 }
 
+MessageOutputs GetMessageOutputs(Class log_class, Level log_level) {
+    const auto& filter = Impl::Instance().GetGlobalFilter();
+    if (!filter.CheckMessage(log_class, log_level))
+        return {};
+
+    if (!IsBinaryLogRunning())
+        return {true, false};
+
+    // Warnings and errors are still shown right away
+    return {log_level >= Level::Warning, true};
+}
+
+void PushTextMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                     const char* function, const char* format, const fmt::format_args& args) {
+    Impl::Instance().PushEntry(log_class, log_level, filename, line_num, function,
+                               fmt::vformat(format, args));
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
@@ -298,7 +313,7 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
     if (!filter.CheckMessage(log_class, log_level))
         return;
 
-    instance.PushEntry(log_class, log_level, filename, line_num, function,
-                       fmt::vformat(format, args));
+    instance.PushEntry(log_class, log_level, filename + TrimmedSourcePathLength(filename),
+                       line_num, function, fmt::vformat(format, args));
 }
 } // namespace Log
@@ -0,0 +1,660 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/log.h"
+#include "common/ring_buffer.h"
+
+// Layout of a binary log file: a header (magic and version, both u32), followed by records. Every
+// record starts with its RecordType (u8) and the size of the rest of the record (u16). Values are
+// stored in host byte order.
+//
+// Site record:    u32 site ID, u32 line, string filename, string function, string format
+// Message record: u32 site ID, u64 timestamp in us, u16 thread, u8 class, u8 level, u8 number of
+//                 arguments or BinaryArgs::Formatted, arguments as serialized by BinaryArgs
+// Dropped record: u16 thread, u32 number of messages that did not fit into the staging buffer
+//
+// Strings are stored as their length (u16) followed by their characters.
+
+namespace Log {
+
+namespace {
+
+constexpr u32 BinaryLogMagic = 0x474F4C43; // "CLOG"
+constexpr u32 BinaryLogVersion = 1;
+
+enum class RecordType : u8 {
+    Site,
+    Message,
+    Dropped,
+};
+
+/// Size of the buffer that each thread stages its messages in.
+constexpr std::size_t StagingBufferSize = 0x40000;
+
+/// How often the staged messages are written to the file.
+constexpr auto FlushInterval = std::chrono::milliseconds(10);
+
+/// How long a thread waits for the writer to make room in its full staging buffer before it drops
+/// the message.
+constexpr auto MaxBackpressureWait = std::chrono::milliseconds(50);
+
+/// Size of the fixed part of a message record.
+constexpr std::size_t MessageHeaderSize = 1 + 2 + 4 + 8 + 2 + 1 + 1 + 1;
+
+/// Builds a record in a fixed size buffer.
+template <std::size_t MaxSize>
+class RecordWriter {
+public:
+    explicit RecordWriter(RecordType type) {
+        Put(static_cast<u8>(type));
+        Put<u16>(0);
+    }
+
+    template <typename T>
+    void Put(const T& value) {
+        PutBytes(&value, sizeof(T));
+    }
+
+    void PutBytes(const void* bytes, std::size_t length) {
+        length = std::min(length, MaxSize - size);
+        std::memcpy(data.data() + size, bytes, length);
+        size += length;
+    }
+
+    void PutString(std::string_view str) {
+        const u16 length = static_cast<u16>(
+            std::min(str.size(), MaxSize - std::min(MaxSize, size + sizeof(u16))));
+        Put(length);
+        PutBytes(str.data(), length);
+    }
+
+    /// Fills in the size of the record and returns it.
+    std::pair<const u8*, std::size_t> Finish() {
+        const u16 record_size = static_cast<u16>(size - 3);
+        std::memcpy(data.data() + 1, &record_size, sizeof(record_size));
+        return {data.data(), size};
+    }
+
+private:
+    std::array<u8, MaxSize> data;
+    std::size_t size = 0;
+};
+
+/// Messages of a single thread that have not been written to the file yet.
+struct StagingBuffer {
+    Common::RingBuffer<u8, StagingBufferSize> ring;
+    /// Number of messages that did not fit into the ring buffer.
+    std::atomic<u32> dropped{0};
+    /// Number of dropped messages that were reported in the file. Only written by the writer.
+    std::atomic<u32> dropped_reported{0};
+    std::atomic<bool> thread_exited{false};
+    u16 thread_index = 0;
+};
+
+class BinaryLogger {
+public:
+    static BinaryLogger& Instance() {
+        static BinaryLogger logger;
+        return logger;
+    }
+
+    BinaryLogger(const BinaryLogger&) = delete;
+    BinaryLogger& operator=(const BinaryLogger&) = delete;
+
+    bool Start(const std::string& path) {
+        Stop();
+
+        // The writer thread is not running, so the file can be used without locking
+        if (!file.Open(path, "wb")) {
+            return false;
+        }
+        file.WriteObject(BinaryLogMagic);
+        file.WriteObject(BinaryLogVersion);
+        sites_written = 0;
+        stop_requested = false;
+        writer_thread = std::thread([this] { WriterLoop(); });
+        running = true;
+        return true;
+    }
+
+    void Stop() {
+        if (!writer_thread.joinable()) {
+            return;
+        }
+        running = false;
+        {
+            std::lock_guard lock{writer_mutex};
+            stop_requested = true;
+        }
+        writer_cv.notify_one();
+        writer_thread.join();
+        file.Close();
+    }
+
+    bool IsRunning() const {
+        return running.load(std::memory_order_relaxed);
+    }
+
+    void Push(SourceSite& site, Class log_class, Level log_level, const char* filename,
+              unsigned int line_num, const char* function, const char* format,
+              const BinaryArgs& args) {
+        const u32 site_id = RegisterSite(site, filename, line_num, function, format);
+        StagingBuffer& buffer = GetThreadBuffer();
+
+        const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - time_origin);
+        RecordWriter<MessageHeaderSize + BinaryArgs::MaxSize> record(RecordType::Message);
+        record.Put(site_id);
+        record.Put(static_cast<u64>(timestamp.count()));
+        record.Put(buffer.thread_index);
+        record.Put(static_cast<u8>(log_class));
+        record.Put(static_cast<u8>(log_level));
+        record.Put(args.Count());
+        record.PutBytes(args.Data(), args.Size());
+
+        const auto [data, size] = record.Finish();
+        if (!WaitForSpace(buffer, size)) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer.ring.Push(data, size);
+    }
+
+private:
+    BinaryLogger() = default;
+
+    ~BinaryLogger() {
+        Stop();
+    }
+
+    u32 RegisterSite(SourceSite& site, const char* filename, unsigned int line_num,
+                     const char* function, const char* format) {
+        u32 id = site.id.load(std::memory_order_acquire);
+        if (id != 0) {
+            return id;
+        }
+
+        std::lock_guard lock{registration_mutex};
+        id = site.id.load(std::memory_order_relaxed);
+        if (id != 0) {
+            return id;
+        }
+        id = static_cast<u32>(sites.size() + 1);
+
+        RecordWriter<0x1000> record(RecordType::Site);
+        record.Put(id);
+        record.Put(static_cast<u32>(line_num));
+        record.PutString(filename);
+        record.PutString(function);
+        record.PutString(format);
+        const auto [data, size] = record.Finish();
+        sites.emplace_back(data, data + size);
+
+        // Published after the record is queued. The writer only writes messages that were staged
+        // before it took the new sites, so it never writes a message of an unknown site.
+        site.id.store(id, std::memory_order_release);
+        return id;
+    }
+
+    StagingBuffer& GetThreadBuffer() {
+        struct Holder {
+            ~Holder() {
+                if (buffer) {
+                    buffer->thread_exited = true;
+                }
+            }
+            std::shared_ptr<StagingBuffer> buffer;
+        };
+        thread_local Holder holder;
+
+        if (!holder.buffer) {
+            auto buffer = std::make_shared<StagingBuffer>();
+            std::lock_guard lock{registration_mutex};
+            buffer->thread_index = next_thread_index++;
+            buffers.push_back(buffer);
+            holder.buffer = std::move(buffer);
+        }
+        return *holder.buffer;
+    }
+
+    /**
+     * Waits for the writer thread to make room for a record in a full staging buffer, so that
+     * bursts of messages slow the logging thread down instead of being lost.
+     * @returns False if there is still no room after MaxBackpressureWait.
+     */
+    bool WaitForSpace(StagingBuffer& buffer, std::size_t size) {
+        const auto has_space = [&buffer, size] {
+            return buffer.ring.Capacity() - buffer.ring.Size() >= size;
+        };
+        if (has_space()) {
+            return true;
+        }
+        // After a wait timed out, don't wait again until the writer caught up, so that a stalled
+        // disk doesn't hold up every message
+        if (buffer.dropped.load(std::memory_order_relaxed) !=
+            buffer.dropped_reported.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        {
+            std::lock_guard lock{writer_mutex};
+            flush_requested = true;
+        }
+        writer_cv.notify_one();
+        const auto deadline = std::chrono::steady_clock::now() + MaxBackpressureWait;
+        while (!has_space()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    void WriterLoop() {
+        std::unique_lock lock{writer_mutex};
+        while (!stop_requested) {
+            writer_cv.wait_for(lock, FlushInterval,
+                               [this] { return stop_requested || flush_requested; });
+            flush_requested = false;
+            // The file is only written by this thread, so it is written without holding locks
+            lock.unlock();
+            WriteStagedMessages();
+            lock.lock();
+        }
+        // Messages staged during the last pass were left for the next one
+        lock.unlock();
+        WriteStagedMessages();
+    }
+
+    /// Writes everything that was logged so far to the file. Only called by the writer thread.
+    void WriteStagedMessages() {
+        // Take the new sites and the current buffers, so that registering sites and threads
+        // doesn't wait for the file to be written. The staged sizes are taken first: a message
+        // staged after that may belong to a site that is registered after the snapshot, and is
+        // left for the next pass.
+        {
+            std::lock_guard lock{registration_mutex};
+            current_buffers.assign(buffers.begin(), buffers.end());
+            staged_sizes.clear();
+            for (const auto& buffer : current_buffers) {
+                staged_sizes.push_back(buffer->ring.Size());
+            }
+            new_sites.assign(sites.begin() + sites_written, sites.end());
+            sites_written = sites.size();
+        }
+        for (const auto& site : new_sites) {
+            file.WriteBytes(site.data(), site.size());
+        }
+
+        bool buffers_exited = false;
+        for (std::size_t i = 0; i < current_buffers.size(); ++i) {
+            const auto& buffer = current_buffers[i];
+            // Read before popping, so that the last messages of a thread are not lost
+            const bool exited = buffer->thread_exited;
+
+            // Records are pushed whole, so the staged size ends on a record boundary
+            const std::size_t size = buffer->ring.Pop(scratch.data(), staged_sizes[i]);
+            file.WriteBytes(scratch.data(), size);
+
+            const u32 dropped = buffer->dropped.load(std::memory_order_relaxed);
+            const u32 dropped_reported = buffer->dropped_reported.load(std::memory_order_relaxed);
+            if (dropped != dropped_reported) {
+                RecordWriter<16> record(RecordType::Dropped);
+                record.Put(buffer->thread_index);
+                record.Put(dropped - dropped_reported);
+                const auto [data, record_size] = record.Finish();
+                file.WriteBytes(data, record_size);
+                LOG_WARNING(Log, "{} messages of thread {} did not fit into the binary log",
+                            dropped - dropped_reported, buffer->thread_index);
+                buffer->dropped_reported.store(dropped, std::memory_order_relaxed);
+            }
+
+            buffers_exited |= exited && buffer->ring.Size() == 0;
+        }
+        file.Flush();
+
+        if (buffers_exited) {
+            std::lock_guard lock{registration_mutex};
+            buffers.remove_if([](const std::shared_ptr<StagingBuffer>& buffer) {
+                return buffer->thread_exited && buffer->ring.Size() == 0;
+            });
+        }
+        current_buffers.clear();
+    }
+
+    std::atomic<bool> running{false};
+    std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+
+    std::mutex writer_mutex; ///< Protects the requests to the writer thread
+    std::condition_variable writer_cv;
+    bool stop_requested = false;
+    bool flush_requested = false;
+    std::thread writer_thread;
+
+    std::mutex registration_mutex; ///< Protects the sites and buffers, never held during I/O
+    /// Encoded site records. They are kept for the whole run, so that a restarted binary log can
+    /// describe sites that logged before.
+    std::vector<std::vector<u8>> sites;
+    std::list<std::shared_ptr<StagingBuffer>> buffers;
+    u16 next_thread_index = 0;
+
+    // Only used by the writer thread, or while it is not running
+    FileUtil::IOFile file;
+    std::size_t sites_written = 0;
+    std::vector<std::vector<u8>> new_sites;
+    std::vector<std::shared_ptr<StagingBuffer>> current_buffers;
+    std::vector<std::size_t> staged_sizes;
+    std::array<u8, StagingBufferSize> scratch;
+};
+
+/// An argument of a message in the binary log, to be formatted with its original format spec.
+struct DeferredArg {
+    std::variant<std::monostate, bool, char, s64, u64, float, double, fmt::string_view,
+                 const void*>
+        value;
+};
+
+} // Anonymous namespace
+
+} // namespace Log
+
+template <>
+struct fmt::formatter<Log::DeferredArg> {
+    // The type of the argument is only known when formatting, so the format spec is stored and
+    // parsed by the formatter of the actual type later.
+    fmt::string_view spec;
+
+    constexpr auto parse(fmt::format_parse_context& ctx) {
+        auto end = ctx.begin();
+        while (end != ctx.end() && *end != '}') {
+            ++end;
+        }
+        // Includes the closing brace, which the formatters of the actual types expect
+        spec = fmt::string_view(ctx.begin(), static_cast<std::size_t>(end - ctx.begin()) +
+                                                 (end != ctx.end() ? 1 : 0));
+        return end;
+    }
+
+    template <typename FormatContext>
+    auto format(const Log::DeferredArg& arg, FormatContext& ctx) {
+        return std::visit(
+            [this, &ctx](const auto& value) {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::monostate>) {
+                    return ctx.out();
+                } else {
+                    fmt::formatter<T> formatter;
+                    fmt::format_parse_context parse_ctx(spec);
+                    formatter.parse(parse_ctx);
+                    return formatter.format(value, ctx);
+                }
+            },
+            arg.value);
+    }
+};
+
+namespace Log {
+
+namespace {
+
+/// Reads values from a record, failing instead of reading past its end.
+class RecordReader {
+public:
+    RecordReader(const u8* data, std::size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool Get(T& value) {
+        if (size - position < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    bool GetString(std::string_view& str) {
+        u16 length;
+        if (!Get(length) || size - position < length) {
+            return false;
+        }
+        str = std::string_view(reinterpret_cast<const char*>(data + position), length);
+        position += length;
+        return true;
+    }
+
+    bool GetArg(DeferredArg& arg) {
+        u8 type;
+        if (!Get(type)) {
+            return false;
+        }
+        switch (static_cast<BinaryArgs::Type>(type)) {
+        case BinaryArgs::Type::Bool:
+            return GetValue<u8, bool>(arg);
+        case BinaryArgs::Type::Char:
+            return GetValue<char>(arg);
+        case BinaryArgs::Type::Signed:
+            return GetValue<s64>(arg);
+        case BinaryArgs::Type::Unsigned:
+            return GetValue<u64>(arg);
+        case BinaryArgs::Type::Float:
+            return GetValue<float>(arg);
+        case BinaryArgs::Type::Double:
+            return GetValue<double>(arg);
+        case BinaryArgs::Type::String: {
+            std::string_view str;
+            if (!GetString(str)) {
+                return false;
+            }
+            arg.value = fmt::string_view(str.data(), str.size());
+            return true;
+        }
+        case BinaryArgs::Type::Pointer: {
+            u64 pointer;
+            if (!Get(pointer)) {
+                return false;
+            }
+            arg.value = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(pointer));
+            return true;
+        }
+        }
+        return false;
+    }
+
+private:
+    template <typename Stored, typename T = Stored>
+    bool GetValue(DeferredArg& arg) {
+        Stored value;
+        if (!Get(value)) {
+            return false;
+        }
+        arg.value = static_cast<T>(value);
+        return true;
+    }
+
+    const u8* data;
+    std::size_t size;
+    std::size_t position = 0;
+};
+
+struct Site {
+    std::string filename;
+    unsigned int line_num;
+    std::string function;
+    std::string format;
+};
+
+template <std::size_t... I>
+std::string FormatDeferred(std::string_view format,
+                           const std::array<DeferredArg, BinaryArgs::MaxCount>& args,
+                           std::index_sequence<I...>) {
+    // Unused arguments are ignored by fmt, so all of them can always be passed
+    return fmt::vformat(fmt::string_view(format.data(), format.size()),
+                        fmt::make_format_args(args[I]...));
+}
+
+bool DecodeMessage(RecordReader& reader, const std::unordered_map<u32, Site>& sites,
+                   Entry& entry) {
+    u32 site_id;
+    u64 timestamp;
+    u16 thread;
+    u8 log_class;
+    u8 log_level;
+    u8 count;
+    if (!reader.Get(site_id) || !reader.Get(timestamp) || !reader.Get(thread) ||
+        !reader.Get(log_class) || !reader.Get(log_level) || !reader.Get(count) ||
+        log_class >= static_cast<u8>(Class::Count) || log_level >= static_cast<u8>(Level::Count)) {
+        return false;
+    }
+
+    const auto site = sites.find(site_id);
+    if (site == sites.end()) {
+        return false;
+    }
+
+    entry.timestamp = std::chrono::microseconds(timestamp);
+    entry.log_class = static_cast<Class>(log_class);
+    entry.log_level = static_cast<Level>(log_level);
+    entry.filename = site->second.filename;
+    entry.line_num = site->second.line_num;
+    entry.function = site->second.function;
+
+    if (count == BinaryArgs::Formatted) {
+        DeferredArg message;
+        if (!reader.GetArg(message) || !std::holds_alternative<fmt::string_view>(message.value)) {
+            return false;
+        }
+        const auto str = std::get<fmt::string_view>(message.value);
+        entry.message.assign(str.data(), str.size());
+        return true;
+    }
+
+    if (count > BinaryArgs::MaxCount) {
+        return false;
+    }
+    std::array<DeferredArg, BinaryArgs::MaxCount> args{};
+    for (std::size_t i = 0; i < count; ++i) {
+        if (!reader.GetArg(args[i])) {
+            return false;
+        }
+    }
+    try {
+        entry.message = FormatDeferred(site->second.format, args,
+                                       std::make_index_sequence<BinaryArgs::MaxCount>());
+    } catch (const fmt::format_error& error) {
+        entry.message = fmt::format("{} (could not format message: {})", site->second.format,
+                                    error.what());
+    }
+    return true;
+}
+
+} // Anonymous namespace
+
+bool StartBinaryLog(const std::string& path) {
+    return BinaryLogger::Instance().Start(path);
+}
+
+void StopBinaryLog() {
+    BinaryLogger::Instance().Stop();
+}
+
+bool IsBinaryLogRunning() {
+    return BinaryLogger::Instance().IsRunning();
+}
+
+void PushBinaryMessage(SourceSite& site, Class log_class, Level log_level, const char* filename,
+                       unsigned int line_num, const char* function, const char* format,
+                       const BinaryArgs& args) {
+    BinaryLogger::Instance().Push(site, log_class, log_level, filename, line_num, function, format,
+                                  args);
+}
+
+bool ReadBinaryLog(const std::string& path, const std::function<void(const Entry&)>& callback) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        return false;
+    }
+    std::vector<u8> data(file.GetSize());
+    if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+        return false;
+    }
+
+    RecordReader header(data.data(), data.size());
+    u32 magic;
+    u32 version;
+    if (!header.Get(magic) || !header.Get(version) || magic != BinaryLogMagic ||
+        version != BinaryLogVersion) {
+        return false;
+    }
+
+    std::unordered_map<u32, Site> sites;
+    Entry entry;
+    std::size_t position = 2 * sizeof(u32);
+    while (data.size() - position >= 3) {
+        const auto type = static_cast<RecordType>(data[position]);
+        u16 size;
+        std::memcpy(&size, &data[position + 1], sizeof(size));
+        position += 3;
+        if (data.size() - position < size) {
+            break;
+        }
+        RecordReader reader(&data[position], size);
+        position += size;
+
+        switch (type) {
+        case RecordType::Site: {
+            u32 id;
+            u32 line_num;
+            std::string_view filename;
+            std::string_view function;
+            std::string_view format;
+            if (reader.Get(id) && reader.Get(line_num) && reader.GetString(filename) &&
+                reader.GetString(function) && reader.GetString(format)) {
+                sites[id] = Site{std::string(filename), line_num, std::string(function),
+                                 std::string(format)};
+            }
+            break;
+        }
+        case RecordType::Message:
+            if (DecodeMessage(reader, sites, entry)) {
+                callback(entry);
+            }
+            break;
+        case RecordType::Dropped: {
+            u16 thread;
+            u32 count;
+            if (reader.Get(thread) && reader.Get(count)) {
+                entry.log_class = Class::Log;
+                entry.log_level = Level::Warning;
+                entry.filename.clear();
+                entry.line_num = 0;
+                entry.function.clear();
+                entry.message =
+                    fmt::format("{} messages of thread {} were dropped", count, thread);
+                callback(entry);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+} // namespace Log
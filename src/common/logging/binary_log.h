@@ -0,0 +1,40 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace Log {
+
+struct Entry;
+
+/**
+ * Starts writing log messages to a binary file. Each thread stages its messages in its own buffer
+ * without taking locks, and the arguments of most messages are stored without being formatted.
+ * A thread whose buffer is full waits briefly for it to be written out, and messages that still
+ * don't fit are dropped and reported with a warning. While the binary log is running, messages
+ * below Warning are not passed to the backends.
+ * @param path The file to write to. It is overwritten if it exists.
+ * @returns Whether the file could be opened.
+ */
+bool StartBinaryLog(const std::string& path);
+
+/// Writes out the remaining messages and closes the binary log.
+void StopBinaryLog();
+
+/// Returns whether messages are currently written to the binary log.
+bool IsBinaryLogRunning();
+
+/**
+ * Decodes a binary log file.
+ * @param path The file to read.
+ * @param callback Called with every message in the file. Messages of different threads are
+ *                 roughly, but not exactly, in chronological order.
+ * @returns False if the file could not be read or is not a binary log.
+ */
+bool ReadBinaryLog(const std::string& path, const std::function<void(const Entry&)>& callback);
+
+} // namespace Log
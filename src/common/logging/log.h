@@ -4,6 +4,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
 #include <fmt/format.h>
 #include "common/common_types.h"
 
@@ -104,6 +112,171 @@ enum class Class : ClassType {
     Count              ///< Total number of logging classes
 };
 
+/**
+ * Returns the length of the part of a source file path up to and including the last "src/" or
+ * "../", which is left out of log messages.
+ */
+constexpr std::size_t TrimmedSourcePathLength(std::string_view path) {
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < path.size(); ++i) {
+        if (i != 0 && path[i - 1] != '/' && path[i - 1] != '\\') {
+            continue;
+        }
+        const std::string_view rest = path.substr(i);
+        std::size_t dir_length = 0;
+        if (rest.substr(0, 3) == "src") {
+            dir_length = 3;
+        } else if (rest.substr(0, 2) == "..") {
+            dir_length = 2;
+        }
+        if (dir_length != 0 && dir_length < rest.size() &&
+            (rest[dir_length] == '/' || rest[dir_length] == '\\')) {
+            length = i + dir_length + 1;
+        }
+    }
+    return length;
+}
+
+/**
+ * A place in the source code that logs messages. The binary log refers to the location of a
+ * message by the ID of its site, which is assigned the first time the site logs a message.
+ */
+struct SourceSite {
+    std::atomic<u32> id{0};
+};
+
+/// Outputs that a message with a given class and level is written to.
+struct MessageOutputs {
+    bool text = false;   ///< The message is formatted immediately and passed to the backends
+    bool binary = false; ///< The message is written to the binary log
+};
+
+/// Returns where a message with the given class and level should be written to.
+MessageOutputs GetMessageOutputs(Class log_class, Level log_level);
+
+/**
+ * The arguments of a message in the binary log. Arguments are stored in a compact form and only
+ * formatted when the binary log is decoded.
+ */
+class BinaryArgs {
+public:
+    /// Maximum size of the serialized arguments of a message.
+    static constexpr std::size_t MaxSize = 1024;
+    /// Maximum number of arguments of a message.
+    static constexpr std::size_t MaxCount = 16;
+    /// Argument count that marks a message that was already formatted when it was logged.
+    static constexpr u8 Formatted = 0xFF;
+
+    enum class Type : u8 {
+        Bool,
+        Char,
+        Signed,
+        Unsigned,
+        Float,
+        Double,
+        String,
+        Pointer,
+    };
+
+    /// Whether arguments of type T can be stored. Messages with other arguments are formatted
+    /// when they are logged.
+    template <typename T, typename U = std::decay_t<T>>
+    static constexpr bool IsSupported =
+        (std::is_arithmetic_v<U> && !std::is_same_v<U, long double> &&
+         !std::is_same_v<U, wchar_t> && !std::is_same_v<U, char16_t> &&
+         !std::is_same_v<U, char32_t>) ||
+        std::is_same_v<U, const char*> || std::is_same_v<U, char*> ||
+        std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view> ||
+        std::is_same_v<U, const void*> || std::is_same_v<U, void*>;
+
+    template <typename T>
+    void Add(const T& value) {
+        using U = std::decay_t<T>;
+        if constexpr (std::is_same_v<U, bool>) {
+            Put(Type::Bool, static_cast<u8>(value));
+        } else if constexpr (std::is_same_v<U, char>) {
+            Put(Type::Char, value);
+        } else if constexpr (std::is_same_v<U, float>) {
+            Put(Type::Float, value);
+        } else if constexpr (std::is_floating_point_v<U>) {
+            Put(Type::Double, static_cast<double>(value));
+        } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+            Put(Type::Signed, static_cast<s64>(value));
+        } else if constexpr (std::is_integral_v<U>) {
+            Put(Type::Unsigned, static_cast<u64>(value));
+        } else if constexpr (std::is_pointer_v<U> && !std::is_same_v<U, const char*> &&
+                             !std::is_same_v<U, char*>) {
+            Put(Type::Pointer, static_cast<u64>(reinterpret_cast<std::uintptr_t>(value)));
+        } else {
+            PutString(Type::String, std::string_view(value));
+        }
+        ++count;
+    }
+
+    /// Replaces the arguments by the formatted message.
+    void SetFormatted(std::string_view message) {
+        size = 0;
+        overflow = false;
+        PutString(Type::String, message);
+        count = Formatted;
+    }
+
+    /// Whether all arguments fit.
+    bool IsComplete(std::size_t num_args) const {
+        return !overflow && count == num_args;
+    }
+
+    const u8* Data() const {
+        return data.data();
+    }
+    std::size_t Size() const {
+        return size;
+    }
+    u8 Count() const {
+        return count;
+    }
+
+private:
+    template <typename T>
+    void Put(Type type, const T& value) {
+        if (size + 1 + sizeof(T) > MaxSize) {
+            overflow = true;
+            return;
+        }
+        data[size++] = static_cast<u8>(type);
+        std::memcpy(data.data() + size, &value, sizeof(T));
+        size += sizeof(T);
+    }
+
+    void PutString(Type type, std::string_view str) {
+        if (size + 1 + sizeof(u16) > MaxSize) {
+            overflow = true;
+            return;
+        }
+        // Long strings are cut off rather than falling back to formatting the message
+        const u16 length = static_cast<u16>(std::min(str.size(), MaxSize - size - 1 - sizeof(u16)));
+        data[size++] = static_cast<u8>(type);
+        std::memcpy(data.data() + size, &length, sizeof(length));
+        size += sizeof(length);
+        std::memcpy(data.data() + size, str.data(), length);
+        size += length;
+    }
+
+    std::array<u8, MaxSize> data;
+    std::size_t size = 0;
+    u8 count = 0;
+    bool overflow = false;
+};
+
+/// Writes a message to the global logger without checking the filter, using fmt
+void PushTextMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                     const char* function, const char* format, const fmt::format_args& args);
+
+/// Writes a message to the binary log without checking the filter
+void PushBinaryMessage(SourceSite& site, Class log_class, Level log_level, const char* filename,
+                       unsigned int line_num, const char* function, const char* format,
+                       const BinaryArgs& args);
+
 /// Logs a message to the global logger, using fmt
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
@@ -116,32 +289,66 @@ void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsig
                       fmt::make_format_args(args...));
 }
 
+/**
+ * Logs a message from a fixed source location. Messages that go to the binary log are formatted
+ * when the log is decoded rather than here, if all arguments can be stored.
+ */
+template <typename... Args>
+void FmtLogMessage(SourceSite& site, Class log_class, Level log_level, const char* filename,
+                   unsigned int line_num, const char* function, const char* format,
+                   const Args&... args) {
+    const MessageOutputs outputs = GetMessageOutputs(log_class, log_level);
+    if (outputs.binary) {
+        BinaryArgs binary_args;
+        if constexpr (sizeof...(Args) <= BinaryArgs::MaxCount &&
+                      (BinaryArgs::IsSupported<Args> && ...)) {
+            (binary_args.Add(args), ...);
+        }
+        if (!binary_args.IsComplete(sizeof...(Args))) {
+            binary_args.SetFormatted(fmt::vformat(format, fmt::make_format_args(args...)));
+        }
+        PushBinaryMessage(site, log_class, log_level, filename, line_num, function, format,
+                          binary_args);
+    }
+    if (outputs.text) {
+        PushTextMessage(log_class, log_level, filename, line_num, function, format,
+                        fmt::make_format_args(args...));
+    }
+}
+
 } // namespace Log
 
+/// The path of the current source file, relative to the source directory.
+#define LOG_SOURCE_FILE                                                                            \
+    (__FILE__ + std::integral_constant<std::size_t,                                                \
+                                       ::Log::TrimmedSourcePathLength(__FILE__)>::value)
+
+/// Returns a SourceSite that is unique to the place where this macro is used.
+#define LOG_SOURCE_SITE                                                                            \
+    ([]() -> ::Log::SourceSite& {                                                                  \
+        static ::Log::SourceSite site;                                                             \
+        return site;                                                                               \
+    }())
+
 // Define the fmt lib macros
 #define LOG_GENERIC(log_class, log_level, ...)                                                     \
-    ::Log::FmtLogMessage(log_class, log_level, __FILE__, __LINE__, __func__, __VA_ARGS__)
+    ::Log::FmtLogMessage(LOG_SOURCE_SITE, log_class, log_level, LOG_SOURCE_FILE, __LINE__,         \
+                         __func__, __VA_ARGS__)
 
 #ifdef _DEBUG
 #define LOG_TRACE(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Trace, __FILE__, __LINE__,         \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Trace, __VA_ARGS__)
 #else
 #define LOG_TRACE(log_class, fmt, ...) (void(0))
 #endif
 
 #define LOG_DEBUG(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Debug, __FILE__, __LINE__,         \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Debug, __VA_ARGS__)
 #define LOG_INFO(log_class, ...)                                                                   \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Info, __FILE__, __LINE__,          \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Info, __VA_ARGS__)
 #define LOG_WARNING(log_class, ...)                                                                \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Warning, __FILE__, __LINE__,       \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Warning, __VA_ARGS__)
 #define LOG_ERROR(log_class, ...)                                                                  \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Error, __FILE__, __LINE__,         \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Error, __VA_ARGS__)
 #define LOG_CRITICAL(log_class, ...)                                                               \
-    ::Log::FmtLogMessage(::Log::Class::log_class, ::Log::Level::Critical, __FILE__, __LINE__,      \
-                         __func__, __VA_ARGS__)
+    LOG_GENERIC(::Log::Class::log_class, ::Log::Level::Critical, __VA_ARGS__)
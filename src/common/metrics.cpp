@@ -0,0 +1,213 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <fmt/format.h>
+#include "common/assert.h"
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/metrics.h"
+#include "common/thread.h"
+
+namespace Common::Metrics {
+
+namespace {
+
+bool IsValidName(const std::string& name) {
+    if (name.empty() || (name[0] >= '0' && name[0] <= '9')) {
+        return false;
+    }
+    for (const char c : name) {
+        const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                           (c >= '0' && c <= '9') || c == '_' || c == ':';
+        if (!valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string EscapeHelp(const std::string& help) {
+    std::string escaped;
+    escaped.reserve(help.size());
+    for (const char c : help) {
+        if (c == '\\') {
+            escaped += "\\\\";
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string FormatValue(double value) {
+    if (std::isnan(value)) {
+        return "NaN";
+    }
+    if (std::isinf(value)) {
+        return value > 0 ? "+Inf" : "-Inf";
+    }
+    return fmt::format("{}", value);
+}
+
+class Registry {
+public:
+    static Registry& Instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    Counter& GetCounter(const std::string& name, const std::string& help) {
+        std::lock_guard lock{mutex};
+        Metric& metric = GetMetric(name, help, Type::Counter);
+        return *metric.counter;
+    }
+
+    Gauge& GetGauge(const std::string& name, const std::string& help) {
+        std::lock_guard lock{mutex};
+        Metric& metric = GetMetric(name, help, Type::Gauge);
+        return *metric.gauge;
+    }
+
+    Summary& GetSummary(const std::string& name, const std::string& help) {
+        std::lock_guard lock{mutex};
+        Metric& metric = GetMetric(name, help, Type::Summary);
+        return *metric.summary;
+    }
+
+    std::string ExportText() {
+        std::lock_guard lock{mutex};
+        std::string text;
+        for (const auto& [name, metric] : metrics) {
+            text += fmt::format("# HELP {} {}\n", name, EscapeHelp(metric.help));
+            switch (metric.type) {
+            case Type::Counter:
+                text += fmt::format("# TYPE {} counter\n", name);
+                text += fmt::format("{} {}\n", name, metric.counter->Get());
+                break;
+            case Type::Gauge:
+                text += fmt::format("# TYPE {} gauge\n", name);
+                text += fmt::format("{} {}\n", name, FormatValue(metric.gauge->Get()));
+                break;
+            case Type::Summary:
+                text += fmt::format("# TYPE {} summary\n", name);
+                text += fmt::format("{}_sum {}\n", name, FormatValue(metric.summary->GetSum()));
+                text += fmt::format("{}_count {}\n", name, metric.summary->GetCount());
+                break;
+            }
+        }
+        return text;
+    }
+
+private:
+    enum class Type { Counter, Gauge, Summary };
+
+    struct Metric {
+        Type type;
+        std::string help;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Summary> summary;
+    };
+
+    /// Finds or creates a metric. `mutex` must be held.
+    Metric& GetMetric(const std::string& name, const std::string& help, Type type) {
+        ASSERT_MSG(IsValidName(name), "Invalid metric name {}", name);
+        auto [iter, inserted] = metrics.try_emplace(name);
+        Metric& metric = iter->second;
+        if (inserted) {
+            metric.type = type;
+            metric.help = help;
+            switch (type) {
+            case Type::Counter:
+                metric.counter = std::make_unique<Counter>();
+                break;
+            case Type::Gauge:
+                metric.gauge = std::make_unique<Gauge>();
+                break;
+            case Type::Summary:
+                metric.summary = std::make_unique<Summary>();
+                break;
+            }
+        }
+        ASSERT_MSG(metric.type == type, "Metric {} registered with two types", name);
+        return metric;
+    }
+
+    std::mutex mutex;
+    /// Sorted by name, so that exports are stable
+    std::map<std::string, Metric> metrics;
+};
+
+} // Anonymous namespace
+
+Counter& GetCounter(const std::string& name, const std::string& help) {
+    return Registry::Instance().GetCounter(name, help);
+}
+
+Gauge& GetGauge(const std::string& name, const std::string& help) {
+    return Registry::Instance().GetGauge(name, help);
+}
+
+Summary& GetSummary(const std::string& name, const std::string& help) {
+    return Registry::Instance().GetSummary(name, help);
+}
+
+std::string ExportText() {
+    return Registry::Instance().ExportText();
+}
+
+class FileExporter::Impl {
+public:
+    Impl(std::string path_, std::chrono::milliseconds interval)
+        : path(std::move(path_)), temporary_path(path + ".tmp") {
+        thread = std::thread([this, interval] {
+            auto next_export = std::chrono::steady_clock::now();
+            do {
+                Export();
+                next_export += interval;
+            } while (!stop_event.WaitUntil(next_export));
+            Export();
+        });
+    }
+
+    ~Impl() {
+        stop_event.Set();
+        thread.join();
+        FileUtil::Delete(temporary_path);
+    }
+
+private:
+    void Export() {
+        const std::string text = ExportText();
+        // The exposition format uses \n line endings, which text mode would change on Windows
+        if (FileUtil::WriteStringToFile(false, temporary_path, text) != text.size()) {
+            LOG_ERROR(Common, "Could not write the metrics to {}", temporary_path);
+            return;
+        }
+        // Renaming over an existing file fails on Windows
+        if (!FileUtil::Rename(temporary_path, path) &&
+            !(FileUtil::Delete(path) && FileUtil::Rename(temporary_path, path))) {
+            LOG_ERROR(Common, "Could not replace {} with the metrics", path);
+        }
+    }
+
+    std::string path;
+    std::string temporary_path;
+    Common::Event stop_event;
+    std::thread thread;
+};
+
+FileExporter::FileExporter(std::string path, std::chrono::milliseconds interval)
+    : impl(std::make_unique<Impl>(std::move(path), interval)) {}
+
+FileExporter::~FileExporter() = default;
+
+} // namespace Common::Metrics
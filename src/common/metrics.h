@@ -0,0 +1,120 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * A registry of live counters, gauges and summaries that subsystems update as they run, such as frames,
+ * cache hits or IPC requests. The metrics can be exported in the Prometheus text exposition
+ * format, so that a scraper can follow a running emulator.
+ */
+namespace Common::Metrics {
+
+/// A value that only goes up, such as a number of events. Can be updated from any thread.
+class Counter {
+public:
+    void Increment(u64 amount = 1) {
+        value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    u64 Get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<u64> value{0};
+};
+
+/// A value that can go up and down, such as a size or a ratio. Can be updated from any thread.
+class Gauge {
+public:
+    void Set(double new_value) {
+        value.store(new_value, std::memory_order_relaxed);
+    }
+
+    void Add(double amount) {
+        double current = value.load(std::memory_order_relaxed);
+        while (!value.compare_exchange_weak(current, current + amount,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    double Get() const {
+        return value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> value{0.0};
+};
+
+/**
+ * The sum and the number of observed values, such as the durations of requests. Exported as a
+ * Prometheus summary without quantiles, so that rates of both can be divided to get the average.
+ * Can be updated from any thread.
+ */
+class Summary {
+public:
+    void Observe(double value) {
+        sum.Add(value);
+        count.Increment();
+    }
+
+    double GetSum() const {
+        return sum.Get();
+    }
+
+    u64 GetCount() const {
+        return count.Get();
+    }
+
+private:
+    Gauge sum;
+    Counter count;
+};
+
+/**
+ * Returns the counter with the given name, registering it on the first call. Metrics are never
+ * unregistered, so the reference can be kept, usually in a function-local static.
+ * @param name Name of the metric, which must match [a-zA-Z_:][a-zA-Z0-9_:]*
+ * @param help Description of the metric
+ */
+Counter& GetCounter(const std::string& name, const std::string& help);
+
+/// Returns the gauge with the given name, registering it on the first call. See GetCounter.
+Gauge& GetGauge(const std::string& name, const std::string& help);
+
+/**
+ * Returns the summary with the given name, registering it on the first call. See GetCounter. The
+ * exported samples are suffixed with _sum and _count.
+ */
+Summary& GetSummary(const std::string& name, const std::string& help);
+
+/// Returns the current value of all metrics in the Prometheus text exposition format.
+std::string ExportText();
+
+/**
+ * Writes the metrics to a file at a fixed interval from a background thread, for example for the
+ * textfile collector of the Prometheus node exporter. The file is replaced atomically, so readers
+ * never see a partial export.
+ */
+class FileExporter {
+public:
+    FileExporter(std::string path, std::chrono::milliseconds interval);
+    ~FileExporter();
+
+    FileExporter(const FileExporter&) = delete;
+    FileExporter& operator=(const FileExporter&) = delete;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Common::Metrics
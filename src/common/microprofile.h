@@ -21,9 +21,36 @@ typedef void* HANDLE;
 #endif
 
 #include <microprofile.h>
+#include "common/trace.h"
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
 
+// Record the CPU scopes in Common::Trace as well, so that they can be looked at without the Qt
+// MicroProfile dialog.
+#undef MICROPROFILE_DECLARE
+#undef MICROPROFILE_DEFINE
+#undef MICROPROFILE_SCOPE
+#define MP_TRACE_PASTE0(a, b) a##b
+#define MP_TRACE_PASTE(a, b) MP_TRACE_PASTE0(a, b)
+#if MICROPROFILE_ENABLED
+#define MICROPROFILE_DECLARE(var)                                                                  \
+    extern MicroProfileToken g_mp_##var;                                                           \
+    extern ::Common::Trace::Category g_trace_##var
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    ::Common::Trace::Category g_trace_##var{group, name};                                          \
+    MicroProfileToken g_mp_##var =                                                                 \
+        MicroProfileGetToken(group, name, color, MicroProfileTokenTypeCpu)
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    MicroProfileScopeHandler MP_TRACE_PASTE(foo, __LINE__)(g_mp_##var);                            \
+    ::Common::Trace::ScopedEvent MP_TRACE_PASTE(trace, __LINE__)(g_trace_##var)
+#else
+#define MICROPROFILE_DECLARE(var) extern ::Common::Trace::Category g_trace_##var
+#define MICROPROFILE_DEFINE(var, group, name, color)                                               \
+    ::Common::Trace::Category g_trace_##var{group, name}
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    ::Common::Trace::ScopedEvent MP_TRACE_PASTE(trace, __LINE__)(g_trace_##var)
+#endif
+
 // On OS X, some Mach header included by MicroProfile defines these as macros, conflicting with
 // identifiers we use.
 #ifdef PAGE_SIZE
@@ -12,6 +12,20 @@
 
 #include "common/common_funcs.h"
 
+#ifndef _WIN32
+namespace {
+// XSI-compliant strerror_r
+[[maybe_unused]] const char* StrErrorResult(int result, const char* buffer) {
+    return result == 0 ? buffer : "Unknown error";
+}
+
+// GNU-specific strerror_r
+[[maybe_unused]] const char* StrErrorResult(const char* result, const char*) {
+    return result;
+}
+} // Anonymous namespace
+#endif
+
 // Generic function to get last error message.
 // Call directly after the command or use the error num.
 // This function might change the error code.
@@ -20,12 +34,14 @@ std::string GetLastErrorMsg() {
     char err_str[buff_size];
 
 #ifdef _WIN32
-    FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM, nullptr, GetLastError(),
-                   MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), err_str, buff_size, nullptr);
+    if (FormatMessageA(FORMAT_MESSAGE_FROM_SYSTEM, nullptr, GetLastError(),
+                       MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), err_str, buff_size,
+                       nullptr) == 0) {
+        return "Unknown error";
+    }
+    return err_str;
 #else
-    // Thread safe (XSI-compliant)
-    strerror_r(errno, err_str, buff_size);
+    // Thread safe. The GNU version may return a static string instead of filling err_str.
+    return StrErrorResult(strerror_r(errno, err_str, buff_size), err_str);
 #endif
-
-    return std::string(err_str, buff_size);
 }
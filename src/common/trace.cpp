@@ -0,0 +1,361 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/trace.h"
+
+namespace Common::Trace {
+
+namespace {
+
+/// Set by RequestDump. A plain global, so that it can be set from signal handlers.
+std::atomic<bool> dump_requested{false};
+
+/// Minimum time between two automatic dumps, so that a stuttering game does not flood the disk.
+constexpr auto AutomaticDumpInterval = std::chrono::seconds(10);
+
+struct Event {
+    const char* group;
+    const char* name;
+    u64 start_ns;
+    u64 end_ns;
+};
+
+/// The most recent events of a thread.
+struct ThreadEvents {
+    std::mutex mutex; ///< Only contended while a dump is taken
+    std::vector<Event> events;
+    std::size_t next = 0;
+    bool wrapped = false;
+    u32 thread_id = 0;
+    std::string name;
+    bool thread_exited = false;
+    u64 frame_start = 0;
+};
+
+/// Everything needed to write a dump, taken on the recording thread.
+struct Snapshot {
+    std::vector<std::pair<u32, std::string>> thread_names;
+    std::vector<std::pair<u32, Event>> events;
+};
+
+class Recorder {
+public:
+    static Recorder& Instance() {
+        static Recorder recorder;
+        return recorder;
+    }
+
+    void Enable(std::size_t events_per_thread_, std::chrono::milliseconds slow_frame_threshold_,
+                const std::string& dump_directory_) {
+        std::lock_guard lock{mutex};
+        slow_frame_threshold = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(slow_frame_threshold_).count());
+        dump_directory = dump_directory_;
+        // The settings are applied again whenever they change, which must not drop the events
+        const std::size_t size = std::max<std::size_t>(events_per_thread_, 1);
+        if (detail::enabled && size == events_per_thread) {
+            return;
+        }
+        events_per_thread = size;
+        ClearEvents();
+        detail::enabled = true;
+    }
+
+    void Disable() {
+        detail::enabled = false;
+        std::lock_guard lock{mutex};
+        ClearEvents();
+        JoinDumpThread();
+    }
+
+    u64 Now() const {
+        // Never zero, which ScopedEvent uses to mark events that started while disabled
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - time_origin)
+                                    .count()) +
+               1;
+    }
+
+    void Record(const char* group, const char* name, u64 start_ns, u64 end_ns) {
+        ThreadEvents& thread = GetThreadEvents();
+        std::lock_guard lock{thread.mutex};
+        thread.events[thread.next] = {group, name, start_ns, end_ns};
+        if (++thread.next == thread.events.size()) {
+            thread.next = 0;
+            thread.wrapped = true;
+        }
+    }
+
+    void SetThreadName(const std::string& name) {
+        ThreadEvents& thread = GetThreadEvents();
+        std::lock_guard lock{thread.mutex};
+        thread.name = name;
+    }
+
+    void BeginFrame() {
+        ThreadEvents& thread = GetThreadEvents();
+        thread.frame_start = Now();
+    }
+
+    void EndFrame() {
+        ThreadEvents& thread = GetThreadEvents();
+        const u64 frame_end = Now();
+        if (thread.frame_start == 0) {
+            return;
+        }
+        Record("Frame", "Frame", thread.frame_start, frame_end);
+
+        const bool requested = dump_requested.exchange(false);
+        const bool slow = slow_frame_threshold != 0 &&
+                          frame_end - thread.frame_start > slow_frame_threshold &&
+                          std::chrono::steady_clock::now() - last_automatic_dump >
+                              AutomaticDumpInterval;
+        if (!requested && !slow) {
+            return;
+        }
+        // Waiting for the previous dump would stall this thread, so a new one is only started
+        // once it is written. Requested dumps are taken at the end of a later frame instead.
+        if (dump_running) {
+            if (requested) {
+                dump_requested = true;
+            }
+            return;
+        }
+        if (slow) {
+            last_automatic_dump = std::chrono::steady_clock::now();
+            LOG_WARNING(Common, "Frame took {:.2f} ms, dumping trace",
+                        (frame_end - thread.frame_start) / 1e6);
+        }
+
+        // The events are copied here, so that the dump shows the state at the end of this frame,
+        // but written on another thread to not make the next frames slow as well.
+        std::lock_guard lock{mutex};
+        JoinDumpThread(); // Already done writing
+        const std::string path =
+            fmt::format("{}citra_trace_{}.json", dump_directory, dump_count++);
+        dump_running = true;
+        dump_thread = std::thread([this, path, snapshot = TakeSnapshot()] {
+            if (WriteSnapshot(path, snapshot)) {
+                LOG_INFO(Common, "Wrote trace to {}", path);
+            }
+            dump_running = false;
+        });
+    }
+
+    bool Dump(const std::string& path) {
+        Snapshot snapshot;
+        {
+            std::lock_guard lock{mutex};
+            snapshot = TakeSnapshot();
+        }
+        return WriteSnapshot(path, snapshot);
+    }
+
+private:
+    Recorder() = default;
+
+    ~Recorder() {
+        std::lock_guard lock{mutex};
+        JoinDumpThread();
+    }
+
+    ThreadEvents& GetThreadEvents() {
+        struct Holder {
+            ~Holder() {
+                if (events) {
+                    std::lock_guard lock{events->mutex};
+                    events->thread_exited = true;
+                }
+            }
+            std::shared_ptr<ThreadEvents> events;
+            u64 generation = 0;
+        };
+        thread_local Holder holder;
+
+        if (!holder.events || holder.generation != generation) {
+            std::lock_guard lock{mutex};
+            if (!holder.events) {
+                holder.events = std::make_shared<ThreadEvents>();
+                holder.events->thread_id = next_thread_id++;
+                threads.push_back(holder.events);
+            }
+            std::lock_guard thread_lock{holder.events->mutex};
+            holder.events->events.assign(events_per_thread, Event{});
+            holder.events->next = 0;
+            holder.events->wrapped = false;
+            holder.generation = generation;
+        }
+        return *holder.events;
+    }
+
+    /// Copies the recorded events. `mutex` must be held.
+    Snapshot TakeSnapshot() {
+        Snapshot snapshot;
+        for (auto it = threads.begin(); it != threads.end();) {
+            ThreadEvents& thread = **it;
+            std::lock_guard lock{thread.mutex};
+            snapshot.thread_names.emplace_back(
+                thread.thread_id,
+                thread.name.empty() ? fmt::format("Thread {}", thread.thread_id) : thread.name);
+            const std::size_t count = thread.wrapped ? thread.events.size() : thread.next;
+            const std::size_t first = thread.wrapped ? thread.next : 0;
+            for (std::size_t i = 0; i < count; ++i) {
+                snapshot.events.emplace_back(thread.thread_id,
+                                             thread.events[(first + i) % thread.events.size()]);
+            }
+            if (thread.thread_exited) {
+                it = threads.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return snapshot;
+    }
+
+    static void WriteEscaped(std::string& out, std::string_view str) {
+        for (const char c : str) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out += fmt::format("\\u{:04x}", c);
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    static bool WriteSnapshot(const std::string& path, const Snapshot& snapshot) {
+        FileUtil::IOFile file(path, "w");
+        if (!file.IsOpen()) {
+            LOG_ERROR(Common, "Could not open {} to write the trace", path);
+            return false;
+        }
+
+        std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        const auto separate = [&out, &first] {
+            if (!first) {
+                out += ",\n";
+            }
+            first = false;
+        };
+        for (const auto& [thread_id, name] : snapshot.thread_names) {
+            separate();
+            out += fmt::format("{{\"ph\":\"M\",\"pid\":1,\"tid\":{},\"name\":\"thread_name\","
+                               "\"args\":{{\"name\":\"",
+                               thread_id);
+            WriteEscaped(out, name);
+            out += "\"}}";
+        }
+        for (const auto& [thread_id, event] : snapshot.events) {
+            separate();
+            out += "{\"ph\":\"X\",\"pid\":1,\"tid\":";
+            out += std::to_string(thread_id);
+            out += ",\"cat\":\"";
+            WriteEscaped(out, event.group);
+            out += "\",\"name\":\"";
+            WriteEscaped(out, event.name);
+            out += fmt::format("\",\"ts\":{:.3f},\"dur\":{:.3f}}}", event.start_ns / 1e3,
+                               (event.end_ns - event.start_ns) / 1e3);
+            if (out.size() > 0x100000) {
+                file.WriteString(out);
+                out.clear();
+            }
+        }
+        out += "\n]}\n";
+        file.WriteString(out);
+        return file.IsGood();
+    }
+
+    /// Drops the events of every thread. `mutex` must be held.
+    void ClearEvents() {
+        ++generation;
+        for (const auto& thread : threads) {
+            std::lock_guard thread_lock{thread->mutex};
+            thread->next = 0;
+            thread->wrapped = false;
+        }
+    }
+
+    /// Waits for the previous automatic dump to be written. `mutex` must be held.
+    void JoinDumpThread() {
+        if (dump_thread.joinable()) {
+            dump_thread.join();
+        }
+    }
+
+    const std::chrono::steady_clock::time_point time_origin = std::chrono::steady_clock::now();
+    /// Changed whenever recording is enabled or disabled, to reset the events of every thread.
+    std::atomic<u64> generation{0};
+    std::atomic<u64> slow_frame_threshold{0};
+    /// Whether the dump thread is still writing
+    std::atomic<bool> dump_running{false};
+    // Only accessed by the thread that marks frames
+    std::chrono::steady_clock::time_point last_automatic_dump;
+    u32 dump_count = 0;
+
+    std::mutex mutex; ///< Protects the data below
+    std::size_t events_per_thread = 1;
+    std::string dump_directory;
+    std::list<std::shared_ptr<ThreadEvents>> threads;
+    u32 next_thread_id = 1;
+    std::thread dump_thread;
+};
+
+} // Anonymous namespace
+
+void Enable(std::size_t events_per_thread, std::chrono::milliseconds slow_frame_threshold,
+            const std::string& dump_directory) {
+    Recorder::Instance().Enable(events_per_thread, slow_frame_threshold, dump_directory);
+}
+
+void Disable() {
+    Recorder::Instance().Disable();
+}
+
+u64 Now() {
+    return Recorder::Instance().Now();
+}
+
+void RecordEvent(const char* group, const char* name, u64 start_ns, u64 end_ns) {
+    if (IsEnabled()) {
+        Recorder::Instance().Record(group, name, start_ns, end_ns);
+    }
+}
+
+void SetThreadName(const std::string& name) {
+    Recorder::Instance().SetThreadName(name);
+}
+
+void BeginFrame() {
+    if (IsEnabled()) {
+        Recorder::Instance().BeginFrame();
+    }
+}
+
+void EndFrame() {
+    if (IsEnabled()) {
+        Recorder::Instance().EndFrame();
+    }
+}
+
+void RequestDump() {
+    dump_requested = true;
+}
+
+bool Dump(const std::string& path) {
+    return Recorder::Instance().Dump(path);
+}
+
+} // namespace Common::Trace
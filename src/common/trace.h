@@ -0,0 +1,97 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include "common/common_types.h"
+
+/**
+ * A flight recorder for timed events, such as MicroProfile scopes, HLE requests and frames. Each
+ * thread keeps its most recent events in a ring buffer. The events can be written out as a Chrome
+ * trace (which Perfetto and chrome://tracing can open) on request or when a frame is slow.
+ */
+namespace Common::Trace {
+
+/// A kind of event. Names must outlive the recorder, so they are usually string literals.
+struct Category {
+    const char* group;
+    const char* name;
+};
+
+namespace detail {
+inline std::atomic<bool> enabled{false};
+} // namespace detail
+
+/**
+ * Starts recording events. Enabling again with the same number of events per thread only updates
+ * the other parameters and keeps the recorded events.
+ * @param events_per_thread Number of events kept for each thread.
+ * @param slow_frame_threshold Frames that take longer than this are dumped automatically.
+ *                             Zero disables automatic dumps.
+ * @param dump_directory Directory for automatic and requested dumps.
+ */
+void Enable(std::size_t events_per_thread, std::chrono::milliseconds slow_frame_threshold,
+            const std::string& dump_directory);
+
+/// Stops recording events and drops the recorded ones.
+void Disable();
+
+inline bool IsEnabled() {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// Returns the current time of the trace clock in nanoseconds.
+u64 Now();
+
+/// Records an event that started and ended at the given times of the trace clock.
+void RecordEvent(const char* group, const char* name, u64 start_ns, u64 end_ns);
+
+/// Names the calling thread in the trace.
+void SetThreadName(const std::string& name);
+
+/// Marks the start of a frame on the calling thread.
+void BeginFrame();
+
+/**
+ * Marks the end of a frame. Writes out a dump if the frame was slow or a dump was requested.
+ */
+void EndFrame();
+
+/**
+ * Requests a dump at the end of the next frame. Safe to call from signal handlers.
+ */
+void RequestDump();
+
+/**
+ * Writes the recorded events to a file in the Chrome trace JSON format.
+ * @returns Whether the file could be written.
+ */
+bool Dump(const std::string& path);
+
+/// Records the lifetime of a scope as an event, if recording is enabled.
+class ScopedEvent {
+public:
+    ScopedEvent(const char* group, const char* name)
+        : group(group), name(name), start(IsEnabled() ? Now() : 0) {}
+    explicit ScopedEvent(const Category& category) : ScopedEvent(category.group, category.name) {}
+
+    ~ScopedEvent() {
+        if (start != 0) {
+            RecordEvent(group, name, start, Now());
+        }
+    }
+
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+    const char* group;
+    const char* name;
+    u64 start;
+};
+
+} // namespace Common::Trace
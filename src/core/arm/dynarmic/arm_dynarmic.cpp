@@ -6,6 +6,7 @@
 #include <dynarmic/A32/a32.h>
 #include <dynarmic/A32/context.h>
 #include "common/assert.h"
+#include "common/metrics.h"
 #include "common/microprofile.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
@@ -163,6 +164,13 @@ public:
     Memory::MemorySystem& memory;
 };
 
+/// dynarmic does not report the size of its code cache, so the number of JITs is tracked instead.
+static Common::Metrics::Gauge& JitInstancesMetric() {
+    static auto& metric = Common::Metrics::GetGauge(
+        "citra_cpu_jit_instances", "ARM JIT instances, each with its own code cache");
+    return metric;
+}
+
 ARM_Dynarmic::ARM_Dynarmic(Core::System* system, Memory::MemorySystem& memory,
                            PrivilegeMode initial_mode)
     : system(*system), memory(memory), cb(std::make_unique<DynarmicUserCallbacks>(*this)) {
@@ -170,7 +178,9 @@ ARM_Dynarmic::ARM_Dynarmic(Core::System* system, Memory::MemorySystem& memory,
     PageTableChanged();
 }
 
-ARM_Dynarmic::~ARM_Dynarmic() = default;
+ARM_Dynarmic::~ARM_Dynarmic() {
+    JitInstancesMetric().Add(-static_cast<double>(jits.size()));
+}
 
 MICROPROFILE_DEFINE(ARM_Jit, "ARM JIT", "ARM JIT", MP_RGB(255, 64, 64));
 
@@ -270,6 +280,10 @@ void ARM_Dynarmic::PrepareReschedule() {
 }
 
 void ARM_Dynarmic::ClearInstructionCache() {
+    static auto& clears_metric = Common::Metrics::GetCounter(
+        "citra_cpu_jit_cache_clears_total", "Clears of all ARM JIT code caches");
+    clears_metric.Increment();
+
     // TODO: Clear interpreter cache when appropriate.
     for (const auto& j : jits) {
         j.second->ClearCache();
@@ -278,6 +292,10 @@ void ARM_Dynarmic::ClearInstructionCache() {
 }
 
 void ARM_Dynarmic::InvalidateCacheRange(u32 start_address, std::size_t length) {
+    static auto& invalidations_metric = Common::Metrics::GetCounter(
+        "citra_cpu_jit_invalidations_total", "Invalidations of ranges of the ARM JIT code cache");
+    invalidations_metric.Increment();
+
     jit->InvalidateCacheRange(start_address, length);
 }
 
@@ -293,6 +311,7 @@ void ARM_Dynarmic::PageTableChanged() {
     auto new_jit = MakeJit();
     jit = new_jit.get();
     jits.emplace(current_page_table, std::move(new_jit));
+    JitInstancesMetric().Add(1);
 }
 
 std::unique_ptr<Dynarmic::A32::Jit> ARM_Dynarmic::MakeJit() {
@@ -4,10 +4,12 @@
 
 #include <memory>
 #include <utility>
+#include <fmt/format.h>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/hle/hle.h"
 #include "audio_core/lle/lle.h"
 #include "common/logging/log.h"
+#include "common/microprofile.h"
 #include "core/arm/arm_interface.h"
 #ifdef ARCHITECTURE_x86_64
 #include "core/arm/dynarmic/arm_dynarmic.h"
@@ -17,12 +19,14 @@
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/gdbstub/gdbstub.h"
+#include "core/guest_sampler.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/kernel.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/kernel/thread.h"
 #include "core/hle/service/fs/archive.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/service_stats.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/hw/hw.h"
 #include "core/loader/loader.h"
@@ -36,6 +40,35 @@ namespace Core {
 
 /*static*/ System System::s_instance;
 
+/// Adds a histogram of FS requests to the telemetry session, so delay profiles can be tuned
+static void AddFSDelayFields(TelemetrySession& telemetry_session, const char* name,
+                             const FileSys::DelayHistogram& histogram) {
+    using Telemetry::FieldType;
+    telemetry_session.AddField(FieldType::Performance, fmt::format("{}_Count", name).c_str(),
+                               histogram.count);
+    telemetry_session.AddField(FieldType::Performance, fmt::format("{}_TotalBytes", name).c_str(),
+                               histogram.total_size);
+    telemetry_session.AddField(FieldType::Performance,
+                               fmt::format("{}_TotalLatencyUs", name).c_str(),
+                               histogram.total_latency_ns / 1000);
+    telemetry_session.AddField(FieldType::Performance, fmt::format("{}_TotalDelayMs", name).c_str(),
+                               histogram.total_delay_ns / 1000000);
+    for (std::size_t i = 0; i < FileSys::DelayHistogram::NumBuckets; ++i) {
+        if (histogram.size_buckets[i] != 0) {
+            telemetry_session.AddField(FieldType::Performance,
+                                       fmt::format("{}_SizeLog2_{}", name, i).c_str(),
+                                       histogram.size_buckets[i]);
+        }
+        if (histogram.latency_buckets[i] != 0) {
+            telemetry_session.AddField(FieldType::Performance,
+                                       fmt::format("{}_LatencyUsLog2_{}", name, i).c_str(),
+                                       histogram.latency_buckets[i]);
+        }
+    }
+}
+
+MICROPROFILE_DEFINE(Core_CPUSlice, "Core", "CPU Slice", MP_RGB(255, 160, 64));
+
 System::ResultStatus System::RunLoop(bool tight_loop) {
     status = ResultStatus::Success;
     if (!cpu_core) {
@@ -65,6 +98,8 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         PrepareReschedule();
     } else {
         timing->Advance();
+        MICROPROFILE_SCOPE(Core_CPUSlice);
+        PerfStats::ScopedComponent perf_component(perf_stats, PerfStats::Component::CPU);
         if (tight_loop) {
             cpu_core->Run();
         } else {
@@ -142,12 +177,27 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
         }
     }
     cheat_engine = std::make_unique<Cheats::CheatEngine>(*this);
+    archive_manager->LoadDelayProfile(process->codeset->program_id);
     status = ResultStatus::Success;
     m_emu_window = &emu_window;
     m_filepath = filepath;
     return status;
 }
 
+System::ResultStatus System::InitForTraceReplay(Frontend::EmuWindow& emu_window) {
+    // Traces only drive the GPU, so the system mode doesn't matter
+    const ResultStatus init_result{Init(emu_window, 0)};
+    if (init_result != ResultStatus::Success) {
+        LOG_CRITICAL(Core, "Failed to initialize system (Error {})!",
+                     static_cast<u32>(init_result));
+        System::Shutdown();
+        return init_result;
+    }
+    status = ResultStatus::Success;
+    m_emu_window = &emu_window;
+    return status;
+}
+
 void System::PrepareReschedule() {
     cpu_core->PrepareReschedule();
     reschedule_pending = true;
@@ -198,6 +248,7 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window, u32 system_mo
 
     memory->SetDSP(*dsp_core);
 
+    dsp_core->SetPerfStats(&perf_stats);
     dsp_core->SetSink(Settings::values.sink_id, Settings::values.audio_device_id);
     dsp_core->EnableStretching(Settings::values.enable_audio_stretching);
 
@@ -207,6 +258,7 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window, u32 system_mo
 
     service_manager = std::make_shared<Service::SM::ServiceManager>(*this);
     archive_manager = std::make_unique<Service::FS::ArchiveManager>(*this);
+    guest_sampler = std::make_unique<Core::GuestSampler>(*this, *timing);
 
     HW::Init(*memory);
     Service::Init(*this);
@@ -221,6 +273,7 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window, u32 system_mo
 
     // Reset counters and set time origin to current frame
     GetAndResetPerfStats();
+    perf_stats.ResetFrameHistory();
     perf_stats.BeginSystemFrame();
 
     return ResultStatus::Success;
@@ -274,6 +327,14 @@ const Cheats::CheatEngine& System::CheatEngine() const {
     return *cheat_engine;
 }
 
+Core::GuestSampler& System::GuestSampler() {
+    return *guest_sampler;
+}
+
+const Core::GuestSampler& System::GuestSampler() const {
+    return *guest_sampler;
+}
+
 void System::RegisterMiiSelector(std::shared_ptr<Frontend::MiiSelector> mii_selector) {
     registered_mii_selector = std::move(mii_selector);
 }
@@ -291,6 +352,21 @@ void System::Shutdown() {
                                 perf_results.game_fps);
     telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_Frametime",
                                 perf_results.frametime * 1000.0);
+    telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_AudioUnderruns",
+                                perf_results.audio_underruns);
+    const auto frame_time = perf_stats.GetFrameTimeStats();
+    telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_FrametimeP50",
+                                frame_time.p50 * 1000.0);
+    telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_FrametimeP99",
+                                frame_time.p99 * 1000.0);
+    telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_FrametimeMax",
+                                frame_time.max * 1000.0);
+    telemetry_session->AddField(Telemetry::FieldType::Performance, "Shutdown_Hitches",
+                                frame_time.hitches);
+    AddFSDelayFields(*telemetry_session, "Shutdown_FsRead", archive_manager->GetReadStatistics());
+    AddFSDelayFields(*telemetry_session, "Shutdown_FsOpen", archive_manager->GetOpenStatistics());
+    LOG_INFO(Service, "HLE service calls with the most host time:\n{}",
+             Service::GetCallStatistics().FormatSummary(10));
 
     // Shutdown emulation session
     GDBStub::Shutdown();
@@ -300,6 +376,7 @@ void System::Shutdown() {
     rpc_server.reset();
     cheat_engine.reset();
     service_manager.reset();
+    guest_sampler.reset();
     dsp_core.reset();
     cpu_core.reset();
     kernel.reset();
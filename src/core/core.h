@@ -51,6 +51,7 @@ class CheatEngine;
 
 namespace Core {
 
+class GuestSampler;
 class Timing;
 
 class System {
@@ -126,6 +127,14 @@ public:
      */
     ResultStatus Load(Frontend::EmuWindow& emu_window, const std::string& filepath);
 
+    /**
+     * Initialize the emulated system without loading an application, for replaying GPU traces
+     * with CiTrace::Replay.
+     * @param emu_window Reference to the host-system window used for video output.
+     * @returns ResultStatus code, indicating if the operation succeeded.
+     */
+    ResultStatus InitForTraceReplay(Frontend::EmuWindow& emu_window);
+
     /**
      * Indicates if the emulated system is powered on (all subsystems initialized and able to run an
      * application).
@@ -206,6 +215,12 @@ public:
     /// Gets a const reference to the cheat engine
     const Cheats::CheatEngine& CheatEngine() const;
 
+    /// Gets a reference to the guest code sampler
+    Core::GuestSampler& GuestSampler();
+
+    /// Gets a const reference to the guest code sampler
+    const Core::GuestSampler& GuestSampler() const;
+
     PerfStats perf_stats;
     FrameLimiter frame_limiter;
 
@@ -276,6 +291,9 @@ private:
     /// Cheats manager
     std::unique_ptr<Cheats::CheatEngine> cheat_engine;
 
+    /// Statistical profiler of guest code
+    std::unique_ptr<Core::GuestSampler> guest_sampler;
+
     /// RPC Server for scripting support
     std::unique_ptr<RPC::RPCServer> rpc_server;
 
@@ -70,7 +70,9 @@ public:
         return true;
     }
 
-    void Flush() const override {}
+    bool Flush() const override {
+        return true;
+    }
 
 private:
     std::shared_ptr<std::vector<u8>> data;
@@ -3,12 +3,85 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <charconv>
+#include <sstream>
+#include <string>
+#include "common/logging/log.h"
+#include "common/string_util.h"
 #include "core/file_sys/delay_generator.h"
 
 namespace FileSys {
 
 DelayGenerator::~DelayGenerator() = default;
 
+static std::size_t GetLog2Bucket(u64 value) {
+    std::size_t bucket = 0;
+    while (value > 1 && bucket < DelayHistogram::NumBuckets - 1) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void DelayHistogram::Record(u64 size, u64 latency_ns, u64 delay_ns) {
+    ++count;
+    total_size += size;
+    total_latency_ns += latency_ns;
+    total_delay_ns += delay_ns;
+    ++size_buckets[GetLog2Bucket(size)];
+    ++latency_buckets[GetLog2Bucket(latency_ns / 1000)];
+}
+
+u64 DelayProfile::GetOpenDelayNs(u64 archive_delay_ns) const {
+    return open_ns.value_or(archive_delay_ns);
+}
+
+u64 DelayProfile::GetReadDelayNs(std::size_t length, u64 archive_delay_ns) const {
+    if (!read_base_ns && !read_ns_per_byte) {
+        return archive_delay_ns;
+    }
+    return read_base_ns.value_or(0) + static_cast<u64>(length) * read_ns_per_byte.value_or(0);
+}
+
+std::optional<DelayProfile> ParseDelayProfile(std::string_view text) {
+    DelayProfile profile;
+    std::istringstream stream{std::string(text)};
+    std::string line;
+    for (int line_number = 1; std::getline(stream, line); ++line_number) {
+        line = Common::StripSpaces(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        const std::size_t separator = line.find('=');
+        const std::string key = Common::StripSpaces(line.substr(0, separator));
+        const std::string value =
+            separator == std::string::npos ? "" : Common::StripSpaces(line.substr(separator + 1));
+        u64 number = 0;
+        const auto [end, error] =
+            std::from_chars(value.data(), value.data() + value.size(), number);
+        if (value.empty() || error != std::errc{} || end != value.data() + value.size()) {
+            LOG_ERROR(Service_FS, "Invalid value on line {} of the delay profile", line_number);
+            return std::nullopt;
+        }
+
+        if (key == "percentage") {
+            profile.percentage = static_cast<u32>(std::min<u64>(number, 0xFFFF));
+        } else if (key == "open_ns") {
+            profile.open_ns = number;
+        } else if (key == "read_base_ns") {
+            profile.read_base_ns = number;
+        } else if (key == "read_ns_per_byte") {
+            profile.read_ns_per_byte = number;
+        } else {
+            LOG_ERROR(Service_FS, "Unknown key {} on line {} of the delay profile", key,
+                      line_number);
+            return std::nullopt;
+        }
+    }
+    return profile;
+}
+
 u64 DefaultDelayGenerator::GetReadDelayNs(std::size_t length) {
     // This is the delay measured for a romfs read.
     // For now we will take that as a default
@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <cstddef>
+#include <optional>
+#include <string_view>
 #include "common/common_types.h"
 
 namespace FileSys {
@@ -24,4 +27,58 @@ public:
     u64 GetOpenDelayNs() override;
 };
 
+/**
+ * Timing of the file system requests of a title, loaded from a profile file. Titles that time
+ * out or break with the measured hardware timing can be tuned without affecting others. Every
+ * value that is not set keeps the default: the global delay percentage and the measured timing
+ * of each archive.
+ */
+struct DelayProfile {
+    /// Scale of all delays in percent. 0 makes every request instant, for benchmarking
+    std::optional<u32> percentage;
+    /// Delay of file opens, replacing the measured delay of the archive
+    std::optional<u64> open_ns;
+    /// Fixed part of the delay of reads. With read_ns_per_byte, replaces the measured delay
+    std::optional<u64> read_base_ns;
+    /// Delay per byte read, added to read_base_ns
+    std::optional<u64> read_ns_per_byte;
+
+    /// Returns the unscaled delay of a file open, given the measured delay of the archive
+    u64 GetOpenDelayNs(u64 archive_delay_ns) const;
+
+    /// Returns the unscaled delay of a read, given the measured delay of the archive
+    u64 GetReadDelayNs(std::size_t length, u64 archive_delay_ns) const;
+};
+
+/**
+ * Parses a delay profile. Profiles hold one "key = value" pair per line, where the keys are the
+ * names of the DelayProfile fields, and lines starting with # are comments.
+ * @returns The profile, or std::nullopt if a line could not be parsed
+ */
+std::optional<DelayProfile> ParseDelayProfile(std::string_view text);
+
+/**
+ * Histogram of file system requests, used to compare the emulated timing against real load times.
+ * Request sizes and the time the host took to serve the requests are bucketed by their base 2
+ * logarithm.
+ */
+struct DelayHistogram {
+    static constexpr std::size_t NumBuckets = 32;
+
+    /**
+     * Records a request
+     * @param size Size of the request in bytes
+     * @param latency_ns Time the host took to serve the request
+     * @param delay_ns Emulated delay of the request
+     */
+    void Record(u64 size, u64 latency_ns, u64 delay_ns);
+
+    u64 count = 0;
+    u64 total_size = 0;
+    u64 total_latency_ns = 0;
+    u64 total_delay_ns = 0;
+    std::array<u64, NumBuckets> size_buckets{};    ///< Requests per log2 of the size in bytes
+    std::array<u64, NumBuckets> latency_buckets{}; ///< Requests per log2 of the latency in us
+};
+
 } // namespace FileSys
@@ -16,11 +16,17 @@
 
 namespace FileSys {
 
+DiskFile::~DiskFile() {
+    FlushWriteCache();
+}
+
 ResultVal<std::size_t> DiskFile::Read(const u64 offset, const std::size_t length,
                                       u8* buffer) const {
     if (!mode.read_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
+    if (!FlushWriteCache())
+        return ERROR_INSUFFICIENT_SPACE;
     file->Seek(offset, SEEK_SET);
     return MakeResult<std::size_t>(file->ReadBytes(buffer, length));
 }
@@ -30,25 +36,78 @@ ResultVal<std::size_t> DiskFile::Write(const u64 offset, const std::size_t lengt
     if (!mode.write_flag)
         return ERROR_INVALID_OPEN_FLAGS;
 
-    file->Seek(offset, SEEK_SET);
-    std::size_t written = file->WriteBytes(buffer, length);
-    if (flush)
-        file->Flush();
-    return MakeResult<std::size_t>(written);
+    // Games tend to save through many small writes. Runs of contiguous writes are coalesced here
+    // and handed to the host file in one go when the run is broken, the cache fills up, the guest
+    // asks for a flush, or it reads, resizes, flushes or closes the file. Writes with the flush
+    // flag are written out immediately, so only runs of unflushed writes are coalesced.
+    if (!write_cache.empty() && offset != write_cache_offset + write_cache.size() &&
+        !FlushWriteCache()) {
+        return ERROR_INSUFFICIENT_SPACE;
+    }
+
+    if (write_cache.size() + length > WriteCacheSize) {
+        if (!FlushWriteCache())
+            return ERROR_INSUFFICIENT_SPACE;
+
+        if (length > WriteCacheSize) {
+            file->Seek(offset, SEEK_SET);
+            std::size_t written = file->WriteBytes(buffer, length);
+            if (flush)
+                file->Flush();
+            return MakeResult<std::size_t>(written);
+        }
+    }
+
+    if (write_cache.empty())
+        write_cache_offset = offset;
+    write_cache.insert(write_cache.end(), buffer, buffer + length);
+
+    // The guest expects flushed data to be on disk, and visible to other handles of the file
+    if (flush && !FlushWriteCache())
+        return ERROR_INSUFFICIENT_SPACE;
+    return MakeResult<std::size_t>(length);
 }
 
 u64 DiskFile::GetSize() const {
-    return file->GetSize();
+    const u64 size = file->GetSize();
+    if (write_cache.empty())
+        return size;
+    return std::max<u64>(size, write_cache_offset + write_cache.size());
 }
 
 bool DiskFile::SetSize(const u64 size) const {
+    if (!FlushWriteCache())
+        return false;
     file->Resize(size);
     file->Flush();
     return true;
 }
 
 bool DiskFile::Close() const {
-    return file->Close();
+    const bool flushed = FlushWriteCache();
+    return file->Close() && flushed;
+}
+
+bool DiskFile::Flush() const {
+    return FlushWriteCache() && file->Flush();
+}
+
+bool DiskFile::FlushWriteCache() const {
+    if (write_cache.empty() || !file->IsOpen())
+        return true;
+
+    file->Seek(write_cache_offset, SEEK_SET);
+    const bool written =
+        file->WriteBytes(write_cache.data(), write_cache.size()) == write_cache.size() &&
+        file->Flush();
+    if (!written) {
+        // The guest was told that these writes succeeded, so they are kept to be tried again
+        LOG_ERROR(Service_FS, "Failed to write back {} cached bytes at offset {:#x}",
+                  write_cache.size(), write_cache_offset);
+        return false;
+    }
+    write_cache.clear();
+    return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
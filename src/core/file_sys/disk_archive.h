@@ -29,6 +29,8 @@ public:
         mode.hex = mode_.hex;
     }
 
+    ~DiskFile() override;
+
     ResultVal<std::size_t> Read(u64 offset, std::size_t length, u8* buffer) const override;
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
                                  const u8* buffer) override;
@@ -36,13 +38,27 @@ public:
     bool SetSize(u64 size) const override;
     bool Close() const override;
 
-    void Flush() const override {
-        file->Flush();
-    }
+    bool Flush() const override;
 
 protected:
     Mode mode;
     std::unique_ptr<FileUtil::IOFile> file;
+
+private:
+    /**
+     * Hands the data held in the write-back cache over to the host file and flushes it. The data
+     * stays in the cache if the host file did not accept it.
+     * @returns Whether the host file accepted the data.
+     */
+    bool FlushWriteCache() const;
+
+    /// Maximum number of bytes coalesced in the write-back cache before it is written out
+    static constexpr std::size_t WriteCacheSize = 0x10000;
+
+    /// Pending contiguous writes that have not been passed to the host file yet
+    mutable std::vector<u8> write_cache;
+    /// Offset in the file where the cached data starts
+    mutable u64 write_cache_offset = 0;
 };
 
 class DiskDirectory : public DirectoryBackend {
@@ -85,8 +85,9 @@ public:
 
     /**
      * Flushes the file
+     * @return true if the data reached the host file
      */
-    virtual void Flush() const = 0;
+    virtual bool Flush() const = 0;
 
 protected:
     std::unique_ptr<DelayGenerator> delay_generator;
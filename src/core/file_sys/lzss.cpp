@@ -0,0 +1,92 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include "core/file_sys/lzss.h"
+
+namespace FileSys {
+
+u32 LZSS_GetDecompressedSize(const u8* buffer, u32 size) {
+    if (size < sizeof(u32))
+        return size;
+
+    u32 offset_size;
+    std::memcpy(&offset_size, buffer + size - sizeof(u32), sizeof(u32));
+    return offset_size + size;
+}
+
+bool LZSS_Decompress(u8* buffer, u32 compressed_size, u32 decompressed_size) {
+    if (compressed_size < 8 || decompressed_size < compressed_size)
+        return false;
+
+    const u8* footer = buffer + compressed_size - 8;
+
+    u32 buffer_top_and_bottom;
+    std::memcpy(&buffer_top_and_bottom, footer, sizeof(u32));
+
+    const u32 footer_size = (buffer_top_and_bottom >> 24) & 0xFF;
+    const u32 compressed_region_size = buffer_top_and_bottom & 0xFFFFFF;
+    if (footer_size > compressed_size || compressed_region_size > compressed_size)
+        return false;
+
+    u32 out = decompressed_size;
+    u32 index = compressed_size - footer_size;
+    u32 stop_index = compressed_size - compressed_region_size;
+
+    std::memset(buffer + compressed_size, 0, decompressed_size - compressed_size);
+
+    while (index > stop_index) {
+        u8 control = buffer[--index];
+
+        for (unsigned i = 0; i < 8; i++) {
+            if (index <= stop_index)
+                break;
+            if (index <= 0)
+                break;
+            if (out <= 0)
+                break;
+
+            if (control & 0x80) {
+                // Check if compression is out of bounds
+                if (index < 2)
+                    return false;
+                index -= 2;
+
+                u32 segment_offset = buffer[index] | (buffer[index + 1] << 8);
+                u32 segment_size = ((segment_offset >> 12) & 15) + 3;
+                segment_offset &= 0x0FFF;
+                segment_offset += 2;
+
+                // Check if compression is out of bounds
+                if (out < segment_size)
+                    return false;
+                if (out + segment_offset >= decompressed_size)
+                    return false;
+
+                // The source of the back-reference starts segment_offset + 1 bytes above the
+                // output cursor. When the two ranges don't overlap the whole segment can be copied
+                // at once, otherwise the byte-wise copy is needed to replicate repeating patterns.
+                if (segment_offset + 1 >= segment_size) {
+                    out -= segment_size;
+                    std::memcpy(buffer + out, buffer + out + segment_offset + 1, segment_size);
+                } else {
+                    for (unsigned j = 0; j < segment_size; j++) {
+                        u8 data = buffer[out + segment_offset];
+                        buffer[--out] = data;
+                    }
+                }
+            } else {
+                // Check if compression is out of bounds
+                if (out < 1)
+                    return false;
+                buffer[--out] = buffer[--index];
+            }
+            control <<= 1;
+        }
+    }
+
+    return true;
+}
+
+} // namespace FileSys
@@ -0,0 +1,30 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace FileSys {
+
+/**
+ * Get the decompressed size of an LZSS compressed ExeFS file
+ * @param buffer Buffer of compressed file
+ * @param size Size of compressed buffer
+ * @return Size of decompressed buffer, or size if the buffer is too small to hold the footer
+ */
+u32 LZSS_GetDecompressedSize(const u8* buffer, u32 size);
+
+/**
+ * Decompress ExeFS file (compressed with LZSS) in place. The compressed data is read from the start
+ * of the buffer and the output is written backwards from its end, the same way the 3DS kernel does
+ * it, so the write cursor never overtakes the unread input of a well-formed file.
+ * @param buffer Buffer holding the compressed file, at least decompressed_size bytes long
+ * @param compressed_size Size of compressed data at the start of the buffer
+ * @param decompressed_size Size of decompressed buffer
+ * @return True on success, otherwise false
+ */
+bool LZSS_Decompress(u8* buffer, u32 compressed_size, u32 decompressed_size);
+
+} // namespace FileSys
@@ -11,8 +11,10 @@
 #include "common/common_types.h"
 #include "common/logging/log.h"
 #include "core/core.h"
+#include "core/file_sys/lzss.h"
 #include "core/file_sys/ncch_container.h"
 #include "core/file_sys/seed_db.h"
+#include "core/hw/aes/ctr.h"
 #include "core/hw/aes/key.h"
 #include "core/loader/loader.h"
 
@@ -30,6 +32,11 @@ static const int kBlockSize = 0x200; ///< Size of ExeFS blocks (in bytes)
  * @param buffer Vector to patch data into
  */
 static void ApplyIPS(std::vector<u8>& ips, std::vector<u8>& buffer) {
+    if (ips.size() < 5) {
+        LOG_INFO(Service_FS, "Attempted to load invalid IPS");
+        return;
+    }
+
     u32 cursor = 5;
     u32 patch_length = ips.size() - 3;
     std::string ips_header(ips.begin(), ips.begin() + 5);
@@ -55,8 +62,8 @@ static void ApplyIPS(std::vector<u8>& ips, std::vector<u8>& buffer) {
             if (buffer.size() < offset + length)
                 return;
 
-            for (u32 i = 0; i < length; ++i)
-                buffer[offset + i] = ips[cursor + 7];
+            if (length != 0)
+                std::memset(buffer.data() + offset, ips[cursor + 7], length);
 
             cursor += 8;
 
@@ -66,91 +73,11 @@ static void ApplyIPS(std::vector<u8>& ips, std::vector<u8>& buffer) {
         if (buffer.size() < offset + length)
             return;
 
-        std::memcpy(&buffer[offset], &ips[cursor + 5], length);
+        std::memcpy(buffer.data() + offset, &ips[cursor + 5], length);
         cursor += length + 5;
     }
 }
 
-/**
- * Get the decompressed size of an LZSS compressed ExeFS file
- * @param buffer Buffer of compressed file
- * @param size Size of compressed buffer
- * @return Size of decompressed buffer
- */
-static u32 LZSS_GetDecompressedSize(const u8* buffer, u32 size) {
-    u32 offset_size;
-    std::memcpy(&offset_size, buffer + size - sizeof(u32), sizeof(u32));
-    return offset_size + size;
-}
-
-/**
- * Decompress ExeFS file (compressed with LZSS)
- * @param compressed Compressed buffer
- * @param compressed_size Size of compressed buffer
- * @param decompressed Decompressed buffer
- * @param decompressed_size Size of decompressed buffer
- * @return True on success, otherwise false
- */
-static bool LZSS_Decompress(const u8* compressed, u32 compressed_size, u8* decompressed,
-                            u32 decompressed_size) {
-    const u8* footer = compressed + compressed_size - 8;
-
-    u32 buffer_top_and_bottom;
-    std::memcpy(&buffer_top_and_bottom, footer, sizeof(u32));
-
-    u32 out = decompressed_size;
-    u32 index = compressed_size - ((buffer_top_and_bottom >> 24) & 0xFF);
-    u32 stop_index = compressed_size - (buffer_top_and_bottom & 0xFFFFFF);
-
-    memset(decompressed, 0, decompressed_size);
-    memcpy(decompressed, compressed, compressed_size);
-
-    while (index > stop_index) {
-        u8 control = compressed[--index];
-
-        for (unsigned i = 0; i < 8; i++) {
-            if (index <= stop_index)
-                break;
-            if (index <= 0)
-                break;
-            if (out <= 0)
-                break;
-
-            if (control & 0x80) {
-                // Check if compression is out of bounds
-                if (index < 2)
-                    return false;
-                index -= 2;
-
-                u32 segment_offset = compressed[index] | (compressed[index + 1] << 8);
-                u32 segment_size = ((segment_offset >> 12) & 15) + 3;
-                segment_offset &= 0x0FFF;
-                segment_offset += 2;
-
-                // Check if compression is out of bounds
-                if (out < segment_size)
-                    return false;
-
-                for (unsigned j = 0; j < segment_size; j++) {
-                    // Check if compression is out of bounds
-                    if (out + segment_offset >= decompressed_size)
-                        return false;
-
-                    u8 data = decompressed[out + segment_offset];
-                    decompressed[--out] = data;
-                }
-            } else {
-                // Check if compression is out of bounds
-                if (out < 1)
-                    return false;
-                decompressed[--out] = compressed[--index];
-            }
-            control <<= 1;
-        }
-    }
-    return true;
-}
-
 NCCHContainer::NCCHContainer(const std::string& filepath, u32 ncch_offset)
     : ncch_offset(ncch_offset), filepath(filepath) {
     file = FileUtil::IOFile(filepath, "rb");
@@ -504,38 +431,42 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 key = secondary_key;
             }
 
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(),
-                                                              exefs_ctr.data());
-            dec.Seek(section.offset + sizeof(ExeFs_Header));
+            HW::AES::CTRCipher cipher(key, exefs_ctr);
+            const u64 crypto_offset = section.offset + sizeof(ExeFs_Header);
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
-                // Section is compressed, read compressed .code section...
-                std::unique_ptr<u8[]> temp_buffer;
+                // Section is compressed, read compressed .code section straight into the output
+                // buffer, which is then decrypted and decompressed in place...
                 try {
-                    temp_buffer.reset(new u8[section.size]);
+                    buffer.resize(section.size);
                 } catch (std::bad_alloc&) {
                     return Loader::ResultStatus::ErrorMemoryAllocationFailed;
                 }
 
-                if (exefs_file.ReadBytes(&temp_buffer[0], section.size) != section.size)
+                if (exefs_file.ReadBytes(buffer.data(), section.size) != section.size)
                     return Loader::ResultStatus::Error;
 
                 if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
+                    cipher.Process(buffer.data(), section.size, crypto_offset);
                 }
 
                 // Decompress .code section...
-                u32 decompressed_size = LZSS_GetDecompressedSize(&temp_buffer[0], section.size);
-                buffer.resize(decompressed_size);
-                if (!LZSS_Decompress(&temp_buffer[0], section.size, &buffer[0], decompressed_size))
+                u32 decompressed_size = LZSS_GetDecompressedSize(buffer.data(), section.size);
+                try {
+                    buffer.resize(decompressed_size);
+                } catch (std::bad_alloc&) {
+                    return Loader::ResultStatus::ErrorMemoryAllocationFailed;
+                }
+
+                if (!LZSS_Decompress(buffer.data(), section.size, decompressed_size))
                     return Loader::ResultStatus::ErrorInvalidFormat;
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
-                if (exefs_file.ReadBytes(&buffer[0], section.size) != section.size)
+                if (exefs_file.ReadBytes(buffer.data(), section.size) != section.size)
                     return Loader::ResultStatus::Error;
                 if (is_encrypted) {
-                    dec.ProcessData(&buffer[0], &buffer[0], section.size);
+                    cipher.Process(buffer.data(), section.size, crypto_offset);
                 }
             }
 
@@ -547,7 +478,7 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
                 std::vector<u8> ips(ips_file_size);
 
                 if (ips_file.IsOpen() &&
-                    ips_file.ReadBytes(&ips[0], ips_file_size) == ips_file_size) {
+                    ips_file.ReadBytes(ips.data(), ips_file_size) == ips_file_size) {
                     LOG_INFO(Service_FS, "File {} patching code.bin", override_ips);
                     ApplyIPS(ips, buffer);
                 }
@@ -583,7 +514,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrideExeFSSection(const char* name,
         buffer.resize(section_size);
 
         section_file.Seek(0, SEEK_SET);
-        if (section_file.ReadBytes(&buffer[0], section_size) == section_size) {
+        if (section_file.ReadBytes(buffer.data(), section_size) == section_size) {
             LOG_WARNING(Service_FS, "File {} overriding built-in ExeFS file", section_override);
             return Loader::ResultStatus::Success;
         }
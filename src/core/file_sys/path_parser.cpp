@@ -70,18 +70,25 @@ PathParser::HostStatus PathParser::GetHostStatus(const std::string& mount_point)
             path += '/';
         path += *iter;
 
-        if (!FileUtil::Exists(path))
+        switch (FileUtil::GetEntryType(path)) {
+        case FileUtil::EntryType::NotFound:
             return PathNotFound;
-        if (FileUtil::IsDirectory(path))
+        case FileUtil::EntryType::File:
+            return FileInPath;
+        case FileUtil::EntryType::Directory:
             continue;
-        return FileInPath;
+        }
     }
 
     path += "/" + path_sequence.back();
-    if (!FileUtil::Exists(path))
+    switch (FileUtil::GetEntryType(path)) {
+    case FileUtil::EntryType::NotFound:
         return NotFound;
-    if (FileUtil::IsDirectory(path))
+    case FileUtil::EntryType::Directory:
         return DirectoryFound;
+    case FileUtil::EntryType::File:
+        break;
+    }
     return FileFound;
 }
 
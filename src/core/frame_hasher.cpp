@@ -0,0 +1,201 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <utility>
+#include <boost/crc.hpp>
+#include <fmt/format.h>
+#include "common/cityhash.h"
+#include "common/color.h"
+#include "common/logging/log.h"
+#include "common/swap.h"
+#include "core/frame_hasher.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
+
+namespace Core {
+
+FrameHasher::FrameHasher(Memory::MemorySystem& memory_, const std::string& log_path,
+                         std::string dump_directory_, u32 dump_interval_)
+    : memory(memory_), log(log_path, "w"), dump_directory(std::move(dump_directory_)),
+      dump_interval(std::max<u32>(dump_interval_, 1)) {
+    if (!log.IsOpen()) {
+        LOG_ERROR(Core, "Could not open {} to write the frame hashes", log_path);
+    }
+    if (!dump_directory.empty()) {
+        if (dump_directory.back() != '/' && dump_directory.back() != '\\') {
+            dump_directory += '/';
+        }
+        FileUtil::CreateFullPath(dump_directory);
+    }
+    vblank_callback_id = GPU::RegisterVBlankCallback([this] { OnVBlank(); });
+}
+
+FrameHasher::~FrameHasher() {
+    GPU::UnregisterVBlankCallback(vblank_callback_id);
+    LOG_INFO(Core, "Hashed {} frames", frame);
+}
+
+bool FrameHasher::IsOpen() const {
+    return log.IsOpen();
+}
+
+u32 FrameHasher::GetFrameCount() const {
+    return frame;
+}
+
+void FrameHasher::OnVBlank() {
+    const Image top = ReadScreen(memory, 0);
+    const Image bottom = ReadScreen(memory, 1);
+    const auto hash = [](const Image& image) {
+        return Common::CityHash64(reinterpret_cast<const char*>(image.pixels.data()),
+                                  image.pixels.size());
+    };
+    log.WriteString(fmt::format("{} {:016x} {:016x}\n", frame, hash(top), hash(bottom)));
+
+    if (!dump_directory.empty() && frame % dump_interval == 0) {
+        for (const auto& [image, name] : {std::pair{&top, "top"}, std::pair{&bottom, "bottom"}}) {
+            const std::string path =
+                fmt::format("{}frame_{:06}_{}.png", dump_directory, frame, name);
+            if (!image->pixels.empty() && !WritePNG(path, *image)) {
+                LOG_ERROR(Core, "Could not write frame {} to {}", frame, path);
+            }
+        }
+    }
+    ++frame;
+}
+
+FrameHasher::Image FrameHasher::ReadScreen(Memory::MemorySystem& memory, int screen) {
+    const auto& framebuffer = GPU::g_regs.framebuffer_config[screen];
+    const PAddr address =
+        framebuffer.active_fb == 0 ? framebuffer.address_left1 : framebuffer.address_left2;
+    const u32 bpp = GPU::Regs::BytesPerPixel(framebuffer.color_format);
+    const u32 size = framebuffer.stride * framebuffer.height;
+    Image image;
+    if (address == 0 || framebuffer.width == 0 || framebuffer.height == 0 ||
+        framebuffer.stride < framebuffer.width * bpp) {
+        // The application did not set up the screen yet
+        return image;
+    }
+
+    // With the hardware renderer, the framebuffer can only be up to date in the rasterizer cache
+    Memory::RasterizerFlushRegion(address, size);
+    const u8* data = memory.GetPhysicalPointer(address);
+    // The last byte is checked rather than the end, which may be past the end of the region
+    if (data == nullptr || memory.GetPhysicalPointer(address + size - 1) != data + size - 1) {
+        return image;
+    }
+
+    // The framebuffers are stored rotated, each row of the framebuffer is a column of the screen
+    // starting from the bottom.
+    image.width = framebuffer.height;
+    image.height = framebuffer.width;
+    image.pixels.resize(image.width * image.height * 4);
+    for (u32 row = 0; row < framebuffer.height; ++row) {
+        const u8* row_data = data + row * framebuffer.stride;
+        for (u32 column = 0; column < framebuffer.width; ++column) {
+            const u8* pixel = row_data + column * bpp;
+            Common::Vec4<u8> color;
+            switch (framebuffer.color_format) {
+            case GPU::Regs::PixelFormat::RGBA8:
+                color = Color::DecodeRGBA8(pixel);
+                break;
+            case GPU::Regs::PixelFormat::RGB8:
+                color = Color::DecodeRGB8(pixel);
+                break;
+            case GPU::Regs::PixelFormat::RGB565:
+                color = Color::DecodeRGB565(pixel);
+                break;
+            case GPU::Regs::PixelFormat::RGB5A1:
+                color = Color::DecodeRGB5A1(pixel);
+                break;
+            case GPU::Regs::PixelFormat::RGBA4:
+                color = Color::DecodeRGBA4(pixel);
+                break;
+            }
+            // The screens do not show the alpha component
+            color.w = 255;
+            const u32 x = row;
+            const u32 y = image.height - 1 - column;
+            std::copy_n(color.AsArray(), 4, &image.pixels[(y * image.width + x) * 4]);
+        }
+    }
+    return image;
+}
+
+bool FrameHasher::WritePNG(const std::string& path, const Image& image) {
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        return false;
+    }
+
+    const auto write_chunk = [&file](const char type[4], const std::vector<u8>& data) {
+        const u32_be length = static_cast<u32>(data.size());
+        boost::crc_32_type crc;
+        crc.process_bytes(type, 4);
+        crc.process_bytes(data.data(), data.size());
+        const u32_be checksum = crc.checksum();
+        file.WriteObject(length);
+        file.WriteBytes(type, 4);
+        if (!data.empty()) {
+            file.WriteBytes(data.data(), data.size());
+        }
+        file.WriteObject(checksum);
+    };
+    const auto append_u32 = [](std::vector<u8>& data, u32 value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            data.push_back(static_cast<u8>(value >> shift));
+        }
+    };
+
+    static constexpr u8 signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    file.WriteBytes(signature, sizeof(signature));
+
+    // 8 bits per component, truecolor with alpha, no interlacing
+    std::vector<u8> header;
+    append_u32(header, image.width);
+    append_u32(header, image.height);
+    header.insert(header.end(), {8, 6, 0, 0, 0});
+    write_chunk("IHDR", header);
+
+    // Every row starts with the filter type, which is 0 (none)
+    const std::size_t row_size = image.width * 4;
+    std::vector<u8> raw;
+    raw.reserve((row_size + 1) * image.height);
+    for (u32 y = 0; y < image.height; ++y) {
+        raw.push_back(0);
+        const auto row = image.pixels.begin() + y * row_size;
+        raw.insert(raw.end(), row, row + row_size);
+    }
+
+    // The images are only dumped for inspection, so the data is stored in uncompressed deflate
+    // blocks instead of depending on zlib.
+    constexpr std::size_t MaxBlockSize = 0xFFFF;
+    std::vector<u8> data{0x78, 0x01};
+    u32 adler_a = 1;
+    u32 adler_b = 0;
+    std::size_t offset = 0;
+    do {
+        const std::size_t block_size = std::min(MaxBlockSize, raw.size() - offset);
+        const bool last = offset + block_size == raw.size();
+        data.push_back(last ? 1 : 0);
+        data.push_back(static_cast<u8>(block_size));
+        data.push_back(static_cast<u8>(block_size >> 8));
+        data.push_back(static_cast<u8>(~block_size));
+        data.push_back(static_cast<u8>(~block_size >> 8));
+        for (std::size_t i = offset; i < offset + block_size; ++i) {
+            data.push_back(raw[i]);
+            adler_a = (adler_a + raw[i]) % 65521;
+            adler_b = (adler_b + adler_a) % 65521;
+        }
+        offset += block_size;
+    } while (offset < raw.size());
+    append_u32(data, (adler_b << 16) | adler_a);
+    write_chunk("IDAT", data);
+    write_chunk("IEND", {});
+
+    return file.IsGood();
+}
+
+} // namespace Core
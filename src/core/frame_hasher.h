@@ -0,0 +1,65 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "common/file_util.h"
+
+namespace Memory {
+class MemorySystem;
+}
+
+namespace Core {
+
+/**
+ * Regression harness for the rendering. At every VBlank it hashes the top and bottom screen
+ * framebuffers that are displayed and writes the hashes with the frame number to a log, so that
+ * the output of two builds can be compared on the same movie. The frames can also be dumped as
+ * PNG images at a fixed interval.
+ */
+class FrameHasher {
+public:
+    /**
+     * @param log_path File to write a "frame top_hash bottom_hash" line to for every frame
+     * @param dump_directory Directory to write the PNG images to, or empty to not dump images
+     * @param dump_interval Number of frames between two dumped frames
+     */
+    FrameHasher(Memory::MemorySystem& memory, const std::string& log_path,
+                std::string dump_directory = "", u32 dump_interval = 60);
+    ~FrameHasher();
+
+    /// Returns whether the log could be opened.
+    bool IsOpen() const;
+
+    /// Returns the number of frames hashed so far.
+    u32 GetFrameCount() const;
+
+    /// Screen contents, upright, in RGBA8 with the red component in the first byte.
+    struct Image {
+        u32 width = 0;
+        u32 height = 0;
+        std::vector<u8> pixels;
+    };
+
+    /// Reads the framebuffer displayed on a screen (0 for the top, 1 for the bottom screen).
+    static Image ReadScreen(Memory::MemorySystem& memory, int screen);
+
+    /// Writes an image as a PNG file. Returns whether it succeeded.
+    static bool WritePNG(const std::string& path, const Image& image);
+
+private:
+    void OnVBlank();
+
+    Memory::MemorySystem& memory;
+    FileUtil::IOFile log;
+    std::string dump_directory;
+    u32 dump_interval;
+    u32 frame = 0;
+    std::size_t vblank_callback_id;
+};
+
+} // namespace Core
@@ -0,0 +1,157 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "common/logging/log.h"
+#include "core/arm/arm_interface.h"
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/guest_sampler.h"
+#include "core/hle/kernel/process.h"
+#include "core/hle/kernel/thread.h"
+
+namespace Core {
+
+std::size_t GuestSampler::SampleKeyHash::operator()(const SampleKey& key) const {
+    u64 hash = (static_cast<u64>(key.process_id) << 32) ^ key.thread_id;
+    hash = hash * 0x9E3779B97F4A7C15 ^ key.pc;
+    hash = hash * 0x9E3779B97F4A7C15 ^ key.lr;
+    return static_cast<std::size_t>(hash ^ (hash >> 29));
+}
+
+GuestSampler::GuestSampler(System& system, Timing& timing) : system(system), timing(timing) {
+    event = timing.RegisterEvent(
+        "GuestSampler::TakeSample",
+        [this](u64 /*userdata*/, s64 cycles_late) { TakeSample(cycles_late); });
+}
+
+GuestSampler::~GuestSampler() {
+    Stop();
+}
+
+void GuestSampler::Start(u32 samples_per_second) {
+    Stop();
+    interval_cycles =
+        static_cast<s64>(BASE_CLOCK_RATE_ARM11 / std::max<u32>(samples_per_second, 1));
+    running = true;
+    timing.ScheduleEvent(interval_cycles, event);
+    LOG_INFO(Core, "Sampling guest code {} times per second", samples_per_second);
+}
+
+void GuestSampler::Stop() {
+    if (running) {
+        timing.UnscheduleEvent(event, 0);
+        running = false;
+    }
+}
+
+bool GuestSampler::IsRunning() const {
+    return running;
+}
+
+void GuestSampler::Clear() {
+    std::lock_guard lock{mutex};
+    samples.clear();
+    sample_count = 0;
+    idle_count = 0;
+}
+
+void GuestSampler::AddModule(u32 process_id, const std::string& name, VAddr address, u32 size) {
+    std::lock_guard lock{mutex};
+    modules[process_id][address] = {name, size};
+}
+
+void GuestSampler::RemoveModule(u32 process_id, VAddr address) {
+    std::lock_guard lock{mutex};
+    const auto process_modules = modules.find(process_id);
+    if (process_modules != modules.end()) {
+        process_modules->second.erase(address);
+    }
+}
+
+u64 GuestSampler::GetSampleCount() const {
+    std::lock_guard lock{mutex};
+    return sample_count;
+}
+
+void GuestSampler::TakeSample(s64 cycles_late) {
+    timing.ScheduleEvent(interval_cycles - cycles_late, event);
+
+    const Kernel::Thread* thread = system.Kernel().GetThreadManager().GetCurrentThread();
+    if (thread == nullptr) {
+        RecordSample(nullptr, 0, 0, 0);
+        return;
+    }
+
+    const ARM_Interface& cpu = system.CPU();
+    // Clear the Thumb bit of return addresses
+    RecordSample(thread->owner_process, thread->GetThreadId(), cpu.GetPC(), cpu.GetReg(14) & ~1u);
+}
+
+void GuestSampler::RecordSample(const Kernel::Process* process, u32 thread_id, VAddr pc,
+                                VAddr lr) {
+    std::lock_guard lock{mutex};
+    ++sample_count;
+    if (process == nullptr) {
+        ++idle_count;
+        return;
+    }
+
+    const SampleKey key{process->process_id, thread_id, pc, lr};
+    Sample& sample = samples[key];
+    if (sample.count++ == 0) {
+        const std::string process_name = process->GetName();
+        const auto& code = process->codeset->CodeSegment();
+        const VAddr code_end = code.addr + code.size;
+        sample.stack = fmt::format(
+            "{};thread {};{};{}", process_name, key.thread_id,
+            Symbolize(key.process_id, process_name, code.addr, code_end, key.lr),
+            Symbolize(key.process_id, process_name, code.addr, code_end, key.pc));
+    }
+}
+
+std::string GuestSampler::Symbolize(u32 process_id, const std::string& process_name,
+                                    VAddr code_begin, VAddr code_end, VAddr address) const {
+    if (address >= code_begin && address < code_end) {
+        // The code of the process is always loaded at the same address, so keep it absolute
+        return fmt::format("{}!0x{:08X}", process_name, address);
+    }
+
+    const auto process_modules = modules.find(process_id);
+    if (process_modules != modules.end()) {
+        auto it = process_modules->second.upper_bound(address);
+        if (it != process_modules->second.begin()) {
+            --it;
+            if (address - it->first < it->second.size) {
+                return fmt::format("{}+0x{:X}", it->second.name, address - it->first);
+            }
+        }
+    }
+    return fmt::format("0x{:08X}", address);
+}
+
+std::string GuestSampler::GetFoldedStacks() const {
+    std::vector<std::pair<std::string, u64>> lines;
+    {
+        std::lock_guard lock{mutex};
+        lines.reserve(samples.size() + 1);
+        for (const auto& [key, sample] : samples) {
+            lines.emplace_back(sample.stack, sample.count);
+        }
+        if (idle_count != 0) {
+            lines.emplace_back("[idle]", idle_count);
+        }
+    }
+    std::sort(lines.begin(), lines.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+
+    std::string folded;
+    for (const auto& [stack, count] : lines) {
+        folded += fmt::format("{} {}\n", stack, count);
+    }
+    return folded;
+}
+
+} // namespace Core
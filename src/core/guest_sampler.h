@@ -0,0 +1,122 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Kernel {
+class Process;
+}
+
+namespace Core {
+
+class System;
+class Timing;
+struct TimingEventType;
+
+/**
+ * Statistical profiler of emulated code. At a fixed rate of emulated time, it records the PC and
+ * LR of the running guest thread, which works the same with every CPU backend. Addresses are
+ * symbolized against the code segment of the process and the CROs loaded through ldr:ro, and the
+ * samples can be exported as folded stacks for flame graph tools.
+ */
+class GuestSampler {
+public:
+    GuestSampler(System& system, Timing& timing);
+    ~GuestSampler();
+
+    /**
+     * Starts sampling, keeping the samples taken so far.
+     * @param samples_per_second Sampling rate, in samples per second of emulated time
+     */
+    void Start(u32 samples_per_second);
+
+    /// Stops sampling.
+    void Stop();
+
+    bool IsRunning() const;
+
+    /// Drops all samples taken so far.
+    void Clear();
+
+    /// Registers the code of a CRO, so that addresses in it are symbolized with its name.
+    void AddModule(u32 process_id, const std::string& name, VAddr address, u32 size);
+
+    /// Unregisters a CRO that was registered with AddModule.
+    void RemoveModule(u32 process_id, VAddr address);
+
+    /// Returns the number of samples taken so far.
+    u64 GetSampleCount() const;
+
+    /**
+     * Records one sample. This is called with the state of the running thread at every sampling
+     * interval.
+     * @param process Process that owns the running thread, or nullptr if the CPU is idle
+     * @param thread_id Id of the running thread
+     * @param pc Value of the PC register
+     * @param lr Value of the LR register, with the Thumb bit cleared
+     */
+    void RecordSample(const Kernel::Process* process, u32 thread_id, VAddr pc, VAddr lr);
+
+    /**
+     * Formats the samples as folded stacks, one "process;thread;caller;function count" line per
+     * distinct sample, most frequent first. The caller is approximated by the LR register.
+     */
+    std::string GetFoldedStacks() const;
+
+private:
+    struct SampleKey {
+        u32 process_id;
+        u32 thread_id;
+        VAddr pc;
+        VAddr lr;
+
+        bool operator==(const SampleKey& other) const {
+            return process_id == other.process_id && thread_id == other.thread_id &&
+                   pc == other.pc && lr == other.lr;
+        }
+    };
+
+    struct SampleKeyHash {
+        std::size_t operator()(const SampleKey& key) const;
+    };
+
+    struct Sample {
+        /// Symbolized stack, formatted when the sample is first seen
+        std::string stack;
+        u64 count = 0;
+    };
+
+    struct Module {
+        std::string name;
+        u32 size;
+    };
+
+    void TakeSample(s64 cycles_late);
+
+    /// Formats an address as module+offset. `mutex` must be held.
+    std::string Symbolize(u32 process_id, const std::string& process_name, VAddr code_begin,
+                          VAddr code_end, VAddr address) const;
+
+    System& system;
+    Timing& timing;
+    TimingEventType* event;
+    s64 interval_cycles = 0;
+    bool running = false;
+
+    mutable std::mutex mutex; ///< Protects the data below, which is read when exporting
+    std::unordered_map<SampleKey, Sample, SampleKeyHash> samples;
+    u64 sample_count = 0;
+    u64 idle_count = 0;
+    /// Loaded CROs by process id and code address
+    std::unordered_map<u32, std::map<VAddr, Module>> modules;
+};
+
+} // namespace Core
@@ -63,6 +63,7 @@ std::shared_ptr<Event> HLERequestContext::SleepClientThread(const std::string& r
 
     if (timeout.count() > 0)
         thread->WakeAfterDelay(timeout.count());
+    sleep_timeout = timeout;
 
     return event;
 }
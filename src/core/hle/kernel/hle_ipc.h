@@ -8,6 +8,7 @@
 #include <array>
 #include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -192,6 +193,11 @@ public:
                                              std::chrono::nanoseconds timeout,
                                              WakeupCallback&& callback);
 
+    /// Returns the timeout of the SleepClientThread call made while handling this request, if any.
+    std::optional<std::chrono::nanoseconds> GetSleepTimeout() const {
+        return sleep_timeout;
+    }
+
     /**
      * Resolves a object id from the request command buffer into a pointer to an object. See the
      * "HLE handle protocol" section in the class documentation for more details.
@@ -245,6 +251,7 @@ private:
     std::array<std::vector<u8>, IPC::MAX_STATIC_BUFFERS> static_buffers;
     // The mapped buffers will be created when the IPC request is translated
     boost::container::small_vector<MappedBuffer, 8> request_mapped_buffers;
+    std::optional<std::chrono::nanoseconds> sleep_timeout;
 };
 
 } // namespace Kernel
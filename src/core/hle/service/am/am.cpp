@@ -323,7 +323,9 @@ bool CIAFile::Close() const {
     return true;
 }
 
-void CIAFile::Flush() const {}
+bool CIAFile::Flush() const {
+    return true;
+}
 
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback) {
@@ -1129,7 +1131,9 @@ public:
     bool Close() const override {
         return false;
     }
-    void Flush() const override {}
+    bool Flush() const override {
+        return true;
+    }
 
 private:
     std::shared_ptr<Service::FS::File> file;
@@ -9,6 +9,7 @@
 #include <system_error>
 #include <type_traits>
 #include <utility>
+#include <fmt/format.h>
 #include "common/assert.h"
 #include "common/common_types.h"
 #include "common/file_util.h"
@@ -27,6 +28,7 @@
 #include "core/file_sys/file_backend.h"
 #include "core/hle/result.h"
 #include "core/hle/service/fs/archive.h"
+#include "core/settings.h"
 
 namespace Service::FS {
 
@@ -85,8 +87,13 @@ ArchiveManager::OpenFileFromArchive(ArchiveHandle archive_handle, const FileSys:
         return std::make_tuple(FileSys::ERR_INVALID_ARCHIVE_HANDLE,
                                static_cast<std::chrono::nanoseconds>(0));
 
-    std::chrono::nanoseconds open_timeout_ns{archive->GetOpenDelayNs()};
+    const std::chrono::nanoseconds open_timeout_ns =
+        ScaleDelay(delay_profile.GetOpenDelayNs(archive->GetOpenDelayNs()));
+
+    const auto start_time = std::chrono::steady_clock::now();
     auto backend = archive->OpenFile(path, mode);
+    const std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - start_time;
+    open_statistics.Record(0, latency.count(), open_timeout_ns.count());
     if (backend.Failed())
         return std::make_tuple(backend.Code(), open_timeout_ns);
 
@@ -94,6 +101,36 @@ ArchiveManager::OpenFileFromArchive(ArchiveHandle archive_handle, const FileSys:
     return std::make_tuple(MakeResult<std::shared_ptr<File>>(std::move(file)), open_timeout_ns);
 }
 
+std::chrono::nanoseconds ArchiveManager::AdjustReadDelay(std::size_t length, u64 delay_ns,
+                                                         std::chrono::nanoseconds latency) {
+    const std::chrono::nanoseconds read_timeout_ns =
+        ScaleDelay(delay_profile.GetReadDelayNs(length, delay_ns));
+    read_statistics.Record(length, latency.count(), read_timeout_ns.count());
+    return read_timeout_ns;
+}
+
+void ArchiveManager::LoadDelayProfile(u64 program_id) {
+    delay_profile = {};
+    const std::string path =
+        fmt::format("{}{:016X}.txt",
+                    FileUtil::GetUserPath(FileUtil::UserPath::FSDelayProfilesDir), program_id);
+    std::string text;
+    if (!FileUtil::Exists(path) || FileUtil::ReadFileToString(true, path, text) == 0) {
+        return;
+    }
+    if (const auto profile = FileSys::ParseDelayProfile(text)) {
+        LOG_INFO(Service_FS, "Using the FS delay profile {}", path);
+        delay_profile = *profile;
+    } else {
+        LOG_ERROR(Service_FS, "Could not parse the FS delay profile {}", path);
+    }
+}
+
+std::chrono::nanoseconds ArchiveManager::ScaleDelay(u64 delay_ns) const {
+    const u64 percentage = delay_profile.percentage.value_or(Settings::values.fs_delay_percentage);
+    return std::chrono::nanoseconds{delay_ns * percentage / 100};
+}
+
 ResultCode ArchiveManager::DeleteFileFromArchive(ArchiveHandle archive_handle,
                                                  const FileSys::Path& path) {
     ArchiveBackend* archive = GetArchive(archive_handle);
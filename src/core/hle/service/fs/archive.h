@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -11,6 +12,7 @@
 #include <boost/container/flat_map.hpp>
 #include "common/common_types.h"
 #include "core/file_sys/archive_backend.h"
+#include "core/file_sys/delay_generator.h"
 #include "core/hle/result.h"
 #include "core/hle/service/fs/directory.h"
 #include "core/hle/service/fs/file.h"
@@ -233,7 +235,37 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /**
+     * Applies the delay profile and the configured FS delay scale to the delay of a file read,
+     * and records the read in the read statistics.
+     * @param length Length in bytes of the read
+     * @param delay_ns Delay reported by the file's delay generator
+     * @param latency Time the host took to serve the read
+     * @return The delay the client thread should be put to sleep for
+     */
+    std::chrono::nanoseconds AdjustReadDelay(std::size_t length, u64 delay_ns,
+                                             std::chrono::nanoseconds latency);
+
+    /**
+     * Loads the FS delay profile of a title, from <program ID>.txt in the FS delay profile
+     * directory. Without a profile, the default timing is used.
+     */
+    void LoadDelayProfile(u64 program_id);
+
+    /// Returns the histogram of file reads performed since the archive manager was created
+    const FileSys::DelayHistogram& GetReadStatistics() const {
+        return read_statistics;
+    }
+
+    /// Returns the histogram of file opens performed since the archive manager was created
+    const FileSys::DelayHistogram& GetOpenStatistics() const {
+        return open_statistics;
+    }
+
 private:
+    /// Scales a delay by the percentage of the delay profile, or the configured FS delay percentage
+    std::chrono::nanoseconds ScaleDelay(u64 delay_ns) const;
+
     Core::System& system;
 
     /**
@@ -260,6 +292,10 @@ private:
      */
     std::unordered_map<ArchiveHandle, std::unique_ptr<ArchiveBackend>> handle_map;
     ArchiveHandle next_handle = 1;
+
+    FileSys::DelayProfile delay_profile;
+    FileSys::DelayHistogram read_statistics;
+    FileSys::DelayHistogram open_statistics;
 };
 
 } // namespace Service::FS
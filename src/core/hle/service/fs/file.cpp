@@ -11,6 +11,7 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/fs/archive.h"
 #include "core/hle/service/fs/file.h"
 
 namespace Service::FS {
@@ -59,7 +60,9 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
 
     std::vector<u8> data(length);
+    const auto start_time = std::chrono::steady_clock::now();
     ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
+    const std::chrono::nanoseconds latency = std::chrono::steady_clock::now() - start_time;
     if (read.Failed()) {
         rb.Push(read.Code());
         rb.Push<u32>(0);
@@ -70,7 +73,8 @@ void File::Read(Kernel::HLERequestContext& ctx) {
     }
     rb.PushMappedBuffer(buffer);
 
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+    std::chrono::nanoseconds read_timeout_ns =
+        system.ArchiveManager().AdjustReadDelay(length, backend->GetReadDelayNs(length), latency);
     ctx.SleepClientThread("file::read", read_timeout_ns,
                           [](std::shared_ptr<Kernel::Thread> /*thread*/,
                              Kernel::HLERequestContext& /*ctx*/,
@@ -168,8 +172,7 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    backend->Flush();
-    rb.Push(RESULT_SUCCESS);
+    rb.Push(backend->Flush() ? RESULT_SUCCESS : FileSys::ERROR_INSUFFICIENT_SPACE);
 }
 
 void File::SetPriority(Kernel::HLERequestContext& ctx) {
@@ -7,6 +7,7 @@
 #include "common/logging/log.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
+#include "core/guest_sampler.h"
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/kernel/process.h"
 #include "core/hle/service/ldr_ro/cro_helper.h"
@@ -315,6 +316,11 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
 
     system.CPU().InvalidateCacheRange(cro_address, cro_size);
 
+    if (exe_begin) {
+        system.GuestSampler().AddModule(process->process_id, cro.ModuleName(), exe_begin,
+                                        exe_size);
+    }
+
     LOG_INFO(Service_LDR, "CRO \"{}\" loaded at 0x{:08X}, fixed_end=0x{:08X}", cro.ModuleName(),
              cro_address, cro_address + fix_size);
 
@@ -358,6 +364,10 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
 
     u32 fixed_size = cro.GetFixedSize();
 
+    if (auto [exe_begin, exe_size] = cro.GetExecutablePages(); exe_begin) {
+        system.GuestSampler().RemoveModule(process->process_id, exe_begin);
+    }
+
     cro.Unregister(slot->loaded_crs);
 
     ResultCode result = cro.Unlink(slot->loaded_crs);
@@ -3,10 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cryptopp/osrng.h>
 #include "common/common_types.h"
 #include "common/logging/log.h"
+#include "common/metrics.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/ipc_helpers.h"
@@ -49,13 +51,14 @@ std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sen
                                              return packet.transmitter_address == sender;
                                          });
         if (beacon != received_beacons.end()) {
-            filtered_list.push_back(*beacon);
             // TODO(B3N30): Check if the complete deque is cleared or just the fetched entries
-            received_beacons.erase(beacon);
+            filtered_list.splice(filtered_list.end(), received_beacons, beacon);
         }
         return filtered_list;
     }
-    return std::move(received_beacons);
+    std::list<Network::WifiPacket> beacons;
+    beacons.swap(received_beacons);
+    return beacons;
 }
 
 /// Sends a WifiPacket to the room we're currently connected to.
@@ -136,8 +139,13 @@ void NWM_UDS::HandleBeaconFrame(const Network::WifiPacket& packet) {
                          return new_packet.transmitter_address == packet.transmitter_address;
                      });
     if (unique_beacon != received_beacons.end()) {
-        // We already have a beacon from the same mac in the deque, remove the old one;
-        received_beacons.erase(unique_beacon);
+        // We already have a beacon from the same mac in the deque, replace the old one and move
+        // it to the back. This reuses the memory of the old beacon.
+        unique_beacon->data.assign(packet.data.begin(), packet.data.end());
+        unique_beacon->channel = packet.channel;
+        unique_beacon->destination_address = packet.destination_address;
+        received_beacons.splice(received_beacons.end(), received_beacons, unique_beacon);
+        return;
     }
 
     received_beacons.emplace_back(packet);
@@ -347,8 +355,29 @@ void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
         channel_info->second.network_node_id != secure_data.src_node_id)
         return;
 
+    const std::size_t data_size = secure_data.GetActualDataSize();
+    if (data_size > MaxDataFrameSize ||
+        sizeof(LLCHeader) + sizeof(SecureDataHeader) + data_size > packet.data.size()) {
+        LOG_ERROR(Service_NWM, "Ignored SecureDataPacket with invalid size {}", data_size);
+        return;
+    }
+
+    static auto& received_metric = Common::Metrics::GetCounter(
+        "citra_uds_frames_received_total", "UDS data frames queued on a bind node");
+    static auto& dropped_metric =
+        Common::Metrics::GetCounter("citra_uds_frames_dropped_total",
+                                    "UDS data frames dropped because a receive buffer was full");
+
     // Add the received packet to the data queue.
-    channel_info->second.received_packets.emplace_back(packet.data);
+    if (!channel_info->second.received_packets->Push(
+            secure_data.src_node_id,
+            packet.data.data() + sizeof(LLCHeader) + sizeof(SecureDataHeader), data_size)) {
+        // The application is not pulling frames fast enough, drop the frame like the hardware
+        // does once the receive buffer is full.
+        dropped_metric.Increment();
+        return;
+    }
+    received_metric.Increment();
 
     // Signal the data event. We can do this directly because we locked g_hle_lock
     channel_info->second.event->Signal();
@@ -537,7 +566,7 @@ void NWM_UDS::Shutdown(Kernel::HLERequestContext& ctx) {
     if (auto room_member = Network::GetRoomMember().lock())
         room_member->Unbind(wifi_packet_received);
 
-    for (auto bind_node : channel_data) {
+    for (auto& bind_node : channel_data) {
         bind_node.second.event->Signal();
     }
     channel_data.clear();
@@ -774,7 +803,13 @@ void NWM_UDS::Bind(Kernel::HLERequestContext& ctx) {
 
     ASSERT(channel_data.find(data_channel) == channel_data.end());
     // TODO(B3N30): Support more than one bind node per channel.
-    channel_data[data_channel] = {bind_node_id, data_channel, network_node_id, event};
+    // The receive buffers of the bind nodes are carved out of the shared memory block given to
+    // Initialize, which bounds what the guest can ask for.
+    const std::size_t queue_capacity =
+        recv_buffer_memory ? std::min<std::size_t>(recv_buffer_size, recv_buffer_memory->GetSize())
+                           : recv_buffer_size;
+    channel_data[data_channel] = {bind_node_id, data_channel, network_node_id, event,
+                                  std::make_unique<ReceiveQueue>(queue_capacity)};
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(RESULT_SUCCESS);
@@ -953,7 +988,7 @@ void NWM_UDS::DestroyNetwork(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
-    for (auto bind_node : channel_data) {
+    for (auto& bind_node : channel_data) {
         bind_node.second.event->Signal();
     }
     channel_data.clear();
@@ -999,7 +1034,7 @@ void NWM_UDS::DisconnectNetwork(Kernel::HLERequestContext& ctx) {
 
     SendPacket(deauth);
 
-    for (auto bind_node : channel_data) {
+    for (auto& bind_node : channel_data) {
         bind_node.second.event->Signal();
     }
     channel_data.clear();
@@ -1053,8 +1088,7 @@ void NWM_UDS::SendTo(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    constexpr std::size_t MaxSize = 0x5C6;
-    if (data_size > MaxSize) {
+    if (data_size > MaxDataFrameSize) {
         rb.Push(ResultCode(ErrorDescription::TooLarge, ErrorModule::UDS,
                            ErrorSummary::WrongArgument, ErrorLevel::Usage));
         return;
@@ -1113,7 +1147,8 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    if (channel->second.received_packets.empty()) {
+    ReceiveQueue& queue = *channel->second.received_packets;
+    if (queue.Empty()) {
         std::vector<u8> output_buffer(buff_size, 0);
         IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
         rb.Push(RESULT_SUCCESS);
@@ -1123,10 +1158,7 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    const auto& next_packet = channel->second.received_packets.front();
-
-    auto secure_data = ParseSecureDataHeader(next_packet);
-    auto data_size = secure_data.GetActualDataSize();
+    const u32 data_size = static_cast<u32>(queue.FrontSize());
 
     if (data_size > max_out_buff_size) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1137,17 +1169,51 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
 
     IPC::RequestBuilder rb = rp.MakeBuilder(3, 2);
 
+    static auto& latency_metric = Common::Metrics::GetSummary(
+        "citra_uds_queue_latency_seconds",
+        "Time UDS data frames were queued before being pulled by the application");
+
     std::vector<u8> output_buffer(buff_size, 0);
     // Write the actual data.
-    std::memcpy(output_buffer.data(),
-                next_packet.data() + sizeof(LLCHeader) + sizeof(SecureDataHeader), data_size);
+    queue.CopyFront(output_buffer.data());
 
     rb.Push(RESULT_SUCCESS);
     rb.Push<u32>(data_size);
-    rb.Push<u16>(secure_data.src_node_id);
-    rb.PushStaticBuffer(output_buffer, 0);
+    rb.Push<u16>(queue.FrontSender());
+    rb.PushStaticBuffer(std::move(output_buffer), 0);
+
+    latency_metric.Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                                         queue.FrontReceiveTime())
+                               .count());
+    queue.Pop();
+}
+
+NWM_UDS::ReceiveQueue::ReceiveQueue(std::size_t capacity) : ring(capacity) {}
+
+bool NWM_UDS::ReceiveQueue::Push(u16 src_node_id, const u8* data, std::size_t size) {
+    if (used + size + FrameOverhead > ring.size()) {
+        return false;
+    }
+    // The overhead is only accounted for, so the payloads always fit into the ring
+    const std::size_t first_copy = std::min(size, ring.size() - write_offset);
+    std::memcpy(ring.data() + write_offset, data, first_copy);
+    std::memcpy(ring.data(), data + first_copy, size - first_copy);
+    frames.push_back({write_offset, size, src_node_id, std::chrono::steady_clock::now()});
+    write_offset = (write_offset + size) % ring.size();
+    used += size + FrameOverhead;
+    return true;
+}
+
+void NWM_UDS::ReceiveQueue::CopyFront(u8* output) const {
+    const Frame& frame = frames.front();
+    const std::size_t first_copy = std::min(frame.size, ring.size() - frame.offset);
+    std::memcpy(output, ring.data() + frame.offset, first_copy);
+    std::memcpy(output + first_copy, ring.data(), frame.size - first_copy);
+}
 
-    channel->second.received_packets.pop_front();
+void NWM_UDS::ReceiveQueue::Pop() {
+    used -= frames.front().size + FrameOverhead;
+    frames.pop_front();
 }
 
 void NWM_UDS::GetChannel(Kernel::HLERequestContext& ctx) {
@@ -6,6 +6,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <deque>
 #include <list>
@@ -38,6 +39,9 @@ using MacAddress = std::array<u8, 6>;
 const std::size_t ApplicationDataSize = 0xC8;
 const u8 DefaultNetworkChannel = 11;
 
+// Maximum size of the data that can be sent in a single SendTo call.
+constexpr std::size_t MaxDataFrameSize = 0x5C6;
+
 // Number of milliseconds in a TU.
 const double MillisecondsPerTU = 1.024;
 // Interval measured in TU, the default value is 100TU = 102.4ms
@@ -431,7 +435,7 @@ private:
 
     /**
      * Returns a list of received 802.11 beacon frames from the specified sender since the last
-     * call.
+     * call. The beacons are moved out of the list of received beacons rather than copied.
      */
     std::list<Network::WifiPacket> GetReceivedBeacons(const MacAddress& sender);
 
@@ -498,13 +502,69 @@ private:
     // Node information about our own system.
     NodeInfo current_node;
 
+    /**
+     * Data frames received on a bind node that were not pulled yet. Like the receive buffer whose
+     * size the application passes to Bind, it holds a limited number of bytes and frames that do
+     * not fit are dropped. The payloads are stored back to back in a byte ring allocated at Bind.
+     */
+    class ReceiveQueue {
+    public:
+        /// Bytes of the receive buffer taken by each frame besides its payload. The minimum size
+        /// of a receive buffer, 0x5F4, holds exactly one frame of MaxDataFrameSize.
+        static constexpr std::size_t FrameOverhead = 0x5F4 - MaxDataFrameSize;
+
+        explicit ReceiveQueue(std::size_t capacity);
+
+        /// Queues a frame. Returns false if it does not fit into the receive buffer.
+        bool Push(u16 src_node_id, const u8* data, std::size_t size);
+
+        bool Empty() const {
+            return frames.empty();
+        }
+
+        /// Returns the size of the payload of the frame at the head of the queue.
+        std::size_t FrontSize() const {
+            return frames.front().size;
+        }
+
+        /// Returns the network node id of the sender of the frame at the head of the queue.
+        u16 FrontSender() const {
+            return frames.front().src_node_id;
+        }
+
+        /// Returns the time the frame at the head of the queue was received.
+        std::chrono::steady_clock::time_point FrontReceiveTime() const {
+            return frames.front().receive_time;
+        }
+
+        /// Copies the payload of the frame at the head of the queue to `output`.
+        void CopyFront(u8* output) const;
+
+        void Pop();
+
+    private:
+        struct Frame {
+            std::size_t offset; ///< Start of the payload in the ring.
+            std::size_t size;   ///< Size of the payload.
+            u16 src_node_id;    ///< Network node id of the sender.
+            std::chrono::steady_clock::time_point receive_time;
+        };
+
+        std::vector<u8> ring;
+        std::deque<Frame> frames;
+        std::size_t write_offset = 0;
+        /// Bytes of the receive buffer in use, including the overhead of each frame.
+        std::size_t used = 0;
+    };
+
     struct BindNodeData {
         u32 bind_node_id;    ///< Id of the bind node associated with this data.
         u8 channel;          ///< Channel that this bind node was bound to.
         u16 network_node_id; ///< Node id this bind node is associated with, only packets from this
                              /// network node will be received.
-        std::shared_ptr<Kernel::Event> event;         ///< Receive event for this bind node.
-        std::deque<std::vector<u8>> received_packets; ///< List of packets received on this channel.
+        std::shared_ptr<Kernel::Event> event; ///< Receive event for this bind node.
+        /// Packets received on this channel.
+        std::unique_ptr<ReceiveQueue> received_packets;
     };
 
     // Mapping of data channels to their internal data.
@@ -9,6 +9,7 @@
 #include "core/hle/ipc_helpers.h"
 #include "core/hle/service/ps/ps_ps.h"
 #include "core/hw/aes/arithmetic128.h"
+#include "core/hw/aes/ctr.h"
 #include "core/hw/aes/key.h"
 
 namespace Service::PS {
@@ -85,17 +86,11 @@ void PS_PS::EncryptDecryptAes(Kernel::HLERequestContext& ctx) {
 
     std::vector<u8> dst_buffer(src_buffer.size());
     switch (algorithm) {
-    case AlgorithmType::CTR_Encrypt: {
-        CryptoPP::CTR_Mode<AES>::Encryption aes;
-        aes.SetKeyWithIV(key.data(), AES::BLOCKSIZE, iv.data());
-        aes.ProcessData(dst_buffer.data(), src_buffer.data(), src_buffer.size());
-        break;
-    }
-
+    case AlgorithmType::CTR_Encrypt:
     case AlgorithmType::CTR_Decrypt: {
-        CryptoPP::CTR_Mode<AES>::Decryption aes;
-        aes.SetKeyWithIV(key.data(), AES::BLOCKSIZE, iv.data());
-        aes.ProcessData(dst_buffer.data(), src_buffer.data(), src_buffer.size());
+        // Encryption and decryption are the same operation in CTR mode
+        dst_buffer = src_buffer;
+        HW::AES::CTRCipher(key, iv).Process(dst_buffer.data(), dst_buffer.size(), 0);
         break;
     }
 
@@ -3,9 +3,12 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <chrono>
 #include <fmt/format.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/metrics.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/hle/ipc.h"
 #include "core/hle/kernel/client_port.h"
@@ -48,6 +51,7 @@
 #include "core/hle/service/pxi/pxi.h"
 #include "core/hle/service/qtm/qtm.h"
 #include "core/hle/service/service.h"
+#include "core/hle/service/service_stats.h"
 #include "core/hle/service/sm/sm.h"
 #include "core/hle/service/sm/srv.h"
 #include "core/hle/service/soc_u.h"
@@ -146,7 +150,11 @@ void ServiceFrameworkBase::RegisterHandlersBase(const FunctionInfoBase* function
     handlers.reserve(handlers.size() + n);
     for (std::size_t i = 0; i < n; ++i) {
         // Usually this array is sorted by id already, so hint to insert at the end
-        handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
+        auto it =
+            handlers.emplace_hint(handlers.cend(), functions[i].expected_header, functions[i]);
+        if (it->second.name != nullptr) {
+            it->second.statistics = &GetCallStatistics().Get(service_name, it->second.name);
+        }
     }
 }
 
@@ -172,6 +180,10 @@ void ServiceFrameworkBase::ReportUnimplementedFunction(u32* cmd_buf, const Funct
 }
 
 void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context) {
+    static auto& requests_metric =
+        Common::Metrics::GetCounter("citra_hle_requests_total", "IPC requests to HLE services");
+    requests_metric.Increment();
+
     u32 header_code = context.CommandBuffer()[0];
     auto itr = handlers.find(header_code);
     const FunctionInfoBase* info = itr == handlers.end() ? nullptr : &itr->second;
@@ -181,7 +193,13 @@ void ServiceFrameworkBase::HandleSyncRequest(Kernel::HLERequestContext& context)
 
     LOG_TRACE(Service, "{}",
               MakeFunctionString(info->name, GetServiceName(), context.CommandBuffer()));
+    Common::Trace::ScopedEvent trace_event("HLE IPC", info->name);
+    const auto start = std::chrono::steady_clock::now();
     handler_invoker(this, info->handler_callback, context);
+    if (info->statistics != nullptr) {
+        info->statistics->Record(std::chrono::steady_clock::now() - start,
+                                 context.GetSleepTimeout());
+    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +224,7 @@ static bool AttemptLLE(const ServiceModuleInfo& service_module) {
 
 /// Initialize ServiceManager
 void Init(Core::System& core) {
+    GetCallStatistics().Reset();
     SM::ServiceManager::InstallInterfaces(core);
 
     for (const auto& service_module : service_module_map) {
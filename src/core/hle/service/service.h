@@ -28,6 +28,8 @@ class ServerSession;
 
 namespace Service {
 
+struct CommandStatistics;
+
 namespace SM {
 class ServiceManager;
 }
@@ -77,6 +79,7 @@ private:
         u32 expected_header;
         HandlerFnP<ServiceFrameworkBase> handler_callback;
         const char* name;
+        CommandStatistics* statistics = nullptr; ///< Set when the handler is registered
     };
 
     using InvokerFn = void(ServiceFrameworkBase* object, HandlerFnP<ServiceFrameworkBase> member,
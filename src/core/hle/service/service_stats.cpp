@@ -0,0 +1,154 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <fmt/format.h>
+#include "core/hle/service/service_stats.h"
+
+namespace Service {
+
+static std::size_t GetLog2Bucket(u64 value) {
+    std::size_t bucket = 0;
+    while (value > 1 && bucket < CommandStatistics::NumBuckets - 1) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void CommandStatistics::Record(std::chrono::nanoseconds host_time,
+                               std::optional<std::chrono::nanoseconds> sleep_timeout) {
+    // Only the emulation thread writes, so relaxed loads and stores are enough
+    const u64 host_ns = static_cast<u64>(host_time.count());
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total_host_ns.store(total_host_ns.load(std::memory_order_relaxed) + host_ns,
+                        std::memory_order_relaxed);
+    if (host_ns > max_host_ns.load(std::memory_order_relaxed)) {
+        max_host_ns.store(host_ns, std::memory_order_relaxed);
+    }
+    auto& bucket = host_buckets[GetLog2Bucket(host_ns)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (sleep_timeout) {
+        sleep_count.store(sleep_count.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+        // A negative timeout means that the thread sleeps until it is woken up by an event
+        if (sleep_timeout->count() > 0) {
+            total_sleep_ns.store(total_sleep_ns.load(std::memory_order_relaxed) +
+                                     static_cast<u64>(sleep_timeout->count()),
+                                 std::memory_order_relaxed);
+        }
+    }
+}
+
+void CommandStatistics::Reset() {
+    count = 0;
+    total_host_ns = 0;
+    max_host_ns = 0;
+    sleep_count = 0;
+    total_sleep_ns = 0;
+    for (auto& bucket : host_buckets) {
+        bucket = 0;
+    }
+}
+
+u64 CommandStatisticsEntry::GetHostTimePercentile(double percentile) const {
+    const u64 target = static_cast<u64>(count * percentile / 100.0);
+    u64 seen = 0;
+    for (std::size_t i = 0; i < host_buckets.size(); ++i) {
+        seen += host_buckets[i];
+        if (seen > target) {
+            // Report the upper bound of the bucket, but never more than the real maximum
+            return std::min<u64>(u64{2} << i, max_host_ns);
+        }
+    }
+    return max_host_ns;
+}
+
+CommandStatistics& CallStatistics::Get(const std::string& service_name,
+                                       const std::string& function_name) {
+    std::lock_guard lock{mutex};
+    auto& statistics = commands[{service_name, function_name}];
+    if (!statistics) {
+        statistics = std::make_unique<CommandStatistics>();
+    }
+    return *statistics;
+}
+
+void CallStatistics::Reset() {
+    std::lock_guard lock{mutex};
+    for (auto& [name, statistics] : commands) {
+        statistics->Reset();
+    }
+}
+
+std::vector<CommandStatisticsEntry> CallStatistics::GetEntries() const {
+    std::vector<CommandStatisticsEntry> entries;
+    {
+        std::lock_guard lock{mutex};
+        for (const auto& [name, statistics] : commands) {
+            CommandStatisticsEntry entry;
+            entry.count = statistics->count.load(std::memory_order_relaxed);
+            if (entry.count == 0) {
+                continue;
+            }
+            entry.service_name = name.first;
+            entry.function_name = name.second;
+            entry.total_host_ns = statistics->total_host_ns.load(std::memory_order_relaxed);
+            entry.max_host_ns = statistics->max_host_ns.load(std::memory_order_relaxed);
+            entry.sleep_count = statistics->sleep_count.load(std::memory_order_relaxed);
+            entry.total_sleep_ns = statistics->total_sleep_ns.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < entry.host_buckets.size(); ++i) {
+                entry.host_buckets[i] =
+                    statistics->host_buckets[i].load(std::memory_order_relaxed);
+            }
+            entries.push_back(std::move(entry));
+        }
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.total_host_ns > b.total_host_ns;
+    });
+    return entries;
+}
+
+std::string CallStatistics::FormatCSV() const {
+    std::string csv = "service,function,count,total_host_ns,max_host_ns,p50_host_ns,p99_host_ns,"
+                      "sleep_count,total_sleep_ns";
+    for (std::size_t i = 0; i < CommandStatistics::NumBuckets; ++i) {
+        csv += fmt::format(",host_ns_log2_{}", i);
+    }
+    csv += '\n';
+    for (const auto& entry : GetEntries()) {
+        csv += fmt::format("{},{},{},{},{},{},{},{},{}", entry.service_name, entry.function_name,
+                           entry.count, entry.total_host_ns, entry.max_host_ns,
+                           entry.GetHostTimePercentile(50), entry.GetHostTimePercentile(99),
+                           entry.sleep_count, entry.total_sleep_ns);
+        for (const u64 bucket : entry.host_buckets) {
+            csv += fmt::format(",{}", bucket);
+        }
+        csv += '\n';
+    }
+    return csv;
+}
+
+std::string CallStatistics::FormatSummary(std::size_t max_entries) const {
+    const auto entries = GetEntries();
+    std::string summary = fmt::format("{:<32} {:>10} {:>12} {:>10} {:>10} {:>12}", "Command",
+                                      "Calls", "Host ms", "p99 us", "Sleeps", "Sleep ms");
+    for (std::size_t i = 0; i < std::min(entries.size(), max_entries); ++i) {
+        const auto& entry = entries[i];
+        summary += fmt::format("\n{:<32} {:>10} {:>12.3f} {:>10.1f} {:>10} {:>12.3f}",
+                               entry.service_name + "::" + entry.function_name, entry.count,
+                               entry.total_host_ns / 1e6, entry.GetHostTimePercentile(99) / 1e3,
+                               entry.sleep_count, entry.total_sleep_ns / 1e6);
+    }
+    return summary;
+}
+
+CallStatistics& GetCallStatistics() {
+    static CallStatistics statistics;
+    return statistics;
+}
+
+} // namespace Service
@@ -0,0 +1,88 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Service {
+
+/**
+ * Statistics of the calls to one command of an HLE service. Updated by the emulation thread and
+ * readable from any thread, so that they can be exported while a game is running.
+ */
+struct CommandStatistics {
+    static constexpr std::size_t NumBuckets = 32;
+
+    /**
+     * Records a call of the command.
+     * @param host_time Host time spent in the handler
+     * @param sleep_timeout Emulated time the client thread was put to sleep for, if it was
+     */
+    void Record(std::chrono::nanoseconds host_time,
+                std::optional<std::chrono::nanoseconds> sleep_timeout);
+
+    void Reset();
+
+    std::atomic<u64> count{0};
+    std::atomic<u64> total_host_ns{0};
+    std::atomic<u64> max_host_ns{0};
+    std::atomic<u64> sleep_count{0};    ///< Calls that put the client thread to sleep
+    std::atomic<u64> total_sleep_ns{0}; ///< Emulated delay of the sleeps with a timeout
+    /// Calls per log2 of the host time in nanoseconds
+    std::array<std::atomic<u64>, NumBuckets> host_buckets{};
+};
+
+/// A copy of the statistics of one command, taken for reports.
+struct CommandStatisticsEntry {
+    std::string service_name;
+    std::string function_name;
+    u64 count;
+    u64 total_host_ns;
+    u64 max_host_ns;
+    u64 sleep_count;
+    u64 total_sleep_ns;
+    std::array<u64, CommandStatistics::NumBuckets> host_buckets;
+
+    /// Returns an estimate of the given percentile (0-100) of the host time, from the histogram
+    u64 GetHostTimePercentile(double percentile) const;
+};
+
+/// Statistics of the calls to all HLE service commands since emulation started.
+class CallStatistics {
+public:
+    /// Returns the statistics of a command, creating them if needed. The reference stays valid.
+    CommandStatistics& Get(const std::string& service_name, const std::string& function_name);
+
+    /// Clears the statistics of all commands.
+    void Reset();
+
+    /// Returns a copy of the statistics of all called commands, busiest first.
+    std::vector<CommandStatisticsEntry> GetEntries() const;
+
+    /// Formats the statistics of all called commands as CSV with a header line.
+    std::string FormatCSV() const;
+
+    /// Formats the commands with the most host time as a table for the log.
+    std::string FormatSummary(std::size_t max_entries) const;
+
+private:
+    mutable std::mutex mutex;
+    std::map<std::pair<std::string, std::string>, std::unique_ptr<CommandStatistics>> commands;
+};
+
+/// Returns the statistics shared by all HLE services.
+CallStatistics& GetCallStatistics();
+
+} // namespace Service
@@ -0,0 +1,28 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "core/hw/aes/ctr.h"
+
+namespace HW::AES {
+
+struct CTRCipher::Impl {
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption cipher;
+};
+
+CTRCipher::CTRCipher(const AESKey& key, const AESKey& ctr) : impl(std::make_unique<Impl>()) {
+    impl->cipher.SetKeyWithIV(key.data(), key.size(), ctr.data());
+}
+
+CTRCipher::~CTRCipher() = default;
+
+void CTRCipher::Process(u8* data, std::size_t size, u64 offset) {
+    if (size == 0)
+        return; // Crypto++ does not like zero size buffer
+    impl->cipher.Seek(offset);
+    impl->cipher.ProcessData(data, data, size);
+}
+
+} // namespace HW::AES
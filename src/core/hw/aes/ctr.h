@@ -0,0 +1,40 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include "common/common_types.h"
+#include "core/hw/aes/key.h"
+
+namespace HW::AES {
+
+/**
+ * AES-128 cipher in CTR mode. The key schedule is expanded once on construction, so the same
+ * object can be used for many random-access reads of a single encrypted stream.
+ */
+class CTRCipher {
+public:
+    /**
+     * @param key The normal key used for the stream
+     * @param ctr The initial counter of the stream
+     */
+    CTRCipher(const AESKey& key, const AESKey& ctr);
+    ~CTRCipher();
+
+    /**
+     * Encrypts or decrypts data in place
+     * @param data The data to process
+     * @param size The size of the data in bytes
+     * @param offset The byte offset of the data in the stream
+     */
+    void Process(u8* data, std::size_t size, u64 offset);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace HW::AES
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#include <map>
+#include <mutex>
 #include <numeric>
 #include <type_traits>
 #include "common/alignment.h"
@@ -11,6 +13,7 @@
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp.h"
 #include "core/hw/gpu.h"
@@ -34,6 +37,11 @@ const u64 frame_ticks = static_cast<u64>(BASE_CLOCK_RATE_ARM11 / SCREEN_REFRESH_
 /// Event id for CoreTiming
 static Core::TimingEventType* vblank_event;
 
+/// Functions called at every VBlank, by registration id
+static std::map<std::size_t, std::function<void()>> vblank_callbacks;
+static std::size_t next_vblank_callback_id = 0;
+static std::mutex vblank_callbacks_mutex;
+
 template <typename T>
 inline void Read(T& var, const u32 raw_addr) {
     u32 addr = raw_addr - HW::VADDR_GPU;
@@ -407,6 +415,8 @@ inline void Write(u32 addr, const T data) {
         auto& config = g_regs.memory_fill_config[is_second_filler];
 
         if (config.trigger) {
+            Core::PerfStats::ScopedComponent perf_component(
+                Core::System::GetInstance().perf_stats, Core::PerfStats::Component::GPU);
             MemoryFill(config);
             LOG_TRACE(HW_GPU, "MemoryFill from {:#010X} to {:#010X}", config.GetStartAddress(),
                       config.GetEndAddress());
@@ -431,6 +441,8 @@ inline void Write(u32 addr, const T data) {
 
     case GPU_REG_INDEX(display_transfer_config.trigger): {
         MICROPROFILE_SCOPE(GPU_DisplayTransfer);
+        Core::PerfStats::ScopedComponent perf_component(Core::System::GetInstance().perf_stats,
+                                                        Core::PerfStats::Component::GPU);
 
         const auto& config = g_regs.display_transfer_config;
         if (config.trigger & 1) {
@@ -470,6 +482,8 @@ inline void Write(u32 addr, const T data) {
         const auto& config = g_regs.command_processor_config;
         if (config.trigger & 1) {
             MICROPROFILE_SCOPE(GPU_CmdlistProcessing);
+            Core::PerfStats::ScopedComponent perf_component(
+                Core::System::GetInstance().perf_stats, Core::PerfStats::Component::GPU);
 
             u32* buffer = (u32*)g_memory->GetPhysicalPointer(config.GetPhysicalAddress());
 
@@ -522,6 +536,13 @@ static void VBlankCallback(u64 userdata, s64 cycles_late) {
     Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PDC0);
     Service::GSP::SignalInterrupt(Service::GSP::InterruptId::PDC1);
 
+    {
+        std::lock_guard lock{vblank_callbacks_mutex};
+        for (const auto& [id, callback] : vblank_callbacks) {
+            callback();
+        }
+    }
+
     // Reschedule recurrent event
     Core::System::GetInstance().CoreTiming().ScheduleEvent(frame_ticks - cycles_late, vblank_event);
 }
@@ -569,4 +590,16 @@ void Shutdown() {
     LOG_DEBUG(HW_GPU, "shutdown OK");
 }
 
+std::size_t RegisterVBlankCallback(std::function<void()> callback) {
+    std::lock_guard lock{vblank_callbacks_mutex};
+    const std::size_t id = next_vblank_callback_id++;
+    vblank_callbacks.emplace(id, std::move(callback));
+    return id;
+}
+
+void UnregisterVBlankCallback(std::size_t id) {
+    std::lock_guard lock{vblank_callbacks_mutex};
+    vblank_callbacks.erase(id);
+}
+
 } // namespace GPU
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include <type_traits>
 #include "common/assert.h"
 #include "common/bit_field.h"
@@ -335,4 +336,14 @@ void Init(Memory::MemorySystem& memory);
 /// Shutdown hardware
 void Shutdown();
 
+/**
+ * Registers a function that is called on the emulation thread at every VBlank, after the frame
+ * was presented.
+ * @returns An id to unregister the function with
+ */
+std::size_t RegisterVBlankCallback(std::function<void()> callback);
+
+/// Unregisters a function registered with RegisterVBlankCallback.
+void UnregisterVBlankCallback(std::size_t id);
+
 } // namespace GPU
@@ -0,0 +1,97 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+#include <fmt/format.h>
+#include "common/logging/log.h"
+#include "common/metrics.h"
+#include "core/metrics_server.h"
+
+namespace Core {
+
+using boost::asio::ip::tcp;
+
+/// Requests are only read to find their end, so their size is limited to keep clients honest.
+constexpr std::size_t MaxRequestSize = 8192;
+
+class MetricsServer::Impl {
+public:
+    explicit Impl(u16 port)
+        : acceptor(io_context, tcp::endpoint(boost::asio::ip::address_v4::loopback(), port)) {
+        StartAccept();
+        worker_thread = std::thread([this] { io_context.run(); });
+    }
+
+    ~Impl() {
+        io_context.stop();
+        worker_thread.join();
+    }
+
+private:
+    class Session : public std::enable_shared_from_this<Session> {
+    public:
+        explicit Session(tcp::socket socket) : socket(std::move(socket)), request(MaxRequestSize) {}
+
+        void Start() {
+            boost::asio::async_read_until(
+                socket, request, "\r\n\r\n",
+                [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                    self->HandleRequest(error);
+                });
+        }
+
+    private:
+        void HandleRequest(const boost::system::error_code& error) {
+            if (error) {
+                LOG_WARNING(Core, "Failed to receive metrics request: {}", error.message());
+                return;
+            }
+            const std::string body = Common::Metrics::ExportText();
+            reply = fmt::format("HTTP/1.0 200 OK\r\n"
+                                "Content-Type: text/plain; version=0.0.4\r\n"
+                                "Content-Length: {}\r\n"
+                                "Connection: close\r\n"
+                                "\r\n"
+                                "{}",
+                                body.size(), body);
+            boost::asio::async_write(
+                socket, boost::asio::buffer(reply),
+                [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                    if (error) {
+                        LOG_WARNING(Core, "Failed to send metrics: {}", error.message());
+                    }
+                    boost::system::error_code ignored;
+                    self->socket.shutdown(tcp::socket::shutdown_both, ignored);
+                });
+        }
+
+        tcp::socket socket;
+        boost::asio::streambuf request;
+        std::string reply;
+    };
+
+    void StartAccept() {
+        acceptor.async_accept([this](const boost::system::error_code& error, tcp::socket socket) {
+            if (error) {
+                LOG_WARNING(Core, "Failed to accept metrics connection: {}", error.message());
+            } else {
+                std::make_shared<Session>(std::move(socket))->Start();
+            }
+            StartAccept();
+        });
+    }
+
+    boost::asio::io_context io_context;
+    tcp::acceptor acceptor;
+    std::thread worker_thread;
+};
+
+MetricsServer::MetricsServer(u16 port) : impl(std::make_unique<Impl>(port)) {}
+
+MetricsServer::~MetricsServer() = default;
+
+} // namespace Core
@@ -0,0 +1,26 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <memory>
+#include "common/common_types.h"
+
+namespace Core {
+
+/**
+ * Serves the metrics of Common::Metrics over HTTP on the loopback interface, so that Prometheus
+ * can scrape a running emulator. Every request gets the full export, whatever its path.
+ */
+class MetricsServer {
+public:
+    explicit MetricsServer(u16 port);
+    ~MetricsServer();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace Core
@@ -2,8 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <cstdlib>
 #include <cstring>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <boost/optional.hpp>
 #include <cryptopp/hex.h>
@@ -25,7 +27,7 @@ namespace Core {
 
 /*static*/ Movie Movie::s_instance;
 
-enum class PlayMode { None, Recording, Playing };
+enum class PlayMode { None, Recording, Playing, NetPlay };
 
 enum class ControllerStateType : u8 {
     PadAndCircle,
@@ -107,6 +109,8 @@ struct ControllerState {
     };
 };
 static_assert(sizeof(ControllerState) == 7, "ControllerState should be 7 bytes");
+static_assert(sizeof(ControllerState) == sizeof(Movie::InputState),
+              "InputState should have the size of ControllerState");
 #pragma pack(pop)
 
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'T', 'M', 0x1B}};
@@ -129,6 +133,9 @@ bool Movie::IsPlayingInput() const {
 bool Movie::IsRecordingInput() const {
     return play_mode == PlayMode::Recording;
 }
+bool Movie::IsNetPlayInput() const {
+    return play_mode == PlayMode::NetPlay;
+}
 
 void Movie::CheckInputEnd() {
     if (current_byte + sizeof(ControllerState) > recorded_input.size()) {
@@ -437,6 +444,107 @@ void Movie::StartRecording(const std::string& movie_file) {
     record_movie_file = movie_file;
 }
 
+void Movie::StartNetPlay(NetPlayInputCallback input_callback) {
+    LOG_INFO(Movie, "Enabling netplay input");
+    play_mode = PlayMode::NetPlay;
+    netplay_input_callback = std::move(input_callback);
+    recorded_input.clear();
+    current_byte = 0;
+}
+
+void Movie::StopNetPlay() {
+    if (!IsNetPlayInput()) {
+        return;
+    }
+    play_mode = PlayMode::None;
+    netplay_input_callback = nullptr;
+    recorded_input.clear();
+    current_byte = 0;
+}
+
+/// Key by which analog values are merged: the distance from the neutral position, and the values
+/// themselves to break ties.
+static std::tuple<int, int, int, int> AnalogKey(int x, int y, int z = 0, int neutral = 0) {
+    return {std::abs(x - neutral) + std::abs(y - neutral) + std::abs(z - neutral), x, y, z};
+}
+
+void Movie::MergeInputStates(InputState& state, const InputState& other) {
+    ControllerState s;
+    ControllerState o;
+    std::memcpy(&s, state.data(), sizeof(ControllerState));
+    std::memcpy(&o, other.data(), sizeof(ControllerState));
+
+    if (s.type != o.type) {
+        LOG_ERROR(Movie, "Tried to merge input of type {} with input of type {}",
+                  static_cast<int>(s.type), static_cast<int>(o.type));
+        return;
+    }
+
+    switch (s.type) {
+    case ControllerStateType::PadAndCircle: {
+        auto& pad = s.pad_and_circle;
+        const auto& other_pad = o.pad_and_circle;
+        pad.hex = static_cast<u16>(pad.hex | other_pad.hex);
+        if (AnalogKey(other_pad.circle_pad_x, other_pad.circle_pad_y) >
+            AnalogKey(pad.circle_pad_x, pad.circle_pad_y)) {
+            pad.circle_pad_x = other_pad.circle_pad_x;
+            pad.circle_pad_y = other_pad.circle_pad_y;
+        }
+        break;
+    }
+    case ControllerStateType::Touch: {
+        // Prefer a touch over no touch, then the touch with the larger position.
+        const auto touch_key = [](const auto& touch) {
+            return std::make_tuple(touch.valid, static_cast<u16>(touch.x),
+                                   static_cast<u16>(touch.y));
+        };
+        if (touch_key(o.touch) > touch_key(s.touch)) {
+            s.touch = o.touch;
+        }
+        break;
+    }
+    case ControllerStateType::Accelerometer:
+        if (AnalogKey(o.accelerometer.x, o.accelerometer.y, o.accelerometer.z) >
+            AnalogKey(s.accelerometer.x, s.accelerometer.y, s.accelerometer.z)) {
+            s.accelerometer = o.accelerometer;
+        }
+        break;
+    case ControllerStateType::Gyroscope:
+        if (AnalogKey(o.gyroscope.x, o.gyroscope.y, o.gyroscope.z) >
+            AnalogKey(s.gyroscope.x, s.gyroscope.y, s.gyroscope.z)) {
+            s.gyroscope = o.gyroscope;
+        }
+        break;
+    case ControllerStateType::IrRst:
+        if (AnalogKey(o.ir_rst.x, o.ir_rst.y) > AnalogKey(s.ir_rst.x, s.ir_rst.y)) {
+            s.ir_rst.x = o.ir_rst.x;
+            s.ir_rst.y = o.ir_rst.y;
+        }
+        s.ir_rst.zl |= o.ir_rst.zl;
+        s.ir_rst.zr |= o.ir_rst.zr;
+        break;
+    case ControllerStateType::ExtraHidResponse: {
+        // The C-Stick of the Circle Pad Pro is centered at 0x800.
+        constexpr int c_stick_center = 0x800;
+        auto& response = s.extra_hid_response;
+        const auto& other_response = o.extra_hid_response;
+        if (AnalogKey(other_response.c_stick_x, other_response.c_stick_y, 0, c_stick_center) >
+            AnalogKey(response.c_stick_x, response.c_stick_y, 0, c_stick_center)) {
+            response.c_stick_x.Assign(other_response.c_stick_x);
+            response.c_stick_y.Assign(other_response.c_stick_y);
+        }
+        response.zl_not_held.Assign(response.zl_not_held & other_response.zl_not_held);
+        response.zr_not_held.Assign(response.zr_not_held & other_response.zr_not_held);
+        response.r_not_held.Assign(response.r_not_held & other_response.r_not_held);
+        response.battery_level.Assign(
+            std::max<u32>(response.battery_level, other_response.battery_level));
+        break;
+    }
+    }
+
+    std::memcpy(state.data(), &s, sizeof(ControllerState));
+}
+
 static boost::optional<CTMHeader> ReadHeader(const std::string& movie_file) {
     FileUtil::IOFile save_record(movie_file, "rb");
     const u64 size = save_record.GetSize();
@@ -492,6 +600,7 @@ void Movie::Shutdown() {
     }
 
     play_mode = PlayMode::None;
+    netplay_input_callback = nullptr;
     recorded_input.resize(0);
     record_movie_file.clear();
     current_byte = 0;
@@ -506,6 +615,17 @@ void Movie::Handle(Targs&... Fargs) {
         CheckInputEnd();
     } else if (IsRecordingInput()) {
         Record(Fargs...);
+    } else if (IsNetPlayInput()) {
+        // Convert the local input to the movie format, let the netplay session replace it with
+        // the input of all players and apply that instead.
+        current_byte = 0;
+        Record(Fargs...);
+        InputState state;
+        std::memcpy(state.data(), recorded_input.data(), state.size());
+        netplay_input_callback(state);
+        std::memcpy(recorded_input.data(), state.data(), state.size());
+        current_byte = 0;
+        Play(Fargs...);
     }
 }
 
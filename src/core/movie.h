@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <array>
 #include <functional>
+#include <string>
 #include "common/common_types.h"
 
 namespace Service {
@@ -33,6 +35,15 @@ public:
         GameDismatch,
         Invalid,
     };
+
+    /// A single input state in the format it is stored in movie files.
+    using InputState = std::array<u8, 7>;
+
+    /**
+     * Called for every input state during netplay. Receives the local input state and replaces
+     * it with the input state to apply.
+     */
+    using NetPlayInputCallback = std::function<void(InputState& state)>;
     /**
      * Gets the instance of the Movie singleton class.
      * @returns Reference to the instance of the Movie singleton class.
@@ -45,6 +56,22 @@ public:
                        std::function<void()> completion_callback = [] {});
     void StartRecording(const std::string& movie_file);
 
+    /**
+     * Starts exchanging every input state through the given callback instead of using the local
+     * input directly.
+     */
+    void StartNetPlay(NetPlayInputCallback input_callback);
+
+    /// Stops exchanging input states. Local input is used directly again.
+    void StopNetPlay();
+
+    /**
+     * Combines the input states of the same kind from several players into `state`. Buttons are
+     * held if any player holds them, and analog values are taken from the player that moves
+     * them furthest. The result does not depend on the order in which states are combined.
+     */
+    static void MergeInputStates(InputState& state, const InputState& other);
+
     /// Prepare to override the clock before playing back movies
     void PrepareForPlayback(const std::string& movie_file);
 
@@ -97,6 +124,7 @@ public:
     void HandleExtraHidResponse(Service::IR::ExtraHIDResponse& extra_hid_response);
     bool IsPlayingInput() const;
     bool IsRecordingInput() const;
+    bool IsNetPlayInput() const;
 
 private:
     static Movie s_instance;
@@ -131,6 +159,7 @@ private:
     std::vector<u8> recorded_input;
     u64 init_time;
     std::function<void()> playback_completion_callback;
+    NetPlayInputCallback netplay_input_callback;
     std::size_t current_byte = 0;
 };
 } // namespace Core
\ No newline at end of file
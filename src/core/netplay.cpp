@@ -0,0 +1,315 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <thread>
+#include "common/hash.h"
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/memory.h"
+#include "core/netplay.h"
+#include "network/network.h"
+#include "network/packet.h"
+
+namespace Core {
+
+/// How often each kind of input is polled per second, in the order of the movie input types.
+constexpr std::array<u32, 6> InputPollRates{{
+    234, // PadAndCircle
+    234, // Touch, polled together with the pad
+    104, // Accelerometer
+    101, // Gyroscope
+    234, // IrRst, approximately, its polling period is set by the game
+    234, // ExtraHidResponse, likewise
+}};
+
+/// Number of pad polls between two memory hashes, about one second.
+constexpr u32 MemoryHashInterval = 234;
+
+/// Size of the part of FCRAM that is hashed each time. Successive hashes cover successive parts.
+constexpr u32 MemoryHashWindowSize = 0x100000;
+
+/// Number of memory hashes to keep for comparison with hashes that arrive late.
+constexpr u32 MaxPendingMemoryHashes = 64;
+
+/// How long to wait for the input of the other players before giving up.
+constexpr std::chrono::seconds InputTimeout{30};
+
+NetPlay::NetPlay(System& system, u32 input_delay_frames) : system(system) {
+    for (std::size_t i = 0; i < NumInputTypes; ++i) {
+        input_delay[i] = (input_delay_frames * InputPollRates[i] + 59) / 60;
+    }
+}
+
+NetPlay::~NetPlay() {
+    Stop();
+}
+
+bool NetPlay::Start(std::size_t num_players_, std::chrono::seconds timeout) {
+    room_member = Network::GetRoomMember().lock();
+    if (!room_member) {
+        LOG_ERROR(Network, "Netplay requires the network to be initialized");
+        return false;
+    }
+
+    LOG_INFO(Network, "Waiting for {} players to join the room", num_players_);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!room_member->IsConnected() ||
+           room_member->GetMemberInformation().size() < num_players_) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            LOG_ERROR(Network, "Timed out waiting for the other players");
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    num_players = num_players_;
+    nickname = room_member->GetNickname();
+    next_poll = {};
+    {
+        std::lock_guard lock(mutex);
+        accepting_packets = true;
+        players.clear();
+    }
+    packet_received = room_member->BindOnNetPlayPacketReceived(
+        [this](const Network::NetPlayPacket& packet) { OnPacketReceived(packet); });
+
+    // Players bind the callback at different times and the room does not keep packets, so every
+    // player announces itself until it has heard from all the others. Players who are already
+    // waiting reply to announcements, which covers the announcements sent before they bound.
+    LOG_INFO(Network, "Waiting for {} players to start the session", num_players - 1);
+    while (true) {
+        SendReady(PacketType::Ready);
+        std::unique_lock lock(mutex);
+        if (input_received.wait_for(lock, std::chrono::milliseconds(100),
+                                    [this] { return players.size() + 1 >= num_players; })) {
+            break;
+        }
+        if (std::chrono::steady_clock::now() > deadline) {
+            lock.unlock();
+            LOG_ERROR(Network, "Timed out waiting for the other players to start the session");
+            Stop();
+            return false;
+        }
+    }
+
+    running = true;
+    Movie::GetInstance().StartNetPlay([this](Movie::InputState& state) { ExchangeInput(state); });
+    LOG_INFO(Network, "Started netplay with {} players and an input delay of {} polls",
+             num_players, input_delay[0]);
+    return true;
+}
+
+void NetPlay::Stop() {
+    if (!room_member) {
+        return;
+    }
+
+    Movie::GetInstance().StopNetPlay();
+    room_member->Unbind(packet_received);
+    room_member.reset();
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+        accepting_packets = false;
+        players.clear();
+        inputs.clear();
+        local_hashes.clear();
+        remote_hashes.clear();
+    }
+    input_received.notify_all();
+}
+
+bool NetPlay::IsRunning() const {
+    return running;
+}
+
+u32 NetPlay::GetDesyncCount() const {
+    return desync_count;
+}
+
+void NetPlay::ExchangeInput(Movie::InputState& state) {
+    const u8 type = state[0];
+    if (!running || type >= NumInputTypes) {
+        return;
+    }
+
+    const u32 poll = next_poll[type]++;
+    const u32 delay = input_delay[type];
+
+    // The first polls are exchanged without delay, so that every poll has an input state from
+    // every player.
+    if (poll < delay) {
+        SendInput(poll, state);
+    }
+    SendInput(poll + delay, state);
+
+    if (type == 0 && poll % MemoryHashInterval == 0) {
+        SendMemoryHash(poll / MemoryHashInterval);
+    }
+
+    std::unique_lock lock(mutex);
+    const u64 key = InputKey(type, poll);
+    const bool received = input_received.wait_for(lock, InputTimeout, [this, key] {
+        return !running || inputs[key].size() >= num_players;
+    });
+    if (!running) {
+        return;
+    }
+    if (!received) {
+        LOG_ERROR(Network, "Timed out waiting for the input of the other players, using local "
+                           "input from now on");
+        running = false;
+        accepting_packets = false;
+        inputs.clear();
+        return;
+    }
+
+    // Merge in the order of the nicknames, so that every player gets the same result
+    auto node = inputs.extract(key);
+    bool first = true;
+    for (const auto& [player, player_state] : node.mapped()) {
+        if (first) {
+            state = player_state;
+            first = false;
+        } else {
+            Movie::MergeInputStates(state, player_state);
+        }
+    }
+}
+
+void NetPlay::SendInput(u32 poll, const Movie::InputState& state) {
+    {
+        std::lock_guard lock(mutex);
+        inputs[InputKey(state[0], poll)][nickname] = state;
+    }
+
+    Network::Packet packet;
+    packet << static_cast<u8>(PacketType::Input);
+    packet << poll;
+    packet << state;
+    room_member->SendNetPlayPacket(std::vector<u8>(
+        static_cast<const u8*>(packet.GetData()),
+        static_cast<const u8*>(packet.GetData()) + packet.GetDataSize()));
+}
+
+void NetPlay::SendReady(PacketType type) {
+    Network::Packet packet;
+    packet << static_cast<u8>(type);
+    room_member->SendNetPlayPacket(std::vector<u8>(
+        static_cast<const u8*>(packet.GetData()),
+        static_cast<const u8*>(packet.GetData()) + packet.GetDataSize()));
+}
+
+void NetPlay::SendMemoryHash(u32 index) {
+    constexpr u32 num_windows = Memory::FCRAM_SIZE / MemoryHashWindowSize;
+    const u32 offset = (index % num_windows) * MemoryHashWindowSize;
+    const u64 hash =
+        Common::ComputeHash64(system.Memory().GetFCRAMPointer(offset), MemoryHashWindowSize);
+
+    {
+        std::lock_guard lock(mutex);
+        local_hashes[index] = hash;
+        while (local_hashes.size() > MaxPendingMemoryHashes) {
+            local_hashes.erase(local_hashes.begin());
+        }
+        const auto remote = remote_hashes.find(index);
+        if (remote != remote_hashes.end()) {
+            for (const u64 remote_hash : remote->second) {
+                CompareMemoryHash(index, remote_hash);
+            }
+            remote_hashes.erase(remote);
+        }
+    }
+
+    Network::Packet packet;
+    packet << static_cast<u8>(PacketType::MemoryHash);
+    packet << index;
+    packet << hash;
+    room_member->SendNetPlayPacket(std::vector<u8>(
+        static_cast<const u8*>(packet.GetData()),
+        static_cast<const u8*>(packet.GetData()) + packet.GetDataSize()));
+}
+
+void NetPlay::CompareMemoryHash(u32 index, u64 remote_hash) {
+    const auto local = local_hashes.find(index);
+    if (local == local_hashes.end() || local->second == remote_hash) {
+        return;
+    }
+    ++desync_count;
+    LOG_ERROR(Network, "Desync detected: memory hash {} is {:016X} here and {:016X} elsewhere",
+              index, local->second, remote_hash);
+}
+
+void NetPlay::OnPacketReceived(const Network::NetPlayPacket& received) {
+    Network::Packet packet(received.data.data(), received.data.size());
+    u8 type;
+    packet >> type;
+
+    std::unique_lock lock(mutex);
+    if (!accepting_packets) {
+        return;
+    }
+
+    const auto packet_type = static_cast<PacketType>(type);
+    if (packet_type == PacketType::Ready || packet_type == PacketType::ReadyReply) {
+        if (running || players.size() + 1 >= num_players) {
+            // Members who arrive once the session is complete do not take part in it
+            if (players.count(received.nickname) == 0) {
+                return;
+            }
+        } else {
+            players.insert(received.nickname);
+        }
+        lock.unlock();
+        if (packet_type == PacketType::Ready) {
+            SendReady(PacketType::ReadyReply);
+        }
+        input_received.notify_all();
+        return;
+    }
+    if (players.count(received.nickname) == 0) {
+        LOG_WARNING(Network, "Ignored netplay packet from {}, who is not a player",
+                    received.nickname);
+        return;
+    }
+
+    switch (packet_type) {
+    case PacketType::Input: {
+        u32 poll;
+        Movie::InputState state;
+        packet >> poll;
+        packet >> state;
+        if (!packet || state[0] >= NumInputTypes) {
+            LOG_ERROR(Network, "Received invalid netplay input from {}", received.nickname);
+            return;
+        }
+        inputs[InputKey(state[0], poll)][received.nickname] = state;
+        lock.unlock();
+        input_received.notify_all();
+        break;
+    }
+    case PacketType::MemoryHash: {
+        u32 index;
+        u64 hash;
+        packet >> index;
+        packet >> hash;
+        if (!packet) {
+            LOG_ERROR(Network, "Received invalid netplay memory hash from {}", received.nickname);
+            return;
+        }
+        if (local_hashes.count(index)) {
+            CompareMemoryHash(index, hash);
+        } else {
+            remote_hashes[index].push_back(hash);
+        }
+        break;
+    }
+    default:
+        LOG_ERROR(Network, "Received unknown netplay packet type {} from {}", type,
+                  received.nickname);
+        break;
+    }
+}
+
+} // namespace Core
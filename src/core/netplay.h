@@ -0,0 +1,128 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "common/common_types.h"
+#include "core/movie.h"
+#include "network/room_member.h"
+
+namespace Core {
+
+class System;
+
+/**
+ * Keeps the input of several instances running the same game in lockstep, using the room that
+ * the instances are connected to. Every input state is sent to the other players in the movie
+ * format, and the merged input of all players is applied on every instance a fixed number of
+ * frames after it was polled. Part of the emulated memory is hashed regularly to detect instances
+ * that are out of sync.
+ *
+ * All instances have to run the same game with the same settings, and have to start the session
+ * before the game polls its first input.
+ */
+class NetPlay {
+public:
+    /**
+     * @param system The system whose input is synchronized.
+     * @param input_delay_frames How many frames to delay the input by, to hide network latency.
+     */
+    NetPlay(System& system, u32 input_delay_frames);
+    ~NetPlay();
+
+    /**
+     * Waits until the given number of members of the room have started the session and starts
+     * synchronizing input with them.
+     * @param num_players Number of players in the session, including this instance.
+     * @param timeout How long to wait for the other players to join.
+     * @returns Whether the session was started.
+     */
+    bool Start(std::size_t num_players, std::chrono::seconds timeout = std::chrono::seconds(60));
+
+    /// Stops synchronizing input. Local input is used directly again.
+    void Stop();
+
+    /// Returns whether input is currently synchronized.
+    bool IsRunning() const;
+
+    /// Returns the number of memory hashes that did not match the ones of another player.
+    u32 GetDesyncCount() const;
+
+private:
+    /// Number of kinds of input states in the movie format.
+    static constexpr std::size_t NumInputTypes = 6;
+
+    enum class PacketType : u8 {
+        Input,
+        MemoryHash,
+        /// Sent while waiting for the other players, once the packet callback is bound.
+        Ready,
+        /// Reply to Ready, so that a player who started late learns about the earlier ones.
+        ReadyReply,
+    };
+
+    /// Sends a packet without payload of the given type to the other players.
+    void SendReady(PacketType type);
+
+    /// Called by Movie for every input state polled by the game.
+    void ExchangeInput(Movie::InputState& state);
+
+    /// Queues an input state for the given poll and sends it to the other players.
+    void SendInput(u32 poll, const Movie::InputState& state);
+
+    /// Hashes a part of FCRAM and sends the hash to the other players.
+    void SendMemoryHash(u32 index);
+
+    /// Compares a hash of another player with the local one. `mutex` must be held.
+    void CompareMemoryHash(u32 index, u64 remote_hash);
+
+    void OnPacketReceived(const Network::NetPlayPacket& packet);
+
+    /// Returns the key of an input state in `inputs`.
+    static u64 InputKey(u8 type, u32 poll) {
+        return (static_cast<u64>(type) << 32) | poll;
+    }
+
+    System& system;
+    std::shared_ptr<Network::RoomMember> room_member;
+    Network::RoomMember::CallbackHandle<Network::NetPlayPacket> packet_received;
+
+    /// Number of polls each kind of input is delayed by.
+    std::array<u32, NumInputTypes> input_delay{};
+    /// Number of polls of each kind of input so far. Only accessed by the emulation thread.
+    std::array<u32, NumInputTypes> next_poll{};
+
+    std::size_t num_players = 0;
+    /// Nickname of this instance in the room, which identifies its input states.
+    std::string nickname;
+    std::atomic<bool> running{false};
+    std::atomic<u32> desync_count{0};
+
+    mutable std::mutex mutex; ///< Protects the data below
+    std::condition_variable input_received;
+    /// Whether packets are handled. Set once the callback is bound, so that the packets of
+    /// players who start first are kept until the session starts here.
+    bool accepting_packets = false;
+    /// Nicknames of the other players, who sent Ready. Packets of other members are ignored.
+    std::set<std::string> players;
+    /// Input states of every player by nickname, for polls that have not been applied yet.
+    std::unordered_map<u64, std::map<std::string, Movie::InputState>> inputs;
+    /// Memory hashes of this instance that were not compared with every other player yet.
+    std::map<u32, u64> local_hashes;
+    /// Memory hashes of other players that arrived before the local hash was taken.
+    std::map<u32, std::vector<u64>> remote_hashes;
+};
+
+} // namespace Core
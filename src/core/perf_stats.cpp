@@ -4,8 +4,12 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <mutex>
 #include <thread>
+#include <vector>
+#include "common/metrics.h"
+#include "common/trace.h"
 #include "core/hw/gpu.h"
 #include "core/perf_stats.h"
 #include "core/settings.h"
@@ -17,27 +21,83 @@ using std::chrono::microseconds;
 
 namespace Core {
 
+PerfStats::ScopedComponent::ScopedComponent(PerfStats& perf_stats, Component component)
+    : perf_stats(perf_stats), component(component), parent(perf_stats.active_component),
+      start(Clock::now()) {
+    perf_stats.active_component = component;
+}
+
+PerfStats::ScopedComponent::~ScopedComponent() {
+    const auto elapsed = Clock::now() - start;
+    perf_stats.component_time[static_cast<std::size_t>(component)] += elapsed;
+    if (parent != Component::Count) {
+        perf_stats.component_time[static_cast<std::size_t>(parent)] -= elapsed;
+    }
+    perf_stats.active_component = parent;
+}
+
 void PerfStats::BeginSystemFrame() {
+    Common::Trace::BeginFrame();
+
     std::lock_guard lock{object_mutex};
 
     frame_begin = Clock::now();
 }
 
 void PerfStats::EndSystemFrame() {
-    std::lock_guard lock{object_mutex};
-
-    auto frame_end = Clock::now();
-    accumulated_frametime += frame_end - frame_begin;
-    system_frames += 1;
+    static auto& frames_metric = Common::Metrics::GetCounter(
+        "citra_system_frames_total", "System frames (LCD VBlanks), its rate is the system FPS");
+    static auto& frame_time_metric = Common::Metrics::GetGauge(
+        "citra_frame_time_seconds", "Walltime of the last system frame, including waits");
+    static auto& speed_metric = Common::Metrics::GetGauge(
+        "citra_emulation_speed", "Ratio of emulated time / walltime of the last system frame");
+
+    {
+        std::lock_guard lock{object_mutex};
+
+        auto frame_end = Clock::now();
+        accumulated_frametime += frame_end - frame_begin;
+        system_frames += 1;
+
+        previous_frame_length = frame_end - previous_frame_end;
+        previous_frame_end = frame_end;
+
+        const double frame_length = duration_cast<DoubleSecs>(previous_frame_length).count();
+        frames_metric.Increment();
+        frame_time_metric.Set(frame_length);
+        if (frame_length > 0.0) {
+            speed_metric.Set(1.0 / GPU::SCREEN_REFRESH_RATE / frame_length);
+        }
+
+        frame_history[frame_history_next] = {previous_frame_length, component_time};
+        frame_history_next = (frame_history_next + 1) % FrameHistorySize;
+        frame_history_size = std::min(frame_history_size + 1, FrameHistorySize);
+        component_time = {};
+    }
 
-    previous_frame_length = frame_end - previous_frame_end;
-    previous_frame_end = frame_end;
+    Common::Trace::EndFrame();
 }
 
 void PerfStats::EndGameFrame() {
+    static auto& frames_metric = Common::Metrics::GetCounter(
+        "citra_game_frames_total", "Game frames (GSP frame submissions), its rate is the game FPS");
+
     std::lock_guard lock{object_mutex};
 
     game_frames += 1;
+    frames_metric.Increment();
+}
+
+void PerfStats::AddAudioCallback(bool underrun, microseconds queued_audio) {
+    static auto& underruns_metric = Common::Metrics::GetCounter(
+        "citra_audio_underruns_total", "Audio output callbacks that ran out of samples");
+
+    audio_callbacks += 1;
+    if (underrun) {
+        audio_underruns += 1;
+        underruns_metric.Increment();
+    }
+    accumulated_audio_latency_us += queued_audio.count();
 }
 
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
@@ -56,6 +116,12 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
 
+    const u32 callbacks = audio_callbacks.exchange(0);
+    results.audio_underruns = audio_underruns.exchange(0);
+    const u64 latency_us = accumulated_audio_latency_us.exchange(0);
+    results.audio_latency = callbacks == 0 ? 0.0 : latency_us / 1'000'000.0 / callbacks;
+    results.frame_time = ComputeFrameTimeStats(system_frames);
+
     // Reset counters
     reset_point = now;
     reset_point_system_us = current_system_time_us;
@@ -66,6 +132,56 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     return results;
 }
 
+PerfStats::FrameTimeStats PerfStats::GetFrameTimeStats(std::size_t num_frames) {
+    std::lock_guard lock{object_mutex};
+    return ComputeFrameTimeStats(num_frames);
+}
+
+void PerfStats::ResetFrameHistory() {
+    std::lock_guard lock{object_mutex};
+    frame_history_next = 0;
+    frame_history_size = 0;
+    previous_frame_end = Clock::now();
+}
+
+PerfStats::FrameTimeStats PerfStats::ComputeFrameTimeStats(std::size_t num_frames) const {
+    FrameTimeStats stats{};
+    num_frames = std::min(num_frames, frame_history_size);
+    if (num_frames == 0) {
+        return stats;
+    }
+
+    std::vector<double> lengths(num_frames);
+    double total_component_time = 0.0;
+    for (std::size_t i = 0; i < num_frames; ++i) {
+        const auto& frame =
+            frame_history[(frame_history_next + FrameHistorySize - 1 - i) % FrameHistorySize];
+        lengths[i] = duration_cast<DoubleSecs>(frame.length).count();
+        for (std::size_t j = 0; j < NumComponents; ++j) {
+            const double time = duration_cast<DoubleSecs>(frame.component_time[j]).count();
+            stats.component_time[j] += time / num_frames;
+            total_component_time += time;
+        }
+        stats.other_time += lengths[i] / num_frames;
+    }
+    stats.other_time = std::max(stats.other_time - total_component_time / num_frames, 0.0);
+
+    std::sort(lengths.begin(), lengths.end());
+    // Nearest-rank percentiles
+    const auto percentile = [&lengths](double p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * lengths.size()));
+        return lengths[std::clamp<std::size_t>(rank, 1, lengths.size()) - 1];
+    };
+    stats.frames = static_cast<u32>(num_frames);
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = lengths.back();
+    stats.hitches = static_cast<u32>(
+        lengths.end() - std::upper_bound(lengths.begin(), lengths.end(), 2.0 * stats.p50));
+    return stats;
+}
+
 double PerfStats::GetLastFrameTimeScale() {
     std::lock_guard lock{object_mutex};
 
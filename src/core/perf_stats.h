@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <mutex>
 #include "common/common_types.h"
 #include "common/thread.h"
@@ -20,6 +22,37 @@ class PerfStats {
 public:
     using Clock = std::chrono::high_resolution_clock;
 
+    /// Parts of the emulator whose time per frame is measured separately.
+    enum class Component : std::size_t {
+        CPU,             ///< ARM11 execution
+        GPU,             ///< GPU command list processing, display transfers and memory fills
+        RasterizerFlush, ///< Flushes and invalidations of the rasterizer cache
+        DSP,             ///< Generation of audio frames
+        FrameLimiting,   ///< Waiting for the frame limiter and vsync
+        Count,
+    };
+    static constexpr std::size_t NumComponents = static_cast<std::size_t>(Component::Count);
+
+    /// Number of most recent frames kept for frame time statistics
+    static constexpr std::size_t FrameHistorySize = 1024;
+
+    /// Distribution of the walltime between the ends of consecutive system frames.
+    struct FrameTimeStats {
+        /// Number of frames the statistics were computed from
+        u32 frames;
+        /// Percentiles and maximum of the frame time, in seconds
+        double p50;
+        double p95;
+        double p99;
+        double max;
+        /// Number of frames that took more than twice the median frame time
+        u32 hitches;
+        /// Average time per frame spent in each component, in seconds
+        std::array<double, NumComponents> component_time;
+        /// Average time per frame not spent in any measured component, in seconds
+        double other_time;
+    };
+
     struct Results {
         /// System FPS (LCD VBlanks) in Hz
         double system_fps;
@@ -29,14 +62,53 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Number of audio output callbacks that ran out of samples
+        u32 audio_underruns;
+        /// Average duration of audio queued for output, in seconds
+        double audio_latency;
+        /// Frame time distribution of the frames since the last reset, at most FrameHistorySize
+        FrameTimeStats frame_time;
+    };
+
+    /**
+     * Measures the time of a scope as time spent in a component. Nested scopes are only counted
+     * in the innermost component. Must only be used on the emulation thread.
+     */
+    class ScopedComponent {
+    public:
+        ScopedComponent(PerfStats& perf_stats, Component component);
+        ~ScopedComponent();
+
+        ScopedComponent(const ScopedComponent&) = delete;
+        ScopedComponent& operator=(const ScopedComponent&) = delete;
+
+    private:
+        PerfStats& perf_stats;
+        Component component;
+        Component parent;
+        Clock::time_point start;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /**
+     * Records one audio output callback. This is lock-free, so it is safe to call from the sink's
+     * audio thread.
+     * @param underrun Whether the callback ran out of samples
+     * @param queued_audio Duration of audio still queued for output
+     */
+    void AddAudioCallback(bool underrun, std::chrono::microseconds queued_audio);
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
+    /// Gets the frame time distribution of the most recent frames, without resetting anything.
+    FrameTimeStats GetFrameTimeStats(std::size_t num_frames = FrameHistorySize);
+
+    /// Drops the recorded frame times, so that frames of a previous game are not included.
+    void ResetFrameHistory();
+
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
      * useful for scaling inputs or outputs moving between the two time domains.
@@ -44,6 +116,15 @@ public:
     double GetLastFrameTimeScale();
 
 private:
+    struct FrameRecord {
+        /// Walltime since the end of the previous frame
+        Clock::duration length;
+        std::array<Clock::duration, NumComponents> component_time;
+    };
+
+    /// Computes statistics of the most recent frames. `object_mutex` must be held.
+    FrameTimeStats ComputeFrameTimeStats(std::size_t num_frames) const;
+
     std::mutex object_mutex;
 
     /// Point when the cumulative counters were reset
@@ -64,6 +145,24 @@ private:
     Clock::time_point frame_begin = reset_point;
     /// Total visible duration (including frame-limiting, etc.) of the previous system frame
     Clock::duration previous_frame_length = Clock::duration::zero();
+
+    /// Cumulative number of audio output callbacks since last reset
+    std::atomic<u32> audio_callbacks{0};
+    /// Cumulative number of audio output callbacks that ran out of samples since last reset
+    std::atomic<u32> audio_underruns{0};
+    /// Sum of the queued audio durations reported by each callback since last reset
+    std::atomic<u64> accumulated_audio_latency_us{0};
+
+    /// Most recent frames, frame_history_next is where the next one is stored
+    std::array<FrameRecord, FrameHistorySize> frame_history{};
+    std::size_t frame_history_next = 0;
+    std::size_t frame_history_size = 0;
+
+    // Only accessed by the emulation thread, so not protected by the mutex
+    /// Time spent in each component since the end of the previous frame
+    std::array<Clock::duration, NumComponents> component_time{};
+    /// Innermost component being measured, Component::Count if none
+    Component active_component = Component::Count;
 };
 
 class FrameLimiter {
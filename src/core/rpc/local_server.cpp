@@ -0,0 +1,271 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "core/rpc/local_server.h"
+#include "core/rpc/packet.h"
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RPC {
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+std::string GetDefaultLocalSocketPath() {
+    // The runtime directory is private to the user, unlike /tmp
+    const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtime_dir != nullptr && runtime_dir[0] != '\0') {
+        return fmt::format("{}/citra-rpc.sock", runtime_dir);
+    }
+    return fmt::format("/tmp/citra-rpc-{}.sock", getuid());
+}
+
+using boost::asio::local::stream_protocol;
+
+class LocalServer::Impl {
+public:
+    Impl(std::string path_, std::function<void(std::unique_ptr<Packet>)> new_request_callback)
+        : path(std::move(path_)), acceptor(io_context),
+          new_request_callback(std::move(new_request_callback)) {
+
+        RemoveStaleSocket();
+        const stream_protocol::endpoint endpoint(path);
+        acceptor.open(endpoint.protocol());
+        // Memory can be written through the socket, so only allow the current user to connect.
+        // The socket is created with these permissions, rather than changed after bind, so that
+        // there is no window in which other users can connect.
+        boost::system::error_code error;
+        const mode_t old_umask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+        acceptor.bind(endpoint, error);
+        umask(old_umask);
+        if (error) {
+            throw boost::system::system_error(error);
+        }
+        acceptor.listen(boost::asio::socket_base::max_listen_connections, error);
+        if (error) {
+            std::remove(path.c_str());
+            throw boost::system::system_error(error);
+        }
+        LOG_INFO(RPC_Server, "Serving on local socket {}", path);
+
+        StartAccept();
+        worker_thread = std::thread([this] { io_context.run(); });
+    }
+
+    ~Impl() {
+        io_context.stop();
+        worker_thread.join();
+
+        // Sessions can outlive the server while their packets are being handled, so close their
+        // sockets before the io_context goes away.
+        for (const auto& weak_session : sessions) {
+            if (const auto session = weak_session.lock()) {
+                session->Close();
+            }
+        }
+        std::remove(path.c_str());
+    }
+
+private:
+    /**
+     * Removes the socket of a previous instance that did not exit cleanly.
+     * @throws std::runtime_error if another instance still serves on the path, or if the path is
+     *         not a socket
+     */
+    void RemoveStaleSocket() {
+        struct stat status;
+        if (lstat(path.c_str(), &status) != 0) {
+            return;
+        }
+        if (!S_ISSOCK(status.st_mode)) {
+            throw std::runtime_error(fmt::format("{} exists and is not a socket", path));
+        }
+        stream_protocol::socket probe(io_context);
+        boost::system::error_code error;
+        probe.connect(stream_protocol::endpoint(path), error);
+        if (!error) {
+            throw std::runtime_error(fmt::format("Another instance is serving on {}", path));
+        }
+        std::remove(path.c_str());
+    }
+
+    class Session : public std::enable_shared_from_this<Session> {
+    public:
+        Session(Impl& server, stream_protocol::socket socket_)
+            : server(server),
+              socket(std::make_unique<stream_protocol::socket>(std::move(socket_))) {}
+
+        void StartRead() {
+            boost::asio::async_read(
+                *socket, boost::asio::buffer(&header, sizeof(header)),
+                [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                    self->HandleHeader(error);
+                });
+        }
+
+        /// Sends a packet. Can be called from any thread.
+        void Send(Packet& packet) {
+            std::vector<u8> buffer(MIN_PACKET_SIZE + packet.GetPacketDataSize());
+            const PacketHeader reply_header = packet.GetHeader();
+            std::memcpy(buffer.data(), &reply_header, sizeof(reply_header));
+            std::memcpy(buffer.data() + MIN_PACKET_SIZE, packet.GetPacketData().data(),
+                        packet.GetPacketDataSize());
+
+            std::lock_guard lock{mutex};
+            if (!socket) {
+                return;
+            }
+            boost::asio::post(socket->get_executor(),
+                              [self = shared_from_this(), buffer = std::move(buffer)]() mutable {
+                                  self->QueueWrite(std::move(buffer));
+                              });
+        }
+
+        /// Closes the socket. Called when the server stops.
+        void Close() {
+            std::lock_guard lock{mutex};
+            socket.reset();
+        }
+
+    private:
+        void HandleHeader(const boost::system::error_code& error) {
+            if (error) {
+                if (error != boost::asio::error::eof) {
+                    LOG_WARNING(RPC_Server, "Failed to receive data on local socket: {}",
+                                error.message());
+                }
+                return;
+            }
+            if (header.packet_size > MAX_LOCAL_PACKET_DATA_SIZE) {
+                LOG_WARNING(RPC_Server, "Received message with wrong size: {}",
+                            header.packet_size);
+                return;
+            }
+            data.resize(header.packet_size);
+            boost::asio::async_read(
+                *socket, boost::asio::buffer(data),
+                [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                    self->HandleData(error);
+                });
+        }
+
+        void HandleData(const boost::system::error_code& error) {
+            if (error) {
+                LOG_WARNING(RPC_Server, "Failed to receive data on local socket: {}",
+                            error.message());
+                return;
+            }
+            const std::weak_ptr<Session> weak_self = shared_from_this();
+            std::function<void(Packet&)> send_reply_callback = [weak_self](Packet& packet) {
+                if (const auto self = weak_self.lock()) {
+                    self->Send(packet);
+                }
+            };
+            // Send the request to the upper layer for handling
+            server.new_request_callback(std::make_unique<Packet>(
+                header, data.data(), std::move(send_reply_callback), MAX_LOCAL_PACKET_DATA_SIZE,
+                shared_from_this()));
+            StartRead();
+        }
+
+        void QueueWrite(std::vector<u8> buffer) {
+            write_queue.push_back(std::move(buffer));
+            if (write_queue.size() == 1) {
+                StartWrite();
+            }
+        }
+
+        void StartWrite() {
+            std::lock_guard lock{mutex};
+            if (!socket) {
+                return;
+            }
+            boost::asio::async_write(
+                *socket, boost::asio::buffer(write_queue.front()),
+                [self = shared_from_this()](const boost::system::error_code& error, std::size_t) {
+                    self->write_queue.pop_front();
+                    if (error) {
+                        LOG_WARNING(RPC_Server, "Failed to send reply: {}", error.message());
+                        self->write_queue.clear();
+                    } else if (!self->write_queue.empty()) {
+                        self->StartWrite();
+                    }
+                });
+        }
+
+        Impl& server;
+        PacketHeader header{};
+        std::vector<u8> data;
+        std::deque<std::vector<u8>> write_queue; ///< Only accessed by the worker thread
+
+        std::mutex mutex; ///< Protects the socket against being closed while sending
+        std::unique_ptr<stream_protocol::socket> socket;
+    };
+
+    void StartAccept() {
+        acceptor.async_accept(
+            [this](const boost::system::error_code& error, stream_protocol::socket socket) {
+                if (error) {
+                    LOG_WARNING(RPC_Server, "Failed to accept local connection: {}",
+                                error.message());
+                } else {
+                    const auto session = std::make_shared<Session>(*this, std::move(socket));
+                    sessions.erase(std::remove_if(sessions.begin(), sessions.end(),
+                                                  [](const auto& s) { return s.expired(); }),
+                                   sessions.end());
+                    sessions.push_back(session);
+                    session->StartRead();
+                }
+                StartAccept();
+            });
+    }
+
+    std::string path;
+    std::thread worker_thread;
+
+    boost::asio::io_context io_context;
+    stream_protocol::acceptor acceptor;
+    /// Only accessed by the worker thread while it runs
+    std::vector<std::weak_ptr<Session>> sessions;
+
+    std::function<void(std::unique_ptr<Packet>)> new_request_callback;
+};
+
+#else
+
+std::string GetDefaultLocalSocketPath() {
+    return {};
+}
+
+class LocalServer::Impl {
+public:
+    Impl(std::string, std::function<void(std::unique_ptr<Packet>)>) {
+        throw std::runtime_error("Local sockets are not supported on this platform");
+    }
+};
+
+#endif
+
+LocalServer::LocalServer(std::string path,
+                         std::function<void(std::unique_ptr<Packet>)> new_request_callback)
+    : impl(std::make_unique<Impl>(std::move(path), std::move(new_request_callback))) {}
+
+LocalServer::~LocalServer() = default;
+
+} // namespace RPC
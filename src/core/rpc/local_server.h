@@ -0,0 +1,40 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace RPC {
+
+class Packet;
+
+/// Returns the path of the local socket when none is configured, in the runtime directory of the
+/// user if there is one.
+std::string GetDefaultLocalSocketPath();
+
+/**
+ * Serves requests over a local stream socket. Unlike UDP, packets can hold up to
+ * MAX_LOCAL_PACKET_DATA_SIZE bytes, and each client has a connection that subscriptions can be
+ * tied to.
+ */
+class LocalServer {
+public:
+    /**
+     * Starts serving on the socket at the given path.
+     * @throws std::runtime_error if the server could not be started, for example because another
+     *         instance is serving on the path
+     */
+    LocalServer(std::string path,
+                std::function<void(std::unique_ptr<Packet>)> new_request_callback);
+    ~LocalServer();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+} // namespace RPC
@@ -1,15 +1,11 @@
-#include <algorithm>
-#include <cstring>
-
 #include "core/rpc/packet.h"
 
 namespace RPC {
 
-Packet::Packet(const PacketHeader& header, u8* data,
-               std::function<void(Packet&)> send_reply_callback)
-    : header(header), send_reply_callback(std::move(send_reply_callback)) {
-
-    std::memcpy(packet_data.data(), data, std::min(header.packet_size, MAX_PACKET_DATA_SIZE));
-}
+Packet::Packet(const PacketHeader& header, const u8* data,
+               std::function<void(Packet&)> send_reply_callback, u32 max_data_size,
+               std::shared_ptr<void> connection)
+    : header(header), packet_data(data, data + header.packet_size), max_data_size(max_data_size),
+      send_reply_callback(std::move(send_reply_callback)), connection(std::move(connection)) {}
 
 }; // namespace RPC
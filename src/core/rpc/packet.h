@@ -4,8 +4,9 @@
 
 #pragma once
 
-#include <array>
 #include <functional>
+#include <memory>
+#include <vector>
 #include "common/common_types.h"
 
 namespace RPC {
@@ -14,6 +15,20 @@ enum class PacketType {
     Undefined = 0,
     ReadMemory,
     WriteMemory,
+    /// Reads a range of the CSV report of HLE service call statistics. The report is taken when
+    /// reading at offset 0, so that the following reads see a consistent copy.
+    ReadServiceStatistics,
+    /// Reads several ranges of memory at once. The request holds a u32 count followed by that
+    /// many address/size pairs, the reply holds the contents of the ranges one after another.
+    ReadMemoryBatch,
+    /// Subscribes to ranges of memory, in the format of ReadMemoryBatch. Their contents are
+    /// copied to a shared memory region at every VBlank. Only available over the local transport.
+    Subscribe,
+    /// Ends a subscription. The request holds the u32 id of the subscription.
+    Unsubscribe,
+    /// Sent by the server after a subscription snapshot was written. Holds the subscription id
+    /// and the frame number of the snapshot.
+    SubscriptionUpdate,
 };
 
 struct PacketHeader {
@@ -28,10 +43,19 @@ constexpr u32 MIN_PACKET_SIZE = sizeof(PacketHeader);
 constexpr u32 MAX_PACKET_DATA_SIZE = 32;
 constexpr u32 MAX_PACKET_SIZE = MIN_PACKET_SIZE + MAX_PACKET_DATA_SIZE;
 constexpr u32 MAX_READ_SIZE = MAX_PACKET_DATA_SIZE;
+/// Maximum data size of requests and replies over the local transport
+constexpr u32 MAX_LOCAL_PACKET_DATA_SIZE = 0x100000;
 
 class Packet {
 public:
-    Packet(const PacketHeader& header, u8* data, std::function<void(Packet&)> send_reply_callback);
+    /**
+     * @param max_data_size Maximum data size of the reply, which depends on the transport
+     * @param connection Object that lives as long as the connection the packet arrived on, if
+     *                   the transport has connections
+     */
+    Packet(const PacketHeader& header, const u8* data,
+           std::function<void(Packet&)> send_reply_callback,
+           u32 max_data_size = MAX_PACKET_DATA_SIZE, std::shared_ptr<void> connection = nullptr);
 
     u32 GetVersion() const {
         return header.version;
@@ -53,12 +77,34 @@ public:
         return header;
     }
 
-    std::array<u8, MAX_PACKET_DATA_SIZE>& GetPacketData() {
+    /// Returns the data of the packet, which holds GetPacketDataSize() bytes.
+    std::vector<u8>& GetPacketData() {
         return packet_data;
     }
 
+    /// Returns the maximum data size of a reply over the transport the packet arrived on.
+    u32 GetMaxDataSize() const {
+        return max_data_size;
+    }
+
+    /// Resizes the data of the packet, keeping its current contents.
     void SetPacketDataSize(u32 size) {
         header.packet_size = size;
+        packet_data.resize(size);
+    }
+
+    void SetPacketType(PacketType type) {
+        header.packet_type = type;
+    }
+
+    /// Returns the connection the packet arrived on, or nullptr for connectionless transports
+    const std::shared_ptr<void>& GetConnection() const {
+        return connection;
+    }
+
+    /// Returns the function that sends replies, which can be used to send more packets later
+    const std::function<void(Packet&)>& GetSendReplyCallback() const {
+        return send_reply_callback;
     }
 
     void SendReply() {
@@ -66,13 +112,12 @@ public:
     }
 
 private:
-    void HandleReadMemory(u32 address, u32 data_size);
-    void HandleWriteMemory(u32 address, const u8* data, u32 data_size);
-
     struct PacketHeader header;
-    std::array<u8, MAX_PACKET_DATA_SIZE> packet_data;
+    std::vector<u8> packet_data;
+    u32 max_data_size;
 
     std::function<void(Packet&)> send_reply_callback;
+    std::shared_ptr<void> connection;
 };
 
 } // namespace RPC
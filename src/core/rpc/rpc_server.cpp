@@ -1,17 +1,46 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <fmt/format.h>
 #include "common/logging/log.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/hle/kernel/process.h"
+#include "core/hle/service/service_stats.h"
+#include "core/hw/gpu.h"
 #include "core/memory.h"
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
+#include "core/rpc/shared_memory.h"
 
 namespace RPC {
 
+/// Magic of subscription snapshots, "CSNP"
+constexpr u32 SNAPSHOT_MAGIC = 0x504E5343;
+
+/**
+ * Header at the start of the shared memory of a subscription. The sequence is odd while the
+ * snapshot is being written, so readers retry when it is odd or changed while they read.
+ */
+struct SnapshotHeader {
+    u32 magic;
+    std::atomic<u32> sequence;
+    u32 frame;
+    u32 data_size;
+};
+static_assert(sizeof(SnapshotHeader) == 16, "SnapshotHeader has incorrect size");
+static_assert(std::atomic<u32>::is_always_lock_free, "Snapshot sequence is not lock free");
+
+/// Maximum total size of the ranges of a subscription
+constexpr u32 MAX_SUBSCRIPTION_SIZE = 0x1000000;
+
 RPCServer::RPCServer() : server(*this) {
     LOG_INFO(RPC_Server, "Starting RPC server ...");
 
     Start();
+    vblank_callback_id = GPU::RegisterVBlankCallback([this] { UpdateSubscriptions(); });
 
     LOG_INFO(RPC_Server, "RPC started.");
 }
@@ -19,21 +48,19 @@ RPCServer::RPCServer() : server(*this) {
 RPCServer::~RPCServer() {
     LOG_INFO(RPC_Server, "Stopping RPC ...");
 
+    GPU::UnregisterVBlankCallback(vblank_callback_id);
     Stop();
 
     LOG_INFO(RPC_Server, "RPC stopped.");
 }
 
 void RPCServer::HandleReadMemory(Packet& packet, u32 address, u32 data_size) {
-    if (data_size > MAX_READ_SIZE) {
-        return;
-    }
+    packet.SetPacketDataSize(data_size);
 
     // Note: Memory read occurs asynchronously from the state of the emulator
     Core::System::GetInstance().Memory().ReadBlock(
         *Core::System::GetInstance().Kernel().GetCurrentProcess(), address,
         packet.GetPacketData().data(), data_size);
-    packet.SetPacketDataSize(data_size);
     packet.SendReply();
 }
 
@@ -52,15 +79,152 @@ void RPCServer::HandleWriteMemory(Packet& packet, u32 address, const u8* data, u
     packet.SendReply();
 }
 
+void RPCServer::HandleReadServiceStatistics(Packet& packet, u32 offset, u32 data_size) {
+    if (offset == 0) {
+        service_statistics = Service::GetCallStatistics().FormatCSV();
+    }
+    if (offset >= service_statistics.size()) {
+        data_size = 0;
+    } else {
+        data_size = std::min<u32>(data_size, static_cast<u32>(service_statistics.size() - offset));
+    }
+    packet.SetPacketDataSize(data_size);
+    if (data_size > 0) {
+        std::memcpy(packet.GetPacketData().data(), service_statistics.data() + offset, data_size);
+    }
+    packet.SendReply();
+}
+
+void RPCServer::HandleReadMemoryBatch(Packet& packet,
+                                      const std::vector<std::pair<u32, u32>>& ranges) {
+    u32 total_size = 0;
+    for (const auto& [address, size] : ranges) {
+        total_size += size;
+    }
+    packet.SetPacketDataSize(total_size);
+
+    // Note: Memory read occurs asynchronously from the state of the emulator
+    auto& system = Core::System::GetInstance();
+    const auto& process = *system.Kernel().GetCurrentProcess();
+    u8* data = packet.GetPacketData().data();
+    for (const auto& [address, size] : ranges) {
+        system.Memory().ReadBlock(process, address, data, size);
+        data += size;
+    }
+    packet.SendReply();
+}
+
+void RPCServer::HandleSubscribe(Packet& packet, std::vector<std::pair<u32, u32>> ranges) {
+    u32 total_size = 0;
+    for (const auto& [address, size] : ranges) {
+        total_size += size;
+    }
+
+    // The id is only used by the request handler thread. The shared memory is created without
+    // holding subscriptions_mutex, so that large regions don't stall the emulation thread.
+    const u32 id = next_subscription_id++;
+    auto shared_memory = std::make_unique<SharedMemory>(
+        fmt::format("/citra-rpc-{}-{}", GetCurrentProcessId(), id),
+        sizeof(SnapshotHeader) + total_size);
+    if (!shared_memory->IsValid()) {
+        packet.SetPacketDataSize(0);
+        packet.SendReply();
+        return;
+    }
+    auto* snapshot_header = new (shared_memory->GetPointer()) SnapshotHeader{};
+    snapshot_header->magic = SNAPSHOT_MAGIC;
+    snapshot_header->data_size = total_size;
+
+    // The reply holds the id, the size of the shared memory and its name
+    const std::string& name = shared_memory->GetName();
+    const u32 shared_memory_size = static_cast<u32>(shared_memory->GetSize());
+    packet.SetPacketDataSize(static_cast<u32>(sizeof(u32) * 2 + name.size()));
+    std::memcpy(packet.GetPacketData().data(), &id, sizeof(id));
+    std::memcpy(packet.GetPacketData().data() + sizeof(u32), &shared_memory_size,
+                sizeof(shared_memory_size));
+    std::memcpy(packet.GetPacketData().data() + sizeof(u32) * 2, name.data(), name.size());
+    // Reply before adding the subscription, so that the client receives the reply before the
+    // first update
+    packet.SendReply();
+
+    std::lock_guard lock{subscriptions_mutex};
+    subscriptions.push_back({id, std::move(ranges), std::move(shared_memory),
+                             packet.GetConnection(), packet.GetSendReplyCallback()});
+}
+
+void RPCServer::HandleUnsubscribe(Packet& packet, u32 subscription_id) {
+    {
+        std::lock_guard lock{subscriptions_mutex};
+        subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                           [subscription_id](const Subscription& subscription) {
+                                               return subscription.id == subscription_id;
+                                           }),
+                            subscriptions.end());
+    }
+    packet.SetPacketDataSize(0);
+    packet.SendReply();
+}
+
+void RPCServer::UpdateSubscriptions() {
+    ++frame_count;
+
+    std::lock_guard lock{subscriptions_mutex};
+    if (subscriptions.empty()) {
+        return;
+    }
+    subscriptions.erase(std::remove_if(subscriptions.begin(), subscriptions.end(),
+                                       [](const Subscription& subscription) {
+                                           return subscription.connection.expired();
+                                       }),
+                        subscriptions.end());
+
+    auto& system = Core::System::GetInstance();
+    const auto process = system.Kernel().GetCurrentProcess();
+    if (!process) {
+        return;
+    }
+    for (const Subscription& subscription : subscriptions) {
+        u8* const pointer = subscription.shared_memory->GetPointer();
+        auto* snapshot_header = reinterpret_cast<SnapshotHeader*>(pointer);
+        const u32 sequence = snapshot_header->sequence.load(std::memory_order_relaxed);
+        snapshot_header->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        // Read on the emulation thread, so that all ranges are from the same frame
+        u8* data = pointer + sizeof(SnapshotHeader);
+        for (const auto& [address, size] : subscription.ranges) {
+            system.Memory().ReadBlock(*process, address, data, size);
+            data += size;
+        }
+        snapshot_header->frame = frame_count;
+        snapshot_header->sequence.store(sequence + 2, std::memory_order_release);
+
+        const std::array<u32, 2> update_data{subscription.id, frame_count};
+        const PacketHeader update_header{CURRENT_VERSION, subscription.id,
+                                         PacketType::SubscriptionUpdate, sizeof(update_data)};
+        Packet update(update_header, reinterpret_cast<const u8*>(update_data.data()),
+                      subscription.send_update_callback);
+        update.SendReply();
+    }
+}
+
 bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     if (packet_header.version <= CURRENT_VERSION) {
         switch (packet_header.packet_type) {
         case PacketType::ReadMemory:
         case PacketType::WriteMemory:
+        case PacketType::ReadServiceStatistics:
             if (packet_header.packet_size >= (sizeof(u32) * 2)) {
                 return true;
             }
             break;
+        case PacketType::ReadMemoryBatch:
+        case PacketType::Subscribe:
+        case PacketType::Unsubscribe:
+            if (packet_header.packet_size >= sizeof(u32)) {
+                return true;
+            }
+            break;
         default:
             break;
         }
@@ -68,34 +232,95 @@ bool RPCServer::ValidatePacket(const PacketHeader& packet_header) {
     return false;
 }
 
+/**
+ * Reads the ranges of ReadMemoryBatch and Subscribe requests.
+ * @returns Whether the request holds as many ranges as it claims, of at most max_total_size bytes
+ */
+static bool ReadRanges(Packet& packet, u32 max_total_size,
+                       std::vector<std::pair<u32, u32>>& ranges) {
+    const u8* data = packet.GetPacketData().data();
+    u32 count = 0;
+    std::memcpy(&count, data, sizeof(count));
+    if (count == 0 || count > (packet.GetPacketDataSize() - sizeof(u32)) / (sizeof(u32) * 2)) {
+        return false;
+    }
+
+    u64 total_size = 0;
+    ranges.resize(count);
+    for (u32 i = 0; i < count; ++i) {
+        const u8* range = data + sizeof(u32) + i * sizeof(u32) * 2;
+        std::memcpy(&ranges[i].first, range, sizeof(u32));
+        std::memcpy(&ranges[i].second, range + sizeof(u32), sizeof(u32));
+        total_size += ranges[i].second;
+    }
+    return total_size > 0 && total_size <= max_total_size;
+}
+
 void RPCServer::HandleSingleRequest(std::unique_ptr<Packet> request_packet) {
     bool success = false;
 
     if (ValidatePacket(request_packet->GetHeader())) {
-        // Currently, all request types use the address/data_size wire format
-        u32 address = 0;
-        u32 data_size = 0;
-        std::memcpy(&address, request_packet->GetPacketData().data(), sizeof(address));
-        std::memcpy(&data_size, request_packet->GetPacketData().data() + sizeof(address),
-                    sizeof(data_size));
-
+        std::vector<std::pair<u32, u32>> ranges;
         switch (request_packet->GetPacketType()) {
-        case PacketType::ReadMemory:
-            if (data_size > 0 && data_size <= MAX_READ_SIZE) {
-                HandleReadMemory(*request_packet, address, data_size);
+        case PacketType::ReadMemoryBatch:
+            if (ReadRanges(*request_packet, request_packet->GetMaxDataSize(), ranges)) {
+                HandleReadMemoryBatch(*request_packet, ranges);
                 success = true;
             }
             break;
-        case PacketType::WriteMemory:
-            if (data_size > 0 && data_size <= MAX_PACKET_DATA_SIZE - (sizeof(u32) * 2)) {
-                const u8* data = request_packet->GetPacketData().data() + (sizeof(u32) * 2);
-                HandleWriteMemory(*request_packet, address, data, data_size);
+        case PacketType::Subscribe:
+            // Updates are sent over the connection, so connectionless transports can't subscribe
+            if (request_packet->GetConnection() &&
+                ReadRanges(*request_packet, MAX_SUBSCRIPTION_SIZE, ranges)) {
+                HandleSubscribe(*request_packet, std::move(ranges));
                 success = true;
             }
             break;
-        default:
+        case PacketType::Unsubscribe: {
+            u32 subscription_id = 0;
+            std::memcpy(&subscription_id, request_packet->GetPacketData().data(),
+                        sizeof(subscription_id));
+            HandleUnsubscribe(*request_packet, subscription_id);
+            success = true;
+            break;
+        }
+        default: {
+            // The other request types use the address/data_size wire format. Statistics reads
+            // send an offset into the report as the address.
+            u32 address = 0;
+            u32 data_size = 0;
+            std::memcpy(&address, request_packet->GetPacketData().data(), sizeof(address));
+            std::memcpy(&data_size, request_packet->GetPacketData().data() + sizeof(address),
+                        sizeof(data_size));
+            const u32 max_data_size = request_packet->GetMaxDataSize();
+
+            switch (request_packet->GetPacketType()) {
+            case PacketType::ReadMemory:
+                if (data_size > 0 && data_size <= max_data_size) {
+                    HandleReadMemory(*request_packet, address, data_size);
+                    success = true;
+                }
+                break;
+            case PacketType::WriteMemory:
+                if (data_size > 0 && data_size <= max_data_size - (sizeof(u32) * 2) &&
+                    data_size <= request_packet->GetPacketDataSize() - (sizeof(u32) * 2)) {
+                    const u8* data = request_packet->GetPacketData().data() + (sizeof(u32) * 2);
+                    HandleWriteMemory(*request_packet, address, data, data_size);
+                    success = true;
+                }
+                break;
+            case PacketType::ReadServiceStatistics:
+                if (data_size > 0 && data_size <= max_data_size) {
+                    HandleReadServiceStatistics(*request_packet, address, data_size);
+                    success = true;
+                }
+                break;
+            default:
+                break;
+            }
             break;
         }
+        }
     }
 
     if (!success) {
@@ -5,9 +5,13 @@
 #pragma once
 
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 #include "common/threadsafe_queue.h"
 #include "core/rpc/server.h"
 
@@ -15,6 +19,7 @@ namespace RPC {
 
 class Packet;
 struct PacketHeader;
+class SharedMemory;
 
 class RPCServer {
 public:
@@ -28,6 +33,11 @@ private:
     void Stop();
     void HandleReadMemory(Packet& packet, u32 address, u32 data_size);
     void HandleWriteMemory(Packet& packet, u32 address, const u8* data, u32 data_size);
+    void HandleReadServiceStatistics(Packet& packet, u32 offset, u32 data_size);
+    void HandleReadMemoryBatch(Packet& packet, const std::vector<std::pair<u32, u32>>& ranges);
+    void HandleSubscribe(Packet& packet, std::vector<std::pair<u32, u32>> ranges);
+    void HandleUnsubscribe(Packet& packet, u32 subscription_id);
+    void UpdateSubscriptions();
     bool ValidatePacket(const PacketHeader& packet_header);
     void HandleSingleRequest(std::unique_ptr<Packet> request);
     void HandleRequestsLoop();
@@ -35,6 +45,23 @@ private:
     Server server;
     Common::SPSCQueue<std::unique_ptr<Packet>> request_queue;
     std::thread request_handler_thread;
+    /// Report returned by ReadServiceStatistics requests, only used by the request handler thread
+    std::string service_statistics;
+
+    struct Subscription {
+        u32 id;
+        std::vector<std::pair<u32, u32>> ranges;
+        std::unique_ptr<SharedMemory> shared_memory;
+        /// The subscription ends when the client disconnects
+        std::weak_ptr<void> connection;
+        std::function<void(Packet&)> send_update_callback;
+    };
+    std::mutex subscriptions_mutex; ///< Protects the subscriptions against the emulation thread
+    std::vector<Subscription> subscriptions;
+    u32 next_subscription_id = 1; ///< Only used by the request handler thread
+    /// Number of VBlanks since the server started, only used by the emulation thread
+    u32 frame_count = 0;
+    std::size_t vblank_callback_id;
 };
 
 } // namespace RPC
@@ -1,8 +1,10 @@
 #include <functional>
 #include "core/core.h"
+#include "core/rpc/local_server.h"
 #include "core/rpc/packet.h"
 #include "core/rpc/rpc_server.h"
 #include "core/rpc/server.h"
+#include "core/settings.h"
 #include "core/rpc/udp_server.h"
 
 namespace RPC {
@@ -21,10 +23,20 @@ void Server::Start() {
     } catch (...) {
         LOG_ERROR(RPC_Server, "Error starting UDP server");
     }
+
+    try {
+        const std::string path = Settings::values.rpc_socket_path.empty()
+                                     ? GetDefaultLocalSocketPath()
+                                     : Settings::values.rpc_socket_path;
+        local_server = std::make_unique<LocalServer>(path, callback);
+    } catch (const std::exception& e) {
+        LOG_ERROR(RPC_Server, "Error starting local server: {}", e.what());
+    }
 }
 
 void Server::Stop() {
     udp_server.reset();
+    local_server.reset();
     NewRequestCallback(nullptr); // Notify the RPC server to end
 }
 
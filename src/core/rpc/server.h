@@ -10,6 +10,7 @@ namespace RPC {
 
 class RPCServer;
 class UDPServer;
+class LocalServer;
 class Packet;
 
 class Server {
@@ -23,6 +24,7 @@ public:
 private:
     RPCServer& rpc_server;
     std::unique_ptr<UDPServer> udp_server;
+    std::unique_ptr<LocalServer> local_server;
 };
 
 } // namespace RPC
@@ -0,0 +1,82 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+#include "common/logging/log.h"
+#include "core/rpc/shared_memory.h"
+
+namespace RPC {
+
+#ifdef _WIN32
+
+u32 GetCurrentProcessId() {
+    return static_cast<u32>(::GetCurrentProcessId());
+}
+
+SharedMemory::SharedMemory(std::string name_, std::size_t size_)
+    : name(std::move(name_)), size(size_) {
+    mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                 static_cast<DWORD>(static_cast<u64>(size) >> 32),
+                                 static_cast<DWORD>(size), name.c_str());
+    if (mapping == nullptr) {
+        LOG_ERROR(RPC_Server, "Could not create shared memory {}: {}", name, GetLastError());
+        return;
+    }
+    pointer = static_cast<u8*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+    if (pointer == nullptr) {
+        LOG_ERROR(RPC_Server, "Could not map shared memory {}: {}", name, GetLastError());
+    }
+}
+
+SharedMemory::~SharedMemory() {
+    if (pointer != nullptr) {
+        UnmapViewOfFile(pointer);
+    }
+    if (mapping != nullptr) {
+        CloseHandle(mapping);
+    }
+}
+
+#else
+
+u32 GetCurrentProcessId() {
+    return static_cast<u32>(getpid());
+}
+
+SharedMemory::SharedMemory(std::string name_, std::size_t size_)
+    : name(std::move(name_)), size(size_) {
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        LOG_ERROR(RPC_Server, "Could not create shared memory {}: {}", name, errno);
+        return;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        void* const mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapped != MAP_FAILED) {
+            pointer = static_cast<u8*>(mapped);
+        }
+    }
+    close(fd);
+    if (pointer == nullptr) {
+        LOG_ERROR(RPC_Server, "Could not map shared memory {}: {}", name, errno);
+        shm_unlink(name.c_str());
+    }
+}
+
+SharedMemory::~SharedMemory() {
+    if (pointer != nullptr) {
+        munmap(pointer, size);
+        shm_unlink(name.c_str());
+    }
+}
+
+#endif
+
+} // namespace RPC
@@ -0,0 +1,54 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include "common/common_types.h"
+
+namespace RPC {
+
+/// Returns the id of the current process, which keeps the names of regions unique per instance.
+u32 GetCurrentProcessId();
+
+/// A named region of memory that other processes on the same machine can map.
+class SharedMemory {
+public:
+    /**
+     * Creates the region. Use IsValid to check whether that succeeded.
+     * @param name Name of the region, "/name" on POSIX systems and "Local\name" on Windows
+     */
+    SharedMemory(std::string name, std::size_t size);
+    ~SharedMemory();
+
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    bool IsValid() const {
+        return pointer != nullptr;
+    }
+
+    u8* GetPointer() const {
+        return pointer;
+    }
+
+    std::size_t GetSize() const {
+        return size;
+    }
+
+    const std::string& GetName() const {
+        return name;
+    }
+
+private:
+    std::string name;
+    std::size_t size;
+    u8* pointer = nullptr;
+#ifdef _WIN32
+    void* mapping = nullptr;
+#endif
+};
+
+} // namespace RPC
@@ -4,6 +4,8 @@
 
 #include <utility>
 #include "audio_core/dsp_interface.h"
+#include "common/file_util.h"
+#include "common/trace.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
 #include "core/hle/service/hid/hid.h"
@@ -23,6 +25,14 @@ void Apply() {
     GDBStub::SetServerPort(values.gdbstub_port);
     GDBStub::ToggleServer(values.use_gdbstub);
 
+    if (values.trace_buffer_size != 0) {
+        Common::Trace::Enable(values.trace_buffer_size,
+                              std::chrono::milliseconds(values.trace_slow_frame_ms),
+                              FileUtil::GetUserPath(FileUtil::UserPath::LogDir));
+    } else {
+        Common::Trace::Disable();
+    }
+
     VideoCore::g_hw_renderer_enabled = values.use_hw_renderer;
     VideoCore::g_shader_jit_enabled = values.use_shader_jit;
     VideoCore::g_hw_shader_enabled = values.use_hw_shader;
@@ -89,6 +99,7 @@ void LogSettings() {
     LogSetting("Audio_OutputEngine", Settings::values.sink_id);
     LogSetting("Audio_EnableAudioStretching", Settings::values.enable_audio_stretching);
     LogSetting("Audio_OutputDevice", Settings::values.audio_device_id);
+    LogSetting("Audio_EnableAacDiskCache", Settings::values.enable_aac_disk_cache);
     LogSetting("Audio_InputDeviceType", static_cast<int>(Settings::values.mic_input_type));
     LogSetting("Audio_InputDevice", Settings::values.mic_input_device);
     using namespace Service::CAM;
@@ -102,10 +113,16 @@ void LogSettings() {
     LogSetting("Camera_OuterLeftConfig", Settings::values.camera_config[OuterLeftCamera]);
     LogSetting("Camera_OuterLeftFlip", Settings::values.camera_flip[OuterLeftCamera]);
     LogSetting("DataStorage_UseVirtualSd", Settings::values.use_virtual_sd);
+    LogSetting("DataStorage_FsDelayPercentage", Settings::values.fs_delay_percentage);
     LogSetting("System_IsNew3ds", Settings::values.is_new_3ds);
     LogSetting("System_RegionValue", Settings::values.region_value);
+    LogSetting("Miscellaneous_UseBinaryLog", Settings::values.use_binary_log);
     LogSetting("Debugging_UseGdbstub", Settings::values.use_gdbstub);
     LogSetting("Debugging_GdbstubPort", Settings::values.gdbstub_port);
+    LogSetting("Debugging_TraceBufferSize", Settings::values.trace_buffer_size);
+    LogSetting("Debugging_TraceSlowFrameMs", Settings::values.trace_slow_frame_ms);
+    LogSetting("Debugging_RpcSocketPath", Settings::values.rpc_socket_path);
+    LogSetting("Netplay_InputDelay", Settings::values.netplay_input_delay);
 }
 
 void LoadProfile(int index) {
@@ -129,6 +129,7 @@ struct Values {
 
     // Data Storage
     bool use_virtual_sd;
+    u16 fs_delay_percentage; ///< Scale of emulated FS delays, 100 = hardware timing, 0 = instant
 
     // System
     int region_value;
@@ -173,6 +174,7 @@ struct Values {
     bool enable_audio_stretching;
     std::string audio_device_id;
     float volume;
+    bool enable_aac_disk_cache;
     MicInputType mic_input_type;
     std::string mic_input_device;
 
@@ -185,7 +187,15 @@ struct Values {
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string log_filter;
+    bool use_binary_log; ///< Write messages below Warning to a binary file instead of the backends
     std::unordered_map<std::string, bool> lle_modules;
+    u32 trace_buffer_size;    ///< Number of trace events kept per thread, 0 disables tracing
+    u32 trace_slow_frame_ms;  ///< Frames slower than this are dumped as a trace, 0 never dumps
+    /// Path of the local socket of the RPC server, empty for the default path
+    std::string rpc_socket_path;
+
+    // Netplay
+    u16 netplay_input_delay; ///< Number of frames that input is delayed by to hide network latency
 
     // WebService
     bool enable_telemetry;
@@ -10,6 +10,15 @@ namespace CiTrace {
 
 // NOTE: Things are stored in little-endian
 
+// Version 1 stores the stream as an array of CTStreamElement at stream_offset, preceded by the
+// contents of the memory loads, which are referred to by their file offset.
+//
+// Version 2 stores the stream in chunks, each starting with a CTChunkHeader, from stream_offset
+// until the end of the file. Blob chunks hold the contents of memory loads, which are numbered in
+// the order they appear in the file. Element chunks hold arrays of CTStreamElement, whose memory
+// loads refer to the contents by that number instead of a file offset. The contents of a memory
+// load are always stored before the first element that refers to them.
+
 #pragma pack(1)
 
 struct CTHeader {
@@ -18,7 +27,7 @@ struct CTHeader {
     }
 
     static u32 ExpectedVersion() {
-        return 1;
+        return 2;
     }
 
     char magic[4];
@@ -57,7 +66,7 @@ struct CTHeader {
     } initial_state_offsets;
 
     u32 stream_offset;
-    u32 stream_size;
+    u32 stream_size; ///< Number of stream elements
 };
 
 enum CTStreamElementType : u32 {
@@ -67,7 +76,7 @@ enum CTStreamElementType : u32 {
 };
 
 struct CTMemoryLoad {
-    u32 file_offset;
+    u32 file_offset; ///< Index of the contents in version 2
     u32 size;
     u32 physical_address;
     u32 pad;
@@ -96,5 +105,24 @@ struct CTStreamElement {
     };
 };
 
+enum CTChunkType : u32 {
+    BlobChunk = 0xC1,
+    ElementChunk = 0xC2,
+};
+
+enum CTCompression : u32 {
+    Uncompressed = 0,
+    Zstd = 1,
+};
+
+struct CTChunkHeader {
+    CTChunkType type;
+    CTCompression compression;
+    u32 size; ///< Size of the data following the header
+    u32 uncompressed_size;
+};
+
+// A blob chunk holds any number of blobs, each a u32 size followed by that many bytes
+
 #pragma pack()
 } // namespace CiTrace
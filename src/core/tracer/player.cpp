@@ -0,0 +1,128 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include "common/logging/log.h"
+#include "core/core.h"
+#include "core/hw/gpu.h"
+#include "core/hw/hw.h"
+#include "core/hw/lcd.h"
+#include "core/memory.h"
+#include "core/tracer/player.h"
+#include "core/tracer/reader.h"
+#include "video_core/pica_state.h"
+#include "video_core/rasterizer_interface.h"
+#include "video_core/renderer_base.h"
+#include "video_core/video_core.h"
+
+namespace CiTrace {
+
+template <typename T>
+static void CopyState(const std::vector<u32>& state, T& destination) {
+    std::memcpy(&destination, state.data(),
+                std::min(state.size() * sizeof(u32), sizeof(destination)));
+}
+
+/// Decodes vectors of float24 values, stored as four u32 each
+template <std::size_t N>
+static void CopyFloat24State(const std::vector<u32>& state, Common::Vec4<Pica::float24> (&out)[N]) {
+    for (std::size_t i = 0; i < std::min(N, state.size() / 4); ++i) {
+        for (std::size_t comp = 0; comp < 4; ++comp) {
+            out[i][comp] = Pica::float24::FromRaw(state[4 * i + comp]);
+        }
+    }
+}
+
+static void ApplyInitialState(const Recorder::InitialState& state) {
+    CopyState(state.gpu_registers, GPU::g_regs);
+    CopyState(state.lcd_registers, LCD::g_regs);
+
+    auto& pica = Pica::g_state;
+    CopyState(state.pica_registers, pica.regs);
+    CopyFloat24State(state.default_attributes, pica.input_default_attributes.attr);
+    CopyState(state.vs_program_binary, pica.vs.program_code);
+    CopyState(state.vs_swizzle_data, pica.vs.swizzle_data);
+    CopyFloat24State(state.vs_float_uniforms, pica.vs.uniforms.f);
+    CopyState(state.gs_program_binary, pica.gs.program_code);
+    CopyState(state.gs_swizzle_data, pica.gs.swizzle_data);
+    CopyFloat24State(state.gs_float_uniforms, pica.gs.uniforms.f);
+    pica.vs.MarkProgramCodeDirty();
+    pica.vs.MarkSwizzleDataDirty();
+    pica.gs.MarkProgramCodeDirty();
+    pica.gs.MarkSwizzleDataDirty();
+
+    // The registers were not written through the command processor, so sync the rasterizer
+    for (u32 id = 0; id < Pica::Regs::NUM_REGS; ++id) {
+        VideoCore::g_renderer->Rasterizer()->NotifyPicaRegisterChanged(id);
+    }
+}
+
+u32 Replay(Core::System& system, const Trace& trace) {
+    ApplyInitialState(trace.initial_state);
+
+    u32 frames = 0;
+    for (const auto& element : trace.stream) {
+        switch (element.type) {
+        case FrameMarker:
+            VideoCore::g_renderer->SwapBuffers();
+            ++frames;
+            break;
+        case MemoryLoad: {
+            const auto& memory_load = element.memory_load;
+            const auto& contents = trace.memory_contents[memory_load.file_offset];
+            if (contents.empty()) {
+                break;
+            }
+            // Physical memory regions are contiguous, so the load fits if its first and last
+            // bytes are in the same region
+            const PAddr last_address =
+                memory_load.physical_address + static_cast<u32>(contents.size()) - 1;
+            u8* const pointer = system.Memory().GetPhysicalPointer(memory_load.physical_address);
+            if (last_address < memory_load.physical_address || pointer == nullptr ||
+                system.Memory().GetPhysicalPointer(last_address) !=
+                    pointer + contents.size() - 1) {
+                LOG_ERROR(HW_GPU, "Memory load to unmapped range {:#010X}-{:#010X}",
+                          memory_load.physical_address, last_address);
+                break;
+            }
+            std::memcpy(pointer, contents.data(), contents.size());
+            // Like writes of the emulated CPU, make sure the rasterizer doesn't use stale copies
+            VideoCore::g_renderer->Rasterizer()->InvalidateRegion(memory_load.physical_address,
+                                                                  memory_load.size);
+            break;
+        }
+        case RegisterWrite: {
+            const auto& write = element.register_write;
+            const u32 address = write.physical_address - Memory::IO_AREA_PADDR +
+                                Memory::IO_AREA_VADDR;
+            switch (write.size) {
+            case CTRegisterWrite::SIZE_8:
+                HW::Write<u8>(address, static_cast<u8>(write.value));
+                break;
+            case CTRegisterWrite::SIZE_16:
+                HW::Write<u16>(address, static_cast<u16>(write.value));
+                break;
+            case CTRegisterWrite::SIZE_32:
+                HW::Write<u32>(address, static_cast<u32>(write.value));
+                break;
+            case CTRegisterWrite::SIZE_64:
+                HW::Write<u64>(address, write.value);
+                break;
+            default:
+                LOG_ERROR(HW_GPU, "Register write with unknown size {}",
+                          static_cast<u32>(write.size));
+                break;
+            }
+            break;
+        }
+        default:
+            LOG_ERROR(HW_GPU, "Unknown stream element type {}", static_cast<u32>(element.type));
+            break;
+        }
+    }
+    return frames;
+}
+
+} // namespace CiTrace
@@ -0,0 +1,26 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "common/common_types.h"
+
+namespace Core {
+class System;
+}
+
+namespace CiTrace {
+
+struct Trace;
+
+/**
+ * Replays a trace through the GPU emulation, performing the recorded register writes and memory
+ * loads as the emulated CPU did, and presenting a frame at every frame marker. This makes the GPU
+ * workload of a game reproducible without running the game itself.
+ * @param system A system initialized without an application, see System::InitForTraceReplay
+ * @returns The number of frames that were presented
+ */
+u32 Replay(Core::System& system, const Trace& trace);
+
+} // namespace CiTrace
@@ -0,0 +1,185 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <unordered_map>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "core/tracer/reader.h"
+
+namespace CiTrace {
+
+static bool ReadInitialState(FileUtil::IOFile& file, const CTHeader& header,
+                             Recorder::InitialState& state) {
+    const auto& offsets = header.initial_state_offsets;
+    const auto read_state = [&file](u32 offset, u32 size, std::vector<u32>& out) {
+        out.resize(size);
+        return size == 0 ||
+               (file.Seek(offset, SEEK_SET) && file.ReadArray(out.data(), size) == size);
+    };
+    return read_state(offsets.gpu_registers, offsets.gpu_registers_size, state.gpu_registers) &&
+           read_state(offsets.lcd_registers, offsets.lcd_registers_size, state.lcd_registers) &&
+           read_state(offsets.pica_registers, offsets.pica_registers_size,
+                      state.pica_registers) &&
+           read_state(offsets.default_attributes, offsets.default_attributes_size,
+                      state.default_attributes) &&
+           read_state(offsets.vs_program_binary, offsets.vs_program_binary_size,
+                      state.vs_program_binary) &&
+           read_state(offsets.vs_swizzle_data, offsets.vs_swizzle_data_size,
+                      state.vs_swizzle_data) &&
+           read_state(offsets.vs_float_uniforms, offsets.vs_float_uniforms_size,
+                      state.vs_float_uniforms) &&
+           read_state(offsets.gs_program_binary, offsets.gs_program_binary_size,
+                      state.gs_program_binary) &&
+           read_state(offsets.gs_swizzle_data, offsets.gs_swizzle_data_size,
+                      state.gs_swizzle_data) &&
+           read_state(offsets.gs_float_uniforms, offsets.gs_float_uniforms_size,
+                      state.gs_float_uniforms);
+}
+
+/// Reads a version 1 stream, which refers to memory contents by file offset
+static bool ReadStreamV1(FileUtil::IOFile& file, const CTHeader& header, Trace& trace) {
+    trace.stream.resize(header.stream_size);
+    if (!file.Seek(header.stream_offset, SEEK_SET) ||
+        file.ReadArray(trace.stream.data(), trace.stream.size()) != trace.stream.size()) {
+        return false;
+    }
+
+    std::unordered_map<u32, u32> indices;
+    for (auto& element : trace.stream) {
+        if (element.type != MemoryLoad) {
+            continue;
+        }
+        auto& memory_load = element.memory_load;
+        const auto [it, inserted] =
+            indices.emplace(memory_load.file_offset, static_cast<u32>(indices.size()));
+        if (inserted) {
+            std::vector<u8> contents(memory_load.size);
+            if (!file.Seek(memory_load.file_offset, SEEK_SET) ||
+                file.ReadBytes(contents.data(), contents.size()) != contents.size()) {
+                return false;
+            }
+            trace.memory_contents.push_back(std::move(contents));
+        }
+        memory_load.file_offset = it->second;
+    }
+    return true;
+}
+
+/// Reads a version 2 stream, which is split into possibly compressed chunks
+static bool ReadStreamV2(FileUtil::IOFile& file, const CTHeader& header, Trace& trace) {
+    if (!file.Seek(header.stream_offset, SEEK_SET)) {
+        return false;
+    }
+    trace.stream.reserve(header.stream_size);
+
+    const u64 file_size = file.GetSize();
+    std::vector<u8> data;
+    std::vector<u8> uncompressed;
+    while (file.Tell() < file_size) {
+        CTChunkHeader chunk_header;
+        data.resize(0);
+        if (file.ReadArray(&chunk_header, 1) != 1) {
+            return false;
+        }
+        data.resize(chunk_header.size);
+        if (file.ReadBytes(data.data(), data.size()) != data.size()) {
+            // The recording was interrupted, keep what was written so far
+            LOG_WARNING(HW_GPU, "CiTrace file ends in the middle of a chunk");
+            break;
+        }
+
+        switch (chunk_header.compression) {
+        case Uncompressed:
+            uncompressed.swap(data);
+            break;
+#ifdef HAVE_ZSTD
+        case Zstd: {
+            uncompressed.resize(chunk_header.uncompressed_size);
+            const std::size_t size = ZSTD_decompress(uncompressed.data(), uncompressed.size(),
+                                                     data.data(), data.size());
+            if (ZSTD_isError(size) || size != uncompressed.size()) {
+                LOG_ERROR(HW_GPU, "Could not decompress CiTrace chunk");
+                return false;
+            }
+            break;
+        }
+#endif
+        default:
+            LOG_ERROR(HW_GPU, "Unsupported CiTrace chunk compression {}",
+                      static_cast<u32>(chunk_header.compression));
+            return false;
+        }
+
+        if (chunk_header.type == BlobChunk) {
+            std::size_t offset = 0;
+            while (offset + sizeof(u32) <= uncompressed.size()) {
+                u32 size;
+                std::memcpy(&size, uncompressed.data() + offset, sizeof(u32));
+                offset += sizeof(u32);
+                if (size > uncompressed.size() - offset) {
+                    return false;
+                }
+                trace.memory_contents.emplace_back(uncompressed.begin() + offset,
+                                                   uncompressed.begin() + offset + size);
+                offset += size;
+            }
+        } else if (chunk_header.type == ElementChunk) {
+            const std::size_t count = uncompressed.size() / sizeof(CTStreamElement);
+            const std::size_t first = trace.stream.size();
+            trace.stream.resize(first + count);
+            std::memcpy(trace.stream.data() + first, uncompressed.data(),
+                        count * sizeof(CTStreamElement));
+        }
+    }
+
+    for (const auto& element : trace.stream) {
+        if (element.type == MemoryLoad &&
+            (element.memory_load.file_offset >= trace.memory_contents.size() ||
+             trace.memory_contents[element.memory_load.file_offset].size() !=
+                 element.memory_load.size)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::optional<Trace> LoadTrace(const std::string& filename) {
+    FileUtil::IOFile file(filename, "rb");
+    CTHeader header;
+    if (!file.IsOpen() || file.ReadArray(&header, 1) != 1 ||
+        std::memcmp(header.magic, CTHeader::ExpectedMagicWord(), 4) != 0) {
+        LOG_ERROR(HW_GPU, "{} is not a CiTrace file", filename);
+        return std::nullopt;
+    }
+
+    Trace trace;
+    if (!ReadInitialState(file, header, trace.initial_state)) {
+        LOG_ERROR(HW_GPU, "Could not read the initial state of CiTrace file {}", filename);
+        return std::nullopt;
+    }
+
+    bool success;
+    switch (header.version) {
+    case 1:
+        success = ReadStreamV1(file, header, trace);
+        break;
+    case 2:
+        success = ReadStreamV2(file, header, trace);
+        break;
+    default:
+        LOG_ERROR(HW_GPU, "Unsupported CiTrace version {}", header.version);
+        return std::nullopt;
+    }
+    if (!success) {
+        LOG_ERROR(HW_GPU, "Could not read the stream of CiTrace file {}", filename);
+        return std::nullopt;
+    }
+    return trace;
+}
+
+} // namespace CiTrace
@@ -0,0 +1,30 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+#include "core/tracer/citrace.h"
+#include "core/tracer/recorder.h"
+
+namespace CiTrace {
+
+/// A CiTrace recording, loaded into memory for replaying.
+struct Trace {
+    Recorder::InitialState initial_state;
+    /// The stream, where memory loads refer to memory_contents by index in file_offset
+    std::vector<CTStreamElement> stream;
+    std::vector<std::vector<u8>> memory_contents;
+};
+
+/**
+ * Loads a CiTrace file of any version.
+ * @returns The trace, or std::nullopt if the file could not be read
+ */
+std::optional<Trace> LoadTrace(const std::string& filename);
+
+} // namespace CiTrace
@@ -3,18 +3,31 @@
 // Refer to the license.txt file included.
 
 #include <cstring>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include "common/assert.h"
-#include "common/file_util.h"
 #include "common/logging/log.h"
 #include "core/tracer/recorder.h"
 
 namespace CiTrace {
 
-Recorder::Recorder(const InitialState& initial_state) : initial_state(initial_state) {}
-
-void Recorder::Finish(const std::string& filename) {
+/// The buffered stream is written out when it has this many elements...
+constexpr std::size_t ElementsPerChunk = 0x10000;
+/// ... or this many bytes of memory contents
+constexpr std::size_t BlobBytesPerChunk = 0x400000;
+/// Chunks waiting for the writer thread. Recording waits for the writer beyond this, so that a
+/// slow disk does not make the queue grow without limit.
+constexpr std::size_t MaxQueuedChunks = 8;
+
+#ifdef HAVE_ZSTD
+/// Fast enough to keep up with recording on the writer thread
+constexpr int ZstdCompressionLevel = 3;
+#endif
+
+Recorder::Recorder(const InitialState& initial_state, const std::string& filename)
+    : filename(filename), file(filename, "wb") {
     // Setup CiTrace header
-    CTHeader header;
     std::memcpy(header.magic, CTHeader::ExpectedMagicWord(), 4);
     header.version = CTHeader::ExpectedVersion();
     header.header_size = sizeof(CTHeader);
@@ -32,12 +45,10 @@ void Recorder::Finish(const std::string& filename) {
     initial.gs_program_binary_size = static_cast<u32>(initial_state.gs_program_binary.size());
     initial.gs_swizzle_data_size = static_cast<u32>(initial_state.gs_swizzle_data.size());
     initial.gs_float_uniforms_size = static_cast<u32>(initial_state.gs_float_uniforms.size());
-    header.stream_size = static_cast<u32>(stream.size());
 
     initial.gpu_registers = sizeof(header);
     initial.lcd_registers = initial.gpu_registers + initial.gpu_registers_size * sizeof(u32);
     initial.pica_registers = initial.lcd_registers + initial.lcd_registers_size * sizeof(u32);
-    ;
     initial.default_attributes = initial.pica_registers + initial.pica_registers_size * sizeof(u32);
     initial.vs_program_binary =
         initial.default_attributes + initial.default_attributes_size * sizeof(u32);
@@ -53,152 +64,183 @@ void Recorder::Finish(const std::string& filename) {
         initial.gs_swizzle_data + initial.gs_swizzle_data_size * sizeof(u32);
     header.stream_offset = initial.gs_float_uniforms + initial.gs_float_uniforms_size * sizeof(u32);
 
-    // Iterate through stream elements, update relevant stream element data
-    for (auto& stream_element : stream) {
-        switch (stream_element.data.type) {
-        case MemoryLoad: {
-            auto& file_offset = memory_regions[stream_element.hash];
-            if (!stream_element.uses_existing_data) {
-                file_offset = header.stream_offset;
-            }
-            stream_element.data.memory_load.file_offset = file_offset;
-            break;
-        }
-
-        default:
-            // Other commands don't use any extra data
-            DEBUG_ASSERT(stream_element.extra_data.size() == 0);
-            break;
-        }
-        header.stream_offset += static_cast<u32>(stream_element.extra_data.size());
-    }
-
     try {
-        // Open file and write header
-        FileUtil::IOFile file(filename, "wb");
-        std::size_t written = file.WriteObject(header);
-        if (written != 1 || file.Tell() != initial.gpu_registers)
+        // Write header, the stream size is filled in by Finish
+        if (file.WriteObject(header) != 1)
             throw "Failed to write header";
 
         // Write initial state
-        written =
-            file.WriteArray(initial_state.gpu_registers.data(), initial_state.gpu_registers.size());
-        if (written != initial_state.gpu_registers.size() || file.Tell() != initial.lcd_registers)
-            throw "Failed to write GPU registers";
-
-        written =
-            file.WriteArray(initial_state.lcd_registers.data(), initial_state.lcd_registers.size());
-        if (written != initial_state.lcd_registers.size() || file.Tell() != initial.pica_registers)
-            throw "Failed to write LCD registers";
-
-        written = file.WriteArray(initial_state.pica_registers.data(),
-                                  initial_state.pica_registers.size());
-        if (written != initial_state.pica_registers.size() ||
-            file.Tell() != initial.default_attributes)
-            throw "Failed to write Pica registers";
-
-        written = file.WriteArray(initial_state.default_attributes.data(),
-                                  initial_state.default_attributes.size());
-        if (written != initial_state.default_attributes.size() ||
-            file.Tell() != initial.vs_program_binary)
-            throw "Failed to write default vertex attributes";
-
-        written = file.WriteArray(initial_state.vs_program_binary.data(),
-                                  initial_state.vs_program_binary.size());
-        if (written != initial_state.vs_program_binary.size() ||
-            file.Tell() != initial.vs_swizzle_data)
-            throw "Failed to write vertex shader program binary";
-
-        written = file.WriteArray(initial_state.vs_swizzle_data.data(),
-                                  initial_state.vs_swizzle_data.size());
-        if (written != initial_state.vs_swizzle_data.size() ||
-            file.Tell() != initial.vs_float_uniforms)
-            throw "Failed to write vertex shader swizzle data";
-
-        written = file.WriteArray(initial_state.vs_float_uniforms.data(),
-                                  initial_state.vs_float_uniforms.size());
-        if (written != initial_state.vs_float_uniforms.size() ||
-            file.Tell() != initial.gs_program_binary)
-            throw "Failed to write vertex shader float uniforms";
-
-        written = file.WriteArray(initial_state.gs_program_binary.data(),
-                                  initial_state.gs_program_binary.size());
-        if (written != initial_state.gs_program_binary.size() ||
-            file.Tell() != initial.gs_swizzle_data)
-            throw "Failed to write geomtry shader program binary";
-
-        written = file.WriteArray(initial_state.gs_swizzle_data.data(),
-                                  initial_state.gs_swizzle_data.size());
-        if (written != initial_state.gs_swizzle_data.size() ||
-            file.Tell() != initial.gs_float_uniforms)
-            throw "Failed to write geometry shader swizzle data";
-
-        written = file.WriteArray(initial_state.gs_float_uniforms.data(),
-                                  initial_state.gs_float_uniforms.size());
-        if (written != initial_state.gs_float_uniforms.size() ||
-            file.Tell() != initial.gs_float_uniforms + sizeof(u32) * initial.gs_float_uniforms_size)
-            throw "Failed to write geometry shader float uniforms";
-
-        // Iterate through stream elements, write "extra data"
-        for (const auto& stream_element : stream) {
-            if (stream_element.extra_data.size() == 0)
-                continue;
-
-            written =
-                file.WriteBytes(stream_element.extra_data.data(), stream_element.extra_data.size());
-            if (written != stream_element.extra_data.size())
-                throw "Failed to write extra data";
-        }
+        const auto write_state = [this](const std::vector<u32>& state, const char* error) {
+            if (!state.empty() && file.WriteArray(state.data(), state.size()) != state.size())
+                throw error;
+        };
+        write_state(initial_state.gpu_registers, "Failed to write GPU registers");
+        write_state(initial_state.lcd_registers, "Failed to write LCD registers");
+        write_state(initial_state.pica_registers, "Failed to write Pica registers");
+        write_state(initial_state.default_attributes,
+                    "Failed to write default vertex attributes");
+        write_state(initial_state.vs_program_binary,
+                    "Failed to write vertex shader program binary");
+        write_state(initial_state.vs_swizzle_data, "Failed to write vertex shader swizzle data");
+        write_state(initial_state.vs_float_uniforms,
+                    "Failed to write vertex shader float uniforms");
+        write_state(initial_state.gs_program_binary,
+                    "Failed to write geometry shader program binary");
+        write_state(initial_state.gs_swizzle_data, "Failed to write geometry shader swizzle data");
+        write_state(initial_state.gs_float_uniforms,
+                    "Failed to write geometry shader float uniforms");
 
         if (file.Tell() != header.stream_offset)
-            throw "Unexpected end of extra data";
-
-        // Write actual stream elements
-        for (const auto& stream_element : stream) {
-            if (1 != file.WriteObject(stream_element.data))
-                throw "Failed to write stream element";
-        }
+            throw "Unexpected end of initial state";
     } catch (const char* str) {
         LOG_ERROR(HW_GPU, "Writing CiTrace file failed: {}", str);
+        write_failed = true;
     }
+
+    writer_thread = std::thread([this] { WriteChunks(); });
+}
+
+Recorder::~Recorder() {
+    if (!finished) {
+        Finish();
+    }
+}
+
+void Recorder::Finish() {
+    FlushChunks();
+    StopWriter();
+
+    // Now that the stream is complete, fill in its size
+    header.stream_size = element_count;
+    if (!write_failed && (!file.Seek(0, SEEK_SET) || file.WriteObject(header) != 1)) {
+        write_failed = true;
+    }
+    file.Close();
+
+    if (write_failed) {
+        LOG_ERROR(HW_GPU, "Writing CiTrace file {} failed", filename);
+    } else {
+        LOG_INFO(HW_GPU, "Wrote {} stream elements to CiTrace file {}", element_count, filename);
+    }
+}
+
+void Recorder::Abort() {
+    pending_blobs.clear();
+    pending_elements.clear();
+    StopWriter();
+    file.Close();
+    FileUtil::Delete(filename);
 }
 
 void Recorder::FrameFinished() {
-    stream.push_back({{FrameMarker}});
+    AddElement({FrameMarker});
 }
 
 void Recorder::MemoryAccessed(const u8* data, u32 size, u32 physical_address) {
-    StreamElement element = {{MemoryLoad}};
-    element.data.memory_load.size = size;
-    element.data.memory_load.physical_address = physical_address;
-
-    // Compute hash over given memory region to check if the contents are already stored internally
-    boost::crc_32_type result;
-    result.process_bytes(data, size);
-    element.hash = result.checksum();
-
-    element.uses_existing_data = (memory_regions.find(element.hash) != memory_regions.end());
-    if (!element.uses_existing_data) {
-        element.extra_data.resize(size);
-        memcpy(element.extra_data.data(), data, size);
-        memory_regions.insert({element.hash, 0}); // file offset will be initialized in Finish()
+    CTStreamElement element = {MemoryLoad};
+    element.memory_load.size = size;
+    element.memory_load.physical_address = physical_address;
+
+    // Compute hash over given memory region to check if the contents are already stored. A 128-bit
+    // hash makes collisions unlikely enough that the contents need not be kept for comparison.
+    const Common::uint128 hash =
+        Common::CityHash128WithSeed(reinterpret_cast<const char*>(data), size, {size, 0});
+    const auto [match, inserted] = memory_regions.try_emplace(hash, stored_contents_count);
+    if (!inserted) {
+        element.memory_load.file_offset = match->second;
+    } else {
+        const u32 index = stored_contents_count++;
+
+        pending_blobs.resize(pending_blobs.size() + sizeof(u32) + size);
+        u8* blob = pending_blobs.data() + pending_blobs.size() - sizeof(u32) - size;
+        std::memcpy(blob, &size, sizeof(u32));
+        std::memcpy(blob + sizeof(u32), data, size);
+        element.memory_load.file_offset = index;
     }
 
-    stream.push_back(element);
+    AddElement(element);
 }
 
 template <typename T>
 void Recorder::RegisterWritten(u32 physical_address, T value) {
-    StreamElement element = {{RegisterWrite}};
-    element.data.register_write.size =
+    CTStreamElement element = {RegisterWrite};
+    element.register_write.size =
         (sizeof(T) == 1) ? CTRegisterWrite::SIZE_8
                          : (sizeof(T) == 2) ? CTRegisterWrite::SIZE_16
                                             : (sizeof(T) == 4) ? CTRegisterWrite::SIZE_32
                                                                : CTRegisterWrite::SIZE_64;
-    element.data.register_write.physical_address = physical_address;
-    element.data.register_write.value = value;
+    element.register_write.physical_address = physical_address;
+    element.register_write.value = value;
 
-    stream.push_back(element);
+    AddElement(element);
+}
+
+void Recorder::AddElement(const CTStreamElement& element) {
+    pending_elements.push_back(element);
+    ++element_count;
+    if (pending_elements.size() >= ElementsPerChunk ||
+        pending_blobs.size() >= BlobBytesPerChunk) {
+        FlushChunks();
+    }
+}
+
+void Recorder::FlushChunks() {
+    while (chunk_queue.Size() >= MaxQueuedChunks) {
+        chunk_written.Wait();
+    }
+
+    // Blobs go first, as the elements refer to them
+    if (!pending_blobs.empty()) {
+        chunk_queue.Push(std::make_unique<Chunk>(Chunk{BlobChunk, std::move(pending_blobs)}));
+        pending_blobs = {};
+    }
+    if (!pending_elements.empty()) {
+        std::vector<u8> data(pending_elements.size() * sizeof(CTStreamElement));
+        std::memcpy(data.data(), pending_elements.data(), data.size());
+        chunk_queue.Push(std::make_unique<Chunk>(Chunk{ElementChunk, std::move(data)}));
+        pending_elements.clear();
+    }
+}
+
+void Recorder::WriteChunks() {
+    std::unique_ptr<Chunk> chunk;
+    while ((chunk = chunk_queue.PopWait())) {
+        chunk_written.Set();
+        if (write_failed) {
+            continue;
+        }
+
+        CTChunkHeader chunk_header{chunk->type, Uncompressed,
+                                   static_cast<u32>(chunk->data.size()),
+                                   static_cast<u32>(chunk->data.size())};
+        const std::vector<u8>* data = &chunk->data;
+#ifdef HAVE_ZSTD
+        std::vector<u8> compressed(ZSTD_compressBound(chunk->data.size()));
+        const std::size_t compressed_size =
+            ZSTD_compress(compressed.data(), compressed.size(), chunk->data.data(),
+                          chunk->data.size(), ZstdCompressionLevel);
+        if (!ZSTD_isError(compressed_size)) {
+            compressed.resize(compressed_size);
+            chunk_header.compression = Zstd;
+            chunk_header.size = static_cast<u32>(compressed_size);
+            data = &compressed;
+        }
+#endif
+
+        if (file.WriteObject(chunk_header) != 1 ||
+            file.WriteBytes(data->data(), data->size()) != data->size()) {
+            LOG_ERROR(HW_GPU, "Failed to write CiTrace chunk");
+            write_failed = true;
+        }
+    }
+}
+
+void Recorder::StopWriter() {
+    if (writer_thread.joinable()) {
+        chunk_queue.Push(nullptr);
+        writer_thread.join();
+    }
+    finished = true;
 }
 
 template void Recorder::RegisterWritten(u32, u8);
@@ -4,11 +4,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
-#include <boost/crc.hpp>
+#include "common/cityhash.h"
 #include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/thread.h"
+#include "common/threadsafe_queue.h"
 #include "core/tracer/citrace.h"
 
 namespace CiTrace {
@@ -29,13 +35,21 @@ public:
     };
 
     /**
-     * Recorder constructor
+     * Recorder constructor. The recording is written to the file while recording, in compressed
+     * chunks, so that long recordings don't need to fit in memory.
      * @param initial_state Initial recorder state
+     * @param filename File to save the recording to
      */
-    explicit Recorder(const InitialState& initial_state);
+    Recorder(const InitialState& initial_state, const std::string& filename);
 
-    /// Finish recording of this Citrace and save it using the given filename.
-    void Finish(const std::string& filename);
+    /// Finishes the recording if it wasn't finished or aborted yet.
+    ~Recorder();
+
+    /// Finish recording of this Citrace, writing out the remaining stream.
+    void Finish();
+
+    /// Stop recording of this Citrace and delete its file.
+    void Abort();
 
     /// Mark end of a frame
     void FrameFinished();
@@ -55,33 +69,47 @@ public:
     void RegisterWritten(u32 physical_address, T value);
 
 private:
-    // Initial state of recording start
-    InitialState initial_state;
+    struct Chunk {
+        CTChunkType type;
+        std::vector<u8> data;
+    };
 
-    // Command stream
-    struct StreamElement {
-        CTStreamElement data;
+    struct ContentHash {
+        std::size_t operator()(const Common::uint128& hash) const {
+            return static_cast<std::size_t>(hash.first);
+        }
+    };
 
-        /**
-         * Extra data to store along "core" data.
-         * This is e.g. used for data used in MemoryUpdates.
-         */
-        std::vector<u8> extra_data;
+    void AddElement(const CTStreamElement& element);
 
-        /// Optional CRC hash (e.g. for hashing memory regions)
-        boost::crc_32_type::value_type hash;
+    /// Hands the buffered blobs and elements to the writer thread
+    void FlushChunks();
 
-        /// If true, refer to data already written to the output file instead of extra_data
-        bool uses_existing_data;
-    };
+    /// Compresses and writes chunks until it receives nullptr, on the writer thread
+    void WriteChunks();
 
-    std::vector<StreamElement> stream;
+    /// Stops the writer thread, after it has written all chunks
+    void StopWriter();
 
-    /**
-     * Internal cache which maps hashes of memory contents to file offsets at which those memory
-     * contents are stored.
-     */
-    std::unordered_map<boost::crc_32_type::value_type /*hash*/, u32 /*file_offset*/> memory_regions;
+    std::string filename;
+    FileUtil::IOFile file;
+    CTHeader header{};
+
+    // Stream data that hasn't been handed to the writer thread yet
+    std::vector<u8> pending_blobs;
+    std::vector<CTStreamElement> pending_elements;
+    u32 element_count = 0;
+
+    /// Maps 128-bit hashes of memory contents to the indices at which the contents are stored
+    std::unordered_map<Common::uint128, u32, ContentHash> memory_regions;
+    u32 stored_contents_count = 0;
+
+    Common::SPSCQueue<std::unique_ptr<Chunk>> chunk_queue;
+    /// Set by the writer thread whenever it took a chunk off chunk_queue
+    Common::Event chunk_written;
+    std::thread writer_thread;
+    std::atomic<bool> write_failed{false};
+    bool finished = false;
 };
 
 } // namespace CiTrace
@@ -0,0 +1,217 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Connects a number of simulated members to a room and has each of them broadcast WiFi packets
+// at a fixed rate, to measure how the room server copes with many members.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/scm_rev.h"
+#include "network/network.h"
+#include "network/room.h"
+#include "network/room_member.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options]\n"
+                 "--host        The address of the room (default 127.0.0.1)\n"
+                 "--port        The port of the room\n"
+                 "--members     The number of simulated members to connect\n"
+                 "--duration    How long to send packets for, in seconds\n"
+                 "--rate        The number of packets each member sends per second\n"
+                 "--size        The payload size of each packet in bytes\n"
+                 "--password    The password for the room\n"
+                 "-h, --help    Display this help and exit\n"
+                 "-v, --version Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra room load test " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << " Libnetwork: " << Network::network_version << std::endl;
+}
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    std::string host = "127.0.0.1";
+    std::string password;
+    u32 port = Network::DefaultRoomPort;
+    u32 num_members = 16;
+    u32 duration = 10;
+    u32 rate = 60;
+    u32 size = 256;
+
+    static struct option long_options[] = {
+        {"host", required_argument, 0, 'a'},
+        {"port", required_argument, 0, 'p'},
+        {"members", required_argument, 0, 'm'},
+        {"duration", required_argument, 0, 'd'},
+        {"rate", required_argument, 0, 'r'},
+        {"size", required_argument, 0, 's'},
+        {"password", required_argument, 0, 'w'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "a:p:m:d:r:s:w:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'a':
+                host.assign(optarg);
+                break;
+            case 'p':
+                port = strtoul(optarg, &endarg, 0);
+                break;
+            case 'm':
+                num_members = strtoul(optarg, &endarg, 0);
+                break;
+            case 'd':
+                duration = strtoul(optarg, &endarg, 0);
+                break;
+            case 'r':
+                rate = strtoul(optarg, &endarg, 0);
+                break;
+            case 's':
+                size = strtoul(optarg, &endarg, 0);
+                break;
+            case 'w':
+                password.assign(optarg);
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            break;
+        }
+    }
+
+    if (num_members == 0 || num_members > Network::MaxConcurrentConnections) {
+        std::cout << "members needs to be in the range 1 - " << Network::MaxConcurrentConnections
+                  << "!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (port > 65535) {
+        std::cout << "port needs to be in the range 0 - 65535!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (rate == 0) {
+        std::cout << "rate needs to be at least 1!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    Network::Init();
+
+    std::atomic<u64> packets_received{0};
+    std::atomic<u64> room_updates{0};
+    std::atomic<u32> errors{0};
+
+    std::vector<std::unique_ptr<Network::RoomMember>> members;
+    members.reserve(num_members);
+    for (u32 i = 0; i < num_members; ++i) {
+        auto member = std::make_unique<Network::RoomMember>();
+        member->BindOnWifiPacketReceived(
+            [&packets_received](const Network::WifiPacket&) { ++packets_received; });
+        member->BindOnRoomInformationChanged(
+            [&room_updates](const Network::RoomInformation&) { ++room_updates; });
+        member->BindOnError([&errors](const Network::RoomMember::Error&) { ++errors; });
+
+        const std::string id = std::to_string(i);
+        member->Join("LoadTest-" + std::string(4 - std::min<std::size_t>(id.size(), 4), '0') + id,
+                     "loadtest-console-" + id, host.c_str(), static_cast<u16>(port), 0,
+                     Network::NoPreferredMac, password);
+        members.push_back(std::move(member));
+    }
+
+    const auto join_start = std::chrono::steady_clock::now();
+    std::size_t joined = 0;
+    while (std::chrono::steady_clock::now() - join_start < std::chrono::seconds(10)) {
+        joined = 0;
+        for (const auto& member : members) {
+            if (member->IsConnected()) {
+                ++joined;
+            }
+        }
+        if (joined == members.size()) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto join_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - join_start);
+    std::cout << joined << " of " << members.size() << " members joined in " << join_time.count()
+              << " ms\n";
+    if (joined == 0) {
+        Network::Shutdown();
+        return -1;
+    }
+
+    const u64 room_updates_after_join = room_updates;
+    u64 packets_sent = 0;
+    Network::WifiPacket packet{};
+    packet.type = Network::WifiPacket::PacketType::Data;
+    packet.data.resize(size);
+    packet.destination_address = Network::BroadcastMac;
+
+    const auto interval = std::chrono::microseconds(1000000 / rate);
+    const auto start = std::chrono::steady_clock::now();
+    const auto end = start + std::chrono::seconds(duration);
+    auto next_tick = start;
+    while (std::chrono::steady_clock::now() < end) {
+        for (const auto& member : members) {
+            if (!member->IsConnected()) {
+                continue;
+            }
+            packet.transmitter_address = member->GetMacAddress();
+            member->SendWifiPacket(packet);
+            ++packets_sent;
+        }
+        next_tick += interval;
+        std::this_thread::sleep_until(next_tick);
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+                               .count();
+
+    // Give the room some time to deliver the packets that are still in flight.
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    const u64 expected = packets_sent * (joined - 1);
+    std::cout << "Sent " << packets_sent << " packets in " << elapsed << " s ("
+              << packets_sent / elapsed << " packets/s)\n"
+              << "Received " << packets_received << " of " << expected << " expected packets ("
+              << packets_received / elapsed << " packets/s)\n"
+              << "Room information updates: " << room_updates_after_join << " while joining, "
+              << room_updates - room_updates_after_join << " afterwards\n"
+              << "Errors: " << errors << "\n";
+
+    for (const auto& member : members) {
+        member->Leave();
+    }
+    members.clear();
+    Network::Shutdown();
+    return 0;
+}
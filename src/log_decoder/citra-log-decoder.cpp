@@ -0,0 +1,46 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Converts a binary log written with use_binary_log into the text format of the regular log.
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/text_formatter.h"
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0 << " <citra_log.bin>\n"
+              << "Prints the messages of a binary log in chronological order.\n";
+}
+
+/// Application entry point
+int main(int argc, char** argv) {
+    if (argc != 2 || std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help") {
+        PrintHelp(argv[0]);
+        return argc == 2 ? 0 : -1;
+    }
+
+    std::vector<Log::Entry> entries;
+    const bool success = Log::ReadBinaryLog(argv[1], [&entries](const Log::Entry& entry) {
+        Log::Entry copy;
+        copy = entry;
+        entries.push_back(std::move(copy));
+    });
+    if (!success) {
+        std::cerr << "Could not read " << argv[1] << " as a binary log\n";
+        return -1;
+    }
+
+    // The file is written in chunks per thread, so messages of different threads are interleaved
+    std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.timestamp < b.timestamp;
+    });
+    for (const auto& entry : entries) {
+        std::cout << Log::FormatLogMessage(entry) << '\n';
+    }
+    return 0;
+}
@@ -25,8 +25,25 @@ u64 ntohll(u64 x) {
 }
 #endif
 
+Packet::Packet(const void* in_data, std::size_t size_in_bytes)
+    : view_data(static_cast<const char*>(in_data)), view_size(size_in_bytes) {}
+
+void Packet::Reserve(std::size_t size_in_bytes) {
+    MakeOwned();
+    data.reserve(size_in_bytes);
+}
+
+void Packet::MakeOwned() {
+    if (view_data) {
+        data.assign(view_data, view_data + view_size);
+        view_data = nullptr;
+        view_size = 0;
+    }
+}
+
 void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
     if (in_data && (size_in_bytes > 0)) {
+        MakeOwned();
         std::size_t start = data.size();
         data.resize(start + size_in_bytes);
         std::memcpy(&data[start], in_data, size_in_bytes);
@@ -35,18 +52,30 @@ void Packet::Append(const void* in_data, std::size_t size_in_bytes) {
 
 void Packet::Read(void* out_data, std::size_t size_in_bytes) {
     if (out_data && CheckSize(size_in_bytes)) {
-        std::memcpy(out_data, &data[read_pos], size_in_bytes);
+        std::memcpy(out_data, static_cast<const char*>(GetData()) + read_pos, size_in_bytes);
         read_pos += size_in_bytes;
     }
 }
 
 void Packet::Clear() {
     data.clear();
+    view_data = nullptr;
+    view_size = 0;
     read_pos = 0;
     is_valid = true;
 }
 
+std::vector<char> Packet::ReleaseData() {
+    MakeOwned();
+    std::vector<char> released = std::move(data);
+    Clear();
+    return released;
+}
+
 const void* Packet::GetData() const {
+    if (view_data) {
+        return view_data;
+    }
     return !data.empty() ? &data[0] : nullptr;
 }
 
@@ -55,11 +84,11 @@ void Packet::IgnoreBytes(u32 length) {
 }
 
 std::size_t Packet::GetDataSize() const {
-    return data.size();
+    return view_data ? view_size : data.size();
 }
 
 bool Packet::EndOfPacket() const {
-    return read_pos >= data.size();
+    return read_pos >= GetDataSize();
 }
 
 Packet::operator bool() const {
@@ -143,7 +172,7 @@ Packet& Packet::operator>>(char* out_data) {
 
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        std::memcpy(out_data, &data[read_pos], length);
+        std::memcpy(out_data, static_cast<const char*>(GetData()) + read_pos, length);
         out_data[length] = '\0';
 
         // Update reading position
@@ -161,7 +190,7 @@ Packet& Packet::operator>>(std::string& out_data) {
     out_data.clear();
     if ((length > 0) && CheckSize(length)) {
         // Then extract characters
-        out_data.assign(&data[read_pos], length);
+        out_data.assign(static_cast<const char*>(GetData()) + read_pos, length);
 
         // Update reading position
         read_pos += length;
@@ -255,7 +284,7 @@ Packet& Packet::operator<<(const std::string& in_data) {
 }
 
 bool Packet::CheckSize(std::size_t size) {
-    is_valid = is_valid && (read_pos + size <= data.size());
+    is_valid = is_valid && (read_pos + size <= GetDataSize());
 
     return is_valid;
 }
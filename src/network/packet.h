@@ -5,6 +5,7 @@
 #pragma once
 
 #include <array>
+#include <type_traits>
 #include <vector>
 #include "common/common_types.h"
 
@@ -16,6 +17,22 @@ public:
     Packet() = default;
     ~Packet() = default;
 
+    /**
+     * Creates a packet that reads directly from the given data instead of a copy of it. The data
+     * has to stay valid for as long as the packet is read from. Writing to the packet makes it
+     * copy the data first.
+     * @param data          Pointer to the received bytes
+     * @param size_in_bytes Number of received bytes
+     */
+    Packet(const void* data, std::size_t size_in_bytes);
+
+    /**
+     * Reserves space for data that is going to be appended, so that writing a packet of a known
+     * layout does not reallocate for every value.
+     * @param size_in_bytes Total number of bytes the packet is expected to hold
+     */
+    void Reserve(std::size_t size_in_bytes);
+
     /**
      * Append data to the end of the packet
      * @param data        Pointer to the sequence of bytes to append
@@ -32,7 +49,7 @@ public:
 
     /**
      * Clear the packet
-     * After calling Clear, the packet is empty.
+     * After calling Clear, the packet is empty. The allocated space is kept for reuse.
      */
     void Clear();
 
@@ -42,6 +59,12 @@ public:
      */
     void IgnoreBytes(u32 length);
 
+    /**
+     * Moves the data out of the packet, which is left empty
+     * @return The data of the packet
+     */
+    std::vector<char> ReleaseData();
+
     /**
      * Get a pointer to the data contained in the packet
      * @return Pointer to the data
@@ -111,10 +134,15 @@ private:
      */
     bool CheckSize(std::size_t size);
 
+    /// Copies the data of a packet created from external data, so that it can be written to.
+    void MakeOwned();
+
     // Member data
-    std::vector<char> data;   ///< Data stored in the packet
-    std::size_t read_pos = 0; ///< Current reading position in the packet
-    bool is_valid = true;     ///< Reading state of the packet
+    std::vector<char> data;          ///< Data stored in the packet
+    const char* view_data = nullptr; ///< External data read by the packet, if any
+    std::size_t view_size = 0;       ///< Size of the external data
+    std::size_t read_pos = 0;        ///< Current reading position in the packet
+    bool is_valid = true;            ///< Reading state of the packet
 };
 
 template <typename T>
@@ -122,6 +150,18 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
     // First extract the size
     u32 size = 0;
     *this >> size;
+
+    // Byte vectors, such as WiFi frames, are copied in one go.
+    if constexpr (sizeof(T) == 1 && std::is_integral_v<T>) {
+        if (CheckSize(size)) {
+            out_data.resize(size);
+            Read(out_data.data(), size);
+        } else {
+            out_data.clear();
+        }
+        return *this;
+    }
+
     out_data.resize(size);
 
     // Then extract the data
@@ -135,6 +175,11 @@ Packet& Packet::operator>>(std::vector<T>& out_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator>>(std::array<T, S>& out_data) {
+    if constexpr (sizeof(T) == 1 && std::is_integral_v<T>) {
+        Read(out_data.data(), S);
+        return *this;
+    }
+
     for (std::size_t i = 0; i < out_data.size(); ++i) {
         T character;
         *this >> character;
@@ -148,6 +193,11 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
     // First insert the size
     *this << static_cast<u32>(in_data.size());
 
+    if constexpr (sizeof(T) == 1 && std::is_integral_v<T>) {
+        Append(in_data.data(), in_data.size());
+        return *this;
+    }
+
     // Then insert the data
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
@@ -157,6 +207,11 @@ Packet& Packet::operator<<(const std::vector<T>& in_data) {
 
 template <typename T, std::size_t S>
 Packet& Packet::operator<<(const std::array<T, S>& in_data) {
+    if constexpr (sizeof(T) == 1 && std::is_integral_v<T>) {
+        Append(in_data.data(), S);
+        return *this;
+    }
+
     for (std::size_t i = 0; i < in_data.size(); ++i) {
         *this << in_data[i];
     }
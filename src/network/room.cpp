@@ -5,11 +5,16 @@
 #include <algorithm>
 #include <atomic>
 #include <iomanip>
+#include <list>
+#include <map>
 #include <mutex>
 #include <random>
 #include <regex>
+#include <shared_mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -43,10 +48,20 @@ public:
         VerifyUser::UserData user_data;
         ENetPeer* peer; ///< The remote peer.
     };
-    using MemberList = std::vector<Member>;
-    MemberList members;              ///< Information about the members of this room
-    mutable std::mutex member_mutex; ///< Mutex for locking the members list
-    /// This should be a std::shared_mutex as soon as C++17 is supported
+    using MemberList = std::list<Member>;
+    MemberList members;                     ///< Information about the members of this room
+    mutable std::shared_mutex member_mutex; ///< Mutex for locking the members list
+
+    // Indices into members for the lookups done while handling packets, so that these do not
+    // scan the whole member list. They are guarded by member_mutex along with members.
+    std::unordered_map<const ENetPeer*, MemberList::iterator> members_by_peer;
+    std::unordered_map<std::string, MemberList::iterator> members_by_nickname;
+    std::map<MacAddress, MemberList::iterator> members_by_mac;
+    std::unordered_set<std::string> console_id_hashes;
+
+    /// Nicknames of members that joined, left or changed since the last broadcast of member
+    /// changes. Guarded by member_mutex.
+    std::unordered_set<std::string> changed_members;
 
     UsernameBanList username_ban_list; ///< List of banned usernames
     IPBanList ip_ban_list;             ///< List of banned IP addresses
@@ -65,6 +80,34 @@ public:
     void ServerLoop();
     void StartLoop();
 
+    /// Dispatches a single received ENet event to its handler.
+    void HandleEvent(ENetEvent& event);
+
+    /**
+     * Adds a member to the member list and its indices, and marks it as changed.
+     * member_mutex must be held exclusively.
+     */
+    void AddMember(Member member);
+
+    /**
+     * Removes a member from the member list and its indices, and marks it as changed.
+     * member_mutex must be held exclusively.
+     */
+    void RemoveMember(MemberList::iterator member);
+
+    /**
+     * Returns the member connected through the given peer, or members.end() if there is none.
+     * member_mutex must be held.
+     */
+    MemberList::iterator FindMemberByPeer(const ENetPeer* peer);
+    MemberList::const_iterator FindMemberByPeer(const ENetPeer* peer) const;
+
+    /**
+     * Returns the member with the given nickname, or members.end() if there is none.
+     * member_mutex must be held.
+     */
+    MemberList::iterator FindMemberByNickname(const std::string& nickname);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -200,7 +243,8 @@ public:
 
     /**
      * Sends the information about the room, along with the list of members
-     * to every connected client in the room.
+     * to a client that has just joined the room. Everyone else is kept up to date with
+     * BroadcastMemberChanges.
      * The packet has the structure:
      * <MessageID>ID_ROOM_INFORMATION
      * <String> room_name
@@ -214,7 +258,25 @@ public:
      * <MacAddress> mac_address of that member
      * <String> game_name of that member
      */
-    void BroadcastRoomInformation();
+    void SendRoomInformation(ENetPeer* client);
+
+    /// Writes everything but the nickname of a member in the format used by IdRoomInformation.
+    static void WriteMemberDetails(Packet& packet, const Member& member);
+
+    /**
+     * Sends the members that joined, left or changed since the last call to every connected
+     * client in the room. Changes are coalesced per member, so a burst of joins, leaves or game
+     * changes results in a single packet.
+     * The packet has the structure:
+     * <MessageID>IdRoomMemberChanges
+     * <u32> num_changes
+     * This is followed by the following values for each changed member:
+     * <String> nickname of that member
+     * <u8> 1 if the member is in the room, 0 if it has left
+     * If the member is in the room, its information follows in the same format as in
+     * IdRoomInformation.
+     */
+    void BroadcastMemberChanges();
 
     /**
      * Generates a free MAC address to assign to a new client.
@@ -228,6 +290,13 @@ public:
      */
     void HandleWifiPacket(const ENetEvent* event);
 
+    /**
+     * Relays a netplay packet to all members except the sender, if its nickname matches the
+     * nickname of the sender.
+     * @param event The ENet event that was received.
+     */
+    void HandleNetPlayPacket(const ENetEvent* event);
+
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
      * @param event The ENet event that was received.
@@ -252,64 +321,118 @@ void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
         ENetEvent event;
         if (enet_host_service(server, &event, 50) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
+            // Handle every event that has already arrived before sending anything, so that member
+            // changes and outgoing packets are sent in one batch.
+            do {
+                HandleEvent(event);
+            } while (enet_host_check_events(server, &event) > 0);
+
+            BroadcastMemberChanges();
+            enet_host_flush(server);
         }
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+void Room::RoomImpl::HandleEvent(ENetEvent& event) {
+    switch (event.type) {
+    case ENET_EVENT_TYPE_RECEIVE:
+        switch (event.packet->data[0]) {
+        case IdJoinRequest:
+            HandleJoinRequest(&event);
+            break;
+        case IdSetGameInfo:
+            HandleGameNamePacket(&event);
+            break;
+        case IdWifiPacket:
+            HandleWifiPacket(&event);
+            break;
+        case IdChatMessage:
+            HandleChatPacket(&event);
+            break;
+        case IdNetPlayPacket:
+            HandleNetPlayPacket(&event);
+            break;
+        // Moderation
+        case IdModKick:
+            HandleModKickPacket(&event);
+            break;
+        case IdModBan:
+            HandleModBanPacket(&event);
+            break;
+        case IdModUnban:
+            HandleModUnbanPacket(&event);
+            break;
+        case IdModGetBanList:
+            HandleModGetBanListPacket(&event);
+            break;
+        }
+        // Packets that were relayed to other peers are destroyed by ENet once they were sent.
+        if (event.packet->referenceCount == 0) {
+            enet_packet_destroy(event.packet);
+        }
+        break;
+    case ENET_EVENT_TYPE_DISCONNECT:
+        HandleClientDisconnection(event.peer);
+        break;
+    case ENET_EVENT_TYPE_NONE:
+    case ENET_EVENT_TYPE_CONNECT:
+        break;
+    }
+}
+
+void Room::RoomImpl::AddMember(Member member) {
+    const auto iter = members.insert(members.end(), std::move(member));
+    members_by_peer.emplace(iter->peer, iter);
+    members_by_nickname.emplace(iter->nickname, iter);
+    members_by_mac.emplace(iter->mac_address, iter);
+    console_id_hashes.insert(iter->console_id_hash);
+    changed_members.insert(iter->nickname);
+}
+
+void Room::RoomImpl::RemoveMember(MemberList::iterator member) {
+    members_by_peer.erase(member->peer);
+    members_by_nickname.erase(member->nickname);
+    members_by_mac.erase(member->mac_address);
+    console_id_hashes.erase(member->console_id_hash);
+    changed_members.insert(member->nickname);
+    members.erase(member);
+}
+
+Room::RoomImpl::MemberList::iterator Room::RoomImpl::FindMemberByPeer(const ENetPeer* peer) {
+    const auto iter = members_by_peer.find(peer);
+    return iter == members_by_peer.end() ? members.end() : iter->second;
+}
+
+Room::RoomImpl::MemberList::const_iterator Room::RoomImpl::FindMemberByPeer(
+    const ENetPeer* peer) const {
+    const auto iter = members_by_peer.find(peer);
+    if (iter == members_by_peer.end()) {
+        return members.cend();
+    }
+    return iter->second;
+}
+
+Room::RoomImpl::MemberList::iterator Room::RoomImpl::FindMemberByNickname(
+    const std::string& nickname) {
+    const auto iter = members_by_nickname.find(nickname);
+    return iter == members_by_nickname.end() ? members.end() : iter->second;
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
 
 void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
     {
-        std::lock_guard lock(member_mutex);
+        std::shared_lock lock(member_mutex);
         if (members.size() >= room_information.member_slots) {
             SendRoomIsFull(event->peer);
             return;
         }
     }
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string nickname;
     packet >> nickname;
@@ -402,11 +525,12 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
-        members.push_back(std::move(member));
+        AddMember(std::move(member));
     }
 
-    // Notify everyone that the room information has changed.
-    BroadcastRoomInformation();
+    // The new member needs the full room information before it is told that it has joined.
+    // Everyone else learns about it from the next broadcast of member changes.
+    SendRoomInformation(event->peer);
     if (HasModPermission(event->peer)) {
         SendJoinSuccessAsMod(event->peer, preferred_mac);
     } else {
@@ -420,8 +544,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -430,9 +553,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
     std::string username;
     {
         std::lock_guard lock(member_mutex);
-        const auto target_member =
-            std::find_if(members.begin(), members.end(),
-                         [&nickname](const auto& member) { return member.nickname == nickname; });
+        const auto target_member = FindMemberByNickname(nickname);
         if (target_member == members.end()) {
             SendModNoSuchUser(event->peer);
             return;
@@ -444,12 +565,11 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         username = target_member->user_data.username;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        RemoveMember(target_member);
     }
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberKicked, nickname, username);
-    BroadcastRoomInformation();
 }
 
 void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
@@ -458,8 +578,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string nickname;
@@ -470,9 +589,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
-        const auto target_member =
-            std::find_if(members.begin(), members.end(),
-                         [&nickname](const auto& member) { return member.nickname == nickname; });
+        const auto target_member = FindMemberByNickname(nickname);
         if (target_member == members.end()) {
             SendModNoSuchUser(event->peer);
             return;
@@ -489,7 +606,7 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
-        members.erase(target_member);
+        RemoveMember(target_member);
     }
 
     {
@@ -512,7 +629,6 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
 
     // Announce the change to all clients.
     SendStatusMessage(IdMemberBanned, nickname, username);
-    BroadcastRoomInformation();
 }
 
 void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
@@ -521,8 +637,7 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
         return;
     }
 
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
 
     std::string address;
@@ -568,31 +683,25 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
     if (!std::regex_match(nickname, nickname_regex))
         return false;
 
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&nickname](const auto& member) { return member.nickname != nickname; });
+    std::shared_lock lock(member_mutex);
+    return members_by_nickname.count(nickname) == 0;
 }
 
 bool Room::RoomImpl::IsValidMacAddress(const MacAddress& address) const {
     // A MAC address is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.mac_address != address; });
+    std::shared_lock lock(member_mutex);
+    return members_by_mac.count(address) == 0;
 }
 
 bool Room::RoomImpl::IsValidConsoleId(const std::string& console_id_hash) const {
     // A Console ID is valid if it is not already taken by anybody else in the room.
-    std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(), [&console_id_hash](const auto& member) {
-        return member.console_id_hash != console_id_hash;
-    });
+    std::shared_lock lock(member_mutex);
+    return console_id_hashes.count(console_id_hash) == 0;
 }
 
 bool Room::RoomImpl::HasModPermission(const ENetPeer* client) const {
-    std::lock_guard lock(member_mutex);
-    const auto sending_member =
-        std::find_if(members.begin(), members.end(),
-                     [client](const auto& member) { return member.peer == client; });
+    std::shared_lock lock(member_mutex);
+    const auto sending_member = FindMemberByPeer(client);
     if (sending_member == members.end()) {
         return false;
     }
@@ -748,7 +857,7 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
 void Room::RoomImpl::SendCloseMessage() {
     Packet packet;
     packet << static_cast<u8>(IdCloseRoom);
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     if (!members.empty()) {
         ENetPacket* enet_packet =
             enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
@@ -769,7 +878,7 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     packet << static_cast<u8>(type);
     packet << nickname;
     packet << username;
-    std::lock_guard lock(member_mutex);
+    std::shared_lock lock(member_mutex);
     if (!members.empty()) {
         ENetPacket* enet_packet =
             enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
@@ -780,7 +889,16 @@ void Room::RoomImpl::SendStatusMessage(StatusMessageTypes type, const std::strin
     enet_host_flush(server);
 }
 
-void Room::RoomImpl::BroadcastRoomInformation() {
+void Room::RoomImpl::WriteMemberDetails(Packet& packet, const Member& member) {
+    packet << member.mac_address;
+    packet << member.game_info.name;
+    packet << member.game_info.id;
+    packet << member.user_data.username;
+    packet << member.user_data.display_name;
+    packet << member.user_data.avatar_url;
+}
+
+void Room::RoomImpl::SendRoomInformation(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdRoomInformation);
     packet << room_information.name;
@@ -790,24 +908,46 @@ void Room::RoomImpl::BroadcastRoomInformation() {
     packet << room_information.preferred_game;
     packet << room_information.host_username;
 
-    packet << static_cast<u32>(members.size());
     {
-        std::lock_guard lock(member_mutex);
+        std::shared_lock lock(member_mutex);
+        packet << static_cast<u32>(members.size());
         for (const auto& member : members) {
             packet << member.nickname;
-            packet << member.mac_address;
-            packet << member.game_info.name;
-            packet << member.game_info.id;
-            packet << member.user_data.username;
-            packet << member.user_data.display_name;
-            packet << member.user_data.avatar_url;
+            WriteMemberDetails(packet, member);
+        }
+    }
+
+    ENetPacket* enet_packet =
+        enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
+    enet_peer_send(client, 0, enet_packet);
+}
+
+void Room::RoomImpl::BroadcastMemberChanges() {
+    Packet packet;
+    {
+        std::lock_guard lock(member_mutex);
+        if (changed_members.empty()) {
+            return;
         }
+
+        packet << static_cast<u8>(IdRoomMemberChanges);
+        packet << static_cast<u32>(changed_members.size());
+        for (const auto& nickname : changed_members) {
+            packet << nickname;
+            const auto member = members_by_nickname.find(nickname);
+            if (member == members_by_nickname.end()) {
+                packet << static_cast<u8>(0);
+                continue;
+            }
+            packet << static_cast<u8>(1);
+            WriteMemberDetails(packet, *member->second);
+        }
+        changed_members.clear();
     }
 
     ENetPacket* enet_packet =
         enet_packet_create(packet.GetData(), packet.GetDataSize(), ENET_PACKET_FLAG_RELIABLE);
     enet_host_broadcast(server, 0, enet_packet);
-    enet_host_flush(server);
 }
 
 MacAddress Room::RoomImpl::GenerateMacAddress() {
@@ -823,8 +963,7 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
 }
 
 void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet(event->packet->data, event->packet->dataLength);
     in_packet.IgnoreBytes(sizeof(u8));         // Message type
     in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
     in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
@@ -832,57 +971,41 @@ void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
     MacAddress destination_address;
     in_packet >> destination_address;
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // The received packet is relayed as is. ENet keeps it alive until it has been sent to every
+    // peer, so there is no need to copy it into a new packet.
+    ENetPacket* enet_packet = event->packet;
 
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
-        std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
+        std::shared_lock lock(member_mutex);
         for (const auto& member : members) {
             if (member.peer != event->peer) {
-                sent_packet = true;
                 enet_peer_send(member.peer, 0, enet_packet);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
-        std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        std::shared_lock lock(member_mutex);
+        const auto member = members_by_mac.find(destination_address);
+        if (member != members_by_mac.end()) {
+            enet_peer_send(member->second->peer, 0, enet_packet);
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet(event->packet->data, event->packet->dataLength);
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     std::string message;
     in_packet >> message;
-    auto CompareNetworkAddress = [event](const Member member) -> bool {
-        return member.peer == event->peer;
-    };
 
-    std::lock_guard lock(member_mutex);
-    const auto sending_member = std::find_if(members.begin(), members.end(), CompareNetworkAddress);
+    std::shared_lock lock(member_mutex);
+    const auto sending_member = FindMemberByPeer(event->peer);
     if (sending_member == members.end()) {
         return; // Received a chat message from a unknown sender
     }
@@ -909,13 +1032,30 @@ void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
     if (!sent_packet) {
         enet_packet_destroy(enet_packet);
     }
+}
 
-    enet_host_flush(server);
+void Room::RoomImpl::HandleNetPlayPacket(const ENetEvent* event) {
+    Packet in_packet(event->packet->data, event->packet->dataLength);
+    in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+    std::string nickname;
+    in_packet >> nickname;
+
+    std::shared_lock lock(member_mutex);
+    const auto sending_member = FindMemberByPeer(event->peer);
+    if (sending_member == members.end() || sending_member->nickname != nickname) {
+        return; // Received a netplay packet from an unknown sender or with a forged nickname
+    }
+
+    // Like WiFi frames, the received packet is relayed without copying it.
+    for (const auto& member : members) {
+        if (member.peer != event->peer) {
+            enet_peer_send(member.peer, 0, event->packet);
+        }
+    }
 }
 
 void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
+    Packet in_packet(event->packet->data, event->packet->dataLength);
 
     in_packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
     GameInfo game_info;
@@ -924,15 +1064,12 @@ void Room::RoomImpl::HandleGameNamePacket(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
-        auto member =
-            std::find_if(members.begin(), members.end(), [event](const Member& member) -> bool {
-                return member.peer == event->peer;
-            });
+        const auto member = FindMemberByPeer(event->peer);
         if (member != members.end()) {
             member->game_info = game_info;
+            changed_members.insert(member->nickname);
         }
     }
-    BroadcastRoomInformation();
 }
 
 void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
@@ -940,13 +1077,11 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     std::string nickname, username;
     {
         std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(), [client](const Member& member) {
-            return member.peer == client;
-        });
+        const auto member = FindMemberByPeer(client);
         if (member != members.end()) {
             nickname = member->nickname;
             username = member->user_data.username;
-            members.erase(member);
+            RemoveMember(member);
         }
     }
 
@@ -954,7 +1089,6 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
     enet_peer_disconnect(client, 0);
     if (!nickname.empty())
         SendStatusMessage(IdMemberLeave, nickname, username);
-    BroadcastRoomInformation();
 }
 
 // Room
@@ -1020,7 +1154,7 @@ Room::BanList Room::GetBanList() const {
 
 std::vector<Room::Member> Room::GetRoomMemberList() const {
     std::vector<Room::Member> member_list;
-    std::lock_guard lock(room_impl->member_mutex);
+    std::shared_lock lock(room_impl->member_mutex);
     for (const auto& member_impl : room_impl->members) {
         Member member;
         member.nickname = member_impl.nickname;
@@ -1056,6 +1190,11 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->members_by_peer.clear();
+        room_impl->members_by_nickname.clear();
+        room_impl->members_by_mac.clear();
+        room_impl->console_id_hashes.clear();
+        room_impl->changed_members.clear();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
@@ -2,11 +2,14 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
-#include <list>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <utility>
+#include <vector>
 #include "common/assert.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -16,6 +19,10 @@ namespace Network {
 
 constexpr u32 ConnectionTimeoutMs = 5000;
 
+// How long the loop waits for incoming packets before sending the queued ones. Packets queued while
+// it waits are only sent afterwards, so this bounds the added latency of outgoing WiFi frames.
+constexpr u32 ServiceTimeoutMs = 5;
+
 class RoomMember::RoomMemberImpl {
 public:
     ENetHost* client = nullptr; ///< ENet network interface.
@@ -44,8 +51,10 @@ public:
     std::mutex network_mutex; ///< Mutex that controls access to the `client` variable.
     /// Thread that receives and dispatches network packets
     std::unique_ptr<std::thread> loop_thread;
-    std::mutex send_list_mutex;  ///< Mutex that controls access to the `send_list` variable.
-    std::list<Packet> send_list; ///< A list that stores all packets to send the async
+    std::mutex send_list_mutex; ///< Mutex that controls access to the `send_list` variable.
+    /// The packets to send the next time the loop thread runs. They are turned into ENet packets
+    /// by the sending thread so that the loop thread only has to queue them.
+    std::vector<ENetPacket*> send_list;
 
     template <typename T>
     using CallbackSet = std::set<CallbackHandle<T>>;
@@ -58,6 +67,7 @@ public:
 
     private:
         CallbackSet<WifiPacket> callback_set_wifi_packet;
+        CallbackSet<NetPlayPacket> callback_set_netplay_packet;
         CallbackSet<ChatEntry> callback_set_chat_messages;
         CallbackSet<StatusMessageEntry> callback_set_status_messages;
         CallbackSet<RoomInformation> callback_set_room_information;
@@ -73,10 +83,13 @@ public:
 
     /**
      * Sends data to the room. It will be send on channel 0 with flag RELIABLE
-     * @param packet The data to send
+     * @param packet The data to send. Its buffer is handed to ENet without a copy.
      */
     void Send(Packet&& packet);
 
+    /// Destroys the packets that were queued but not sent.
+    void ClearSendList();
+
     /**
      * Sends a request to the server, asking for permission to join a room with the specified
      * nickname and preferred mac.
@@ -101,12 +114,24 @@ public:
      */
     void HandleRoomInformationPacket(const ENetEvent* event);
 
+    /**
+     * Applies the member changes from a received ENet packet to the member information.
+     * @param event The ENet event that was received.
+     */
+    void HandleRoomMemberChangesPacket(const ENetEvent* event);
+
     /**
      * Extracts a WifiPacket from a received ENet packet.
      * @param event The  ENet event that was received.
      */
     void HandleWifiPackets(const ENetEvent* event);
 
+    /**
+     * Extracts a netplay packet from a received ENet packet.
+     * @param event The ENet event that was received.
+     */
+    void HandleNetPlayPacket(const ENetEvent* event);
+
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
      * @param event The ENet event that was received.
@@ -159,13 +184,16 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
     while (IsConnected()) {
         std::lock_guard lock(network_mutex);
         ENetEvent event;
-        if (enet_host_service(client, &event, 100) > 0) {
+        if (enet_host_service(client, &event, ServiceTimeoutMs) > 0) {
             switch (event.type) {
             case ENET_EVENT_TYPE_RECEIVE:
                 switch (event.packet->data[0]) {
                 case IdWifiPacket:
                     HandleWifiPackets(&event);
                     break;
+                case IdNetPlayPacket:
+                    HandleNetPlayPacket(&event);
+                    break;
                 case IdChatMessage:
                     HandleChatPacket(&event);
                     break;
@@ -175,6 +203,9 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
                 case IdRoomInformation:
                     HandleRoomInformationPacket(&event);
                     break;
+                case IdRoomMemberChanges:
+                    HandleRoomMemberChangesPacket(&event);
+                    break;
                 case IdJoinSuccess:
                 case IdJoinSuccessAsMod:
                     // The join request was successful, we are now in the room.
@@ -246,15 +277,14 @@ void RoomMember::RoomMemberImpl::MemberLoop() {
         }
         {
             std::lock_guard lock(send_list_mutex);
-            for (const auto& packet : send_list) {
-                ENetPacket* enetPacket = enet_packet_create(packet.GetData(), packet.GetDataSize(),
-                                                            ENET_PACKET_FLAG_RELIABLE);
-                enet_peer_send(server, 0, enetPacket);
+            for (ENetPacket* packet : send_list) {
+                enet_peer_send(server, 0, packet);
             }
             enet_host_flush(client);
             send_list.clear();
         }
     }
+    ClearSendList();
     Disconnect();
 };
 
@@ -263,8 +293,27 @@ void RoomMember::RoomMemberImpl::StartLoop() {
 }
 
 void RoomMember::RoomMemberImpl::Send(Packet&& packet) {
+    // ENet uses the buffer of the packet as it is and frees it through the callback once the
+    // packet was sent or destroyed.
+    auto buffer = std::make_unique<std::vector<char>>(packet.ReleaseData());
+    ENetPacket* enet_packet =
+        enet_packet_create(buffer->data(), buffer->size(),
+                           ENET_PACKET_FLAG_RELIABLE | ENET_PACKET_FLAG_NO_ALLOCATE);
+    enet_packet->userData = buffer.release();
+    enet_packet->freeCallback = [](ENetPacket* destroyed) {
+        delete static_cast<std::vector<char>*>(destroyed->userData);
+    };
+
     std::lock_guard lock(send_list_mutex);
-    send_list.push_back(std::move(packet));
+    send_list.push_back(enet_packet);
+}
+
+void RoomMember::RoomMemberImpl::ClearSendList() {
+    std::lock_guard lock(send_list_mutex);
+    for (ENetPacket* packet : send_list) {
+        enet_packet_destroy(packet);
+    }
+    send_list.clear();
 }
 
 void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
@@ -284,8 +333,7 @@ void RoomMember::RoomMemberImpl::SendJoinRequest(const std::string& nickname,
 }
 
 void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -327,9 +375,53 @@ void RoomMember::RoomMemberImpl::HandleRoomInformationPacket(const ENetEvent* ev
     Invoke(room_information);
 }
 
+void RoomMember::RoomMemberImpl::HandleRoomMemberChangesPacket(const ENetEvent* event) {
+    Packet packet(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
+
+    u32 num_changes;
+    packet >> num_changes;
+    for (u32 i = 0; i < num_changes; ++i) {
+        std::string member_nickname;
+        u8 present;
+        packet >> member_nickname;
+        packet >> present;
+
+        auto member = std::find_if(
+            member_information.begin(), member_information.end(),
+            [&member_nickname](const auto& member) { return member.nickname == member_nickname; });
+        if (!present) {
+            if (member != member_information.end()) {
+                member_information.erase(member);
+            }
+            continue;
+        }
+
+        if (member == member_information.end()) {
+            member = member_information.insert(member_information.end(), MemberInformation{});
+            member->nickname = member_nickname;
+        }
+        packet >> member->mac_address;
+        packet >> member->game_info.name;
+        packet >> member->game_info.id;
+        packet >> member->username;
+        packet >> member->display_name;
+        packet >> member->avatar_url;
+
+        {
+            std::lock_guard lock(username_mutex);
+            if (member->nickname == nickname) {
+                username = member->username;
+            }
+        }
+    }
+    Invoke(room_information);
+}
+
 void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -340,8 +432,7 @@ void RoomMember::RoomMemberImpl::HandleJoinPacket(const ENetEvent* event) {
 
 void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
     WifiPacket wifi_packet{};
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8)); // Ignore the message type
@@ -360,9 +451,20 @@ void RoomMember::RoomMemberImpl::HandleWifiPackets(const ENetEvent* event) {
     Invoke<WifiPacket>(wifi_packet);
 }
 
+void RoomMember::RoomMemberImpl::HandleNetPlayPacket(const ENetEvent* event) {
+    Packet packet(event->packet->data, event->packet->dataLength);
+
+    // Ignore the first byte, which is the message id.
+    packet.IgnoreBytes(sizeof(u8));
+
+    NetPlayPacket netplay_packet{};
+    packet >> netplay_packet.nickname;
+    packet >> netplay_packet.data;
+    Invoke<NetPlayPacket>(netplay_packet);
+}
+
 void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -375,8 +477,7 @@ void RoomMember::RoomMemberImpl::HandleChatPacket(const ENetEvent* event) {
 }
 
 void RoomMember::RoomMemberImpl::HandleStatusMessagePacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -391,8 +492,7 @@ void RoomMember::RoomMemberImpl::HandleStatusMessagePacket(const ENetEvent* even
 }
 
 void RoomMember::RoomMemberImpl::HandleModBanListResponsePacket(const ENetEvent* event) {
-    Packet packet;
-    packet.Append(event->packet->data, event->packet->dataLength);
+    Packet packet(event->packet->data, event->packet->dataLength);
 
     // Ignore the first byte, which is the message id.
     packet.IgnoreBytes(sizeof(u8));
@@ -436,6 +536,12 @@ RoomMember::RoomMemberImpl::CallbackSet<WifiPacket>& RoomMember::RoomMemberImpl:
     return callback_set_wifi_packet;
 }
 
+template <>
+RoomMember::RoomMemberImpl::CallbackSet<NetPlayPacket>&
+RoomMember::RoomMemberImpl::Callbacks::Get() {
+    return callback_set_netplay_packet;
+}
+
 template <>
 RoomMember::RoomMemberImpl::CallbackSet<RoomMember::State>&
 RoomMember::RoomMemberImpl::Callbacks::Get() {
@@ -543,6 +649,7 @@ void RoomMember::Join(const std::string& nick, const std::string& console_id_has
         ASSERT_MSG(room_member_impl->client != nullptr, "Could not create client");
     }
 
+    room_member_impl->ClearSendList();
     room_member_impl->SetState(State::Joining);
 
     ENetAddress address{};
@@ -577,6 +684,7 @@ bool RoomMember::IsConnected() const {
 
 void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
     Packet packet;
+    packet.Reserve(sizeof(u8) * 3 + sizeof(MacAddress) * 2 + sizeof(u32) + wifi_packet.data.size());
     packet << static_cast<u8>(IdWifiPacket);
     packet << static_cast<u8>(wifi_packet.type);
     packet << wifi_packet.channel;
@@ -586,6 +694,15 @@ void RoomMember::SendWifiPacket(const WifiPacket& wifi_packet) {
     room_member_impl->Send(std::move(packet));
 }
 
+void RoomMember::SendNetPlayPacket(const std::vector<u8>& data) {
+    Packet packet;
+    packet.Reserve(sizeof(u8) + sizeof(u32) * 2 + GetNickname().size() + data.size());
+    packet << static_cast<u8>(IdNetPlayPacket);
+    packet << GetNickname();
+    packet << data;
+    room_member_impl->Send(std::move(packet));
+}
+
 void RoomMember::SendChatMessage(const std::string& message) {
     Packet packet;
     packet << static_cast<u8>(IdChatMessage);
@@ -641,6 +758,11 @@ RoomMember::CallbackHandle<WifiPacket> RoomMember::BindOnWifiPacketReceived(
     return room_member_impl->Bind(callback);
 }
 
+RoomMember::CallbackHandle<NetPlayPacket> RoomMember::BindOnNetPlayPacketReceived(
+    std::function<void(const NetPlayPacket&)> callback) {
+    return room_member_impl->Bind(callback);
+}
+
 RoomMember::CallbackHandle<RoomInformation> RoomMember::BindOnRoomInformationChanged(
     std::function<void(const RoomInformation&)> callback) {
     return room_member_impl->Bind(callback);
@@ -671,12 +793,15 @@ void RoomMember::Leave() {
     room_member_impl->SetState(State::Idle);
     room_member_impl->loop_thread->join();
     room_member_impl->loop_thread.reset();
+    // Packets sent after the loop thread stopped would otherwise be sent to the next room
+    room_member_impl->ClearSendList();
 
     enet_host_destroy(room_member_impl->client);
     room_member_impl->client = nullptr;
 }
 
 template void RoomMember::Unbind(CallbackHandle<WifiPacket>);
+template void RoomMember::Unbind(CallbackHandle<NetPlayPacket>);
 template void RoomMember::Unbind(CallbackHandle<RoomMember::State>);
 template void RoomMember::Unbind(CallbackHandle<RoomMember::Error>);
 template void RoomMember::Unbind(CallbackHandle<RoomInformation>);
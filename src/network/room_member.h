@@ -40,6 +40,12 @@ struct ChatEntry {
     std::string message; ///< Body of the message.
 };
 
+/// Represents a packet of netplay data, which the room relays to every other member.
+struct NetPlayPacket {
+    std::string nickname; ///< Nickname of the client who sent this packet.
+    std::vector<u8> data; ///< Payload of the packet.
+};
+
 /// Represents a system status message.
 struct StatusMessageEntry {
     StatusMessageTypes type; ///< Type of the message
@@ -160,6 +166,12 @@ public:
      */
     void SendWifiPacket(const WifiPacket& packet);
 
+    /**
+     * Sends netplay data to every other member of the room.
+     * @param data The payload to send.
+     */
+    void SendNetPlayPacket(const std::vector<u8>& data);
+
     /**
      * Sends a chat message to the room.
      * @param message The contents of the message.
@@ -213,6 +225,16 @@ public:
     CallbackHandle<WifiPacket> BindOnWifiPacketReceived(
         std::function<void(const WifiPacket&)> callback);
 
+    /**
+     * Binds a function to an event that will be triggered every time a NetPlayPacket is received.
+     * The function wil be called every time the event is triggered.
+     * The callback function must not bind or unbind a function. Doing so will cause a deadlock
+     * @param callback The function to call
+     * @return A handle used for removing the function from the registered list
+     */
+    CallbackHandle<NetPlayPacket> BindOnNetPlayPacketReceived(
+        std::function<void(const NetPlayPacket&)> callback);
+
     /**
      * Binds a function to an event that will be triggered every time the RoomInformation changes.
      * The function wil be called every time the event is triggered.
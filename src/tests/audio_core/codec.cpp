@@ -0,0 +1,48 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/codec.h"
+
+namespace AudioCore::Codec {
+
+TEST_CASE("Codec - PCM decoding matches scalar reference", "[audio_core]") {
+    std::mt19937 rng(0x9C3);
+    std::uniform_int_distribution<int> byte_distribution(0, 255);
+
+    for (const std::size_t sample_count : {0, 1, 7, 8, 16, 33, 100}) {
+        std::vector<u8> data(sample_count * 4);
+        for (u8& byte : data) {
+            byte = static_cast<u8>(byte_distribution(rng));
+        }
+
+        StereoBuffer16 output;
+        for (const unsigned num_channels : {1u, 2u}) {
+            DecodePCM8(num_channels, data.data(), sample_count, output);
+            REQUIRE(output.size() == sample_count);
+            for (std::size_t i = 0; i < sample_count; ++i) {
+                for (std::size_t channel = 0; channel < 2; ++channel) {
+                    const u8 byte = data[num_channels == 1 ? i : i * 2 + channel];
+                    REQUIRE(output[i][channel] == static_cast<s16>(byte << 8));
+                }
+            }
+
+            DecodePCM16(num_channels, data.data(), sample_count, output);
+            REQUIRE(output.size() == sample_count);
+            for (std::size_t i = 0; i < sample_count; ++i) {
+                for (std::size_t channel = 0; channel < 2; ++channel) {
+                    const std::size_t index = num_channels == 1 ? i : i * 2 + channel;
+                    s16 sample;
+                    std::memcpy(&sample, data.data() + index * sizeof(s16), sizeof(s16));
+                    REQUIRE(output[i][channel] == sample);
+                }
+            }
+        }
+    }
+}
+
+} // namespace AudioCore::Codec
@@ -0,0 +1,105 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "audio_core/hle/decoded_pcm_cache.h"
+#include "common/file_util.h"
+#include "tests/audio_core/audio_fixures.h"
+
+namespace AudioCore::HLE {
+
+static DecodedPCMCache::Entry MakeEntry(u8 value, std::size_t size) {
+    DecodedPCMCache::Entry entry;
+    entry.num_channels = 2;
+    entry.num_samples = static_cast<u32>(size / 2);
+    entry.pcm[0].assign(size, value);
+    entry.pcm[1].assign(size, static_cast<u8>(~value));
+    return entry;
+}
+
+TEST_CASE("DecodedPCMCache - Evicts least recently used entries", "[audio_core][hle]") {
+    DecodedPCMCache cache(3 * 2 * 1024);
+
+    cache.Insert(1, MakeEntry(1, 1024));
+    cache.Insert(2, MakeEntry(2, 1024));
+    cache.Insert(3, MakeEntry(3, 1024));
+    REQUIRE(cache.GetMemoryUsage() == 3 * 2 * 1024);
+
+    // Touch the oldest entry so that the second one is evicted instead.
+    REQUIRE(cache.Find(1) != nullptr);
+    cache.Insert(4, MakeEntry(4, 1024));
+
+    REQUIRE(cache.GetMemoryUsage() == 3 * 2 * 1024);
+    REQUIRE(cache.Find(2) == nullptr);
+    REQUIRE(cache.Find(1) != nullptr);
+    REQUIRE(cache.Find(3) != nullptr);
+    const DecodedPCMCache::Entry* entry = cache.Find(4);
+    REQUIRE(entry != nullptr);
+    REQUIRE(entry->pcm[0] == std::vector<u8>(1024, 4));
+    REQUIRE(entry->pcm[1] == std::vector<u8>(1024, 0xFB));
+}
+
+TEST_CASE("DecodedPCMCache - Entries persist to disk", "[audio_core][hle]") {
+    const std::string path = "./decoded_pcm_cache_test/";
+
+    {
+        DecodedPCMCache cache(0x10000, path);
+        cache.Insert(0x1234, MakeEntry(7, 100));
+    }
+
+    {
+        DecodedPCMCache cache(0x10000, path);
+        const DecodedPCMCache::Entry* entry = cache.Find(0x1234);
+        REQUIRE(entry != nullptr);
+        REQUIRE(entry->num_channels == 2);
+        REQUIRE(entry->num_samples == 50);
+        REQUIRE(entry->pcm[0] == std::vector<u8>(100, 7));
+        REQUIRE(entry->pcm[1] == std::vector<u8>(100, 0xF8));
+        REQUIRE(cache.Find(0x5678) == nullptr);
+    }
+
+    FileUtil::DeleteDirRecursively(path);
+}
+
+TEST_CASE("DecodedPCMCache - Corrupt entries are ignored", "[audio_core][hle]") {
+    const std::string path = "./decoded_pcm_cache_corrupt_test/";
+
+    {
+        DecodedPCMCache cache(0x10000, path);
+        cache.Insert(0x1234, MakeEntry(7, 100));
+    }
+
+    // Claim far more PCM data than the file holds
+    {
+        FileUtil::IOFile file(path + "0000000000001234.pcm", "r+b");
+        REQUIRE(file.Seek(16, SEEK_SET));
+        const u32 pcm_size = 0xFFFFFFFF;
+        REQUIRE(file.WriteObject(pcm_size) == 1);
+    }
+
+    {
+        DecodedPCMCache cache(0x10000, path);
+        REQUIRE(cache.Find(0x1234) == nullptr);
+        REQUIRE(cache.GetMemoryUsage() == 0);
+    }
+
+    FileUtil::DeleteDirRecursively(path);
+}
+
+TEST_CASE("DecodedPCMCache - Keys depend on the previous input", "[audio_core][hle]") {
+    REQUIRE(DecodedPCMCache::MakeKey(1, 2) != DecodedPCMCache::MakeKey(2, 2));
+    REQUIRE(DecodedPCMCache::MakeKey(1, 2) != DecodedPCMCache::MakeKey(1, 3));
+    REQUIRE(DecodedPCMCache::MakeKey(1, 2) == DecodedPCMCache::MakeKey(1, 2));
+}
+
+TEST_CASE("DecodedPCMCache - Only whole ADTS frames are cacheable", "[audio_core][hle]") {
+    const u8* frame = fixure_buffer[0].data();
+
+    REQUIRE(DecodedPCMCache::IsCacheable(frame, fixure_buffer_size));
+    REQUIRE_FALSE(DecodedPCMCache::IsCacheable(frame, fixure_buffer_size - 1));
+    REQUIRE_FALSE(DecodedPCMCache::IsCacheable(frame + 1, fixure_buffer_size - 1));
+    REQUIRE_FALSE(DecodedPCMCache::IsCacheable(frame, 0));
+}
+
+} // namespace AudioCore::HLE
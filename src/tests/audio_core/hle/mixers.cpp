@@ -0,0 +1,130 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/mixers.h"
+
+namespace AudioCore::HLE {
+
+static s16 ReferenceClamp(s32 value) {
+    return static_cast<s16>(std::clamp(value, -32768, 32767));
+}
+
+TEST_CASE("Mixers - Stereo output matches scalar reference", "[audio_core][hle]") {
+    std::mt19937 rng(0x3D5);
+    std::uniform_int_distribution<s32> sample_distribution(-100000, 100000);
+
+    for (const float volume : {0.0f, 0.25f, 1.0f, 1.5f}) {
+        auto config = std::make_unique<DspConfiguration>();
+        std::memset(config.get(), 0, sizeof(DspConfiguration));
+        config->volume_0_dirty.Assign(1);
+        config->volume_1_dirty.Assign(1);
+        config->volume_2_dirty.Assign(1);
+        config->output_format_dirty.Assign(1);
+        config->volume[0] = volume;
+        config->volume[1] = volume * 0.5f;
+        config->volume[2] = 1.0f;
+        config->output_format = DspConfiguration::OutputFormat::Stereo;
+
+        std::array<QuadFrame32, 3> input;
+        for (auto& frame : input) {
+            for (auto& sample : frame) {
+                std::generate(sample.begin(), sample.end(),
+                              [&] { return sample_distribution(rng); });
+            }
+        }
+
+        auto read_samples = std::make_unique<IntermediateMixSamples>();
+        auto write_samples = std::make_unique<IntermediateMixSamples>();
+        std::memset(read_samples.get(), 0, sizeof(IntermediateMixSamples));
+
+        Mixers mixers;
+        mixers.Tick(*config, *read_samples, *write_samples, input);
+        const StereoFrame16 output = mixers.GetOutput();
+
+        StereoFrame16 expected{};
+        for (std::size_t mix = 0; mix < 3; ++mix) {
+            const float gain = config->volume[mix];
+            for (std::size_t i = 0; i < samples_per_frame; ++i) {
+                const auto& sample = input[mix][i];
+                const s16 left =
+                    ReferenceClamp(static_cast<s32>(gain * sample[0] + gain * sample[2]));
+                const s16 right =
+                    ReferenceClamp(static_cast<s32>(gain * sample[1] + gain * sample[3]));
+                expected[i][0] = ReferenceClamp(expected[i][0] + left);
+                expected[i][1] = ReferenceClamp(expected[i][1] + right);
+            }
+        }
+
+        REQUIRE(output == expected);
+    }
+}
+
+TEST_CASE("Mixers - Aux send and return transpose the intermediate mixes", "[audio_core][hle]") {
+    std::mt19937 rng(0xA5);
+    std::uniform_int_distribution<s32> sample_distribution(-20000, 20000);
+
+    auto config = std::make_unique<DspConfiguration>();
+    std::memset(config.get(), 0, sizeof(DspConfiguration));
+    config->mixer1_enabled_dirty.Assign(1);
+    config->mixer2_enabled_dirty.Assign(1);
+    config->volume_0_dirty.Assign(1);
+    config->volume_1_dirty.Assign(1);
+    config->volume_2_dirty.Assign(1);
+    config->output_format_dirty.Assign(1);
+    config->mixer1_enabled = 1;
+    config->mixer2_enabled = 1;
+    config->volume[0] = 0.0f;
+    config->volume[1] = 1.0f;
+    config->volume[2] = 0.5f;
+    config->output_format = DspConfiguration::OutputFormat::Stereo;
+
+    std::array<QuadFrame32, 3> input;
+    for (auto& frame : input) {
+        for (auto& sample : frame) {
+            std::generate(sample.begin(), sample.end(), [&] { return sample_distribution(rng); });
+        }
+    }
+
+    auto read_samples = std::make_unique<IntermediateMixSamples>();
+    auto write_samples = std::make_unique<IntermediateMixSamples>();
+    for (auto* samples : {&read_samples->mix1, &read_samples->mix2}) {
+        for (auto& channel : samples->pcm32) {
+            std::generate(std::begin(channel), std::end(channel),
+                          [&] { return sample_distribution(rng); });
+        }
+    }
+
+    Mixers mixers;
+    mixers.Tick(*config, *read_samples, *write_samples, input);
+    const StereoFrame16 output = mixers.GetOutput();
+
+    StereoFrame16 expected{};
+    for (std::size_t i = 0; i < samples_per_frame; ++i) {
+        for (std::size_t channel = 0; channel < 4; ++channel) {
+            REQUIRE(write_samples->mix1.pcm32[channel][i] == input[1][i][channel]);
+            REQUIRE(write_samples->mix2.pcm32[channel][i] == input[2][i][channel]);
+        }
+
+        // Mixes 1 and 2 are replaced by the samples returned by the application
+        for (std::size_t mix = 1; mix < 3; ++mix) {
+            const auto& returned = mix == 1 ? read_samples->mix1 : read_samples->mix2;
+            const float gain = config->volume[mix];
+            const s16 left = ReferenceClamp(static_cast<s32>(gain * returned.pcm32[0][i] +
+                                                             gain * returned.pcm32[2][i]));
+            const s16 right = ReferenceClamp(static_cast<s32>(gain * returned.pcm32[1][i] +
+                                                              gain * returned.pcm32[3][i]));
+            expected[i][0] = ReferenceClamp(expected[i][0] + left);
+            expected[i][1] = ReferenceClamp(expected[i][1] + right);
+        }
+    }
+
+    REQUIRE(output == expected);
+}
+
+} // namespace AudioCore::HLE
@@ -0,0 +1,48 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <random>
+#include <catch2/catch.hpp>
+#include "audio_core/hle/source.h"
+
+namespace AudioCore::HLE {
+
+TEST_CASE("Source - Mixing matches scalar reference", "[audio_core][hle]") {
+    std::mt19937 rng(0x51C);
+    std::uniform_int_distribution<s32> sample_distribution(-32768, 32767);
+    std::uniform_int_distribution<s32> mix_distribution(-1000000, 1000000);
+
+    StereoFrame16 source;
+    for (auto& sample : source) {
+        std::generate(sample.begin(), sample.end(),
+                      [&] { return static_cast<s16>(sample_distribution(rng)); });
+    }
+    // Extremes of the sample range
+    source[0] = {-32768, 32767};
+    source[1] = {32767, -32768};
+
+    for (const auto& gains : {std::array<float, 4>{0.0f, 0.0f, 0.0f, 0.0f},
+                              std::array<float, 4>{1.0f, 1.0f, 1.0f, 1.0f},
+                              std::array<float, 4>{0.5f, -0.75f, 1.3f, 0.001f},
+                              std::array<float, 4>{-2.0f, 3.7f, -0.33f, 8.0f}}) {
+        QuadFrame32 dest;
+        for (auto& sample : dest) {
+            std::generate(sample.begin(), sample.end(), [&] { return mix_distribution(rng); });
+        }
+
+        QuadFrame32 expected = dest;
+        for (std::size_t i = 0; i < samples_per_frame; ++i) {
+            expected[i][0] += static_cast<s32>(gains[0] * source[i][0]);
+            expected[i][1] += static_cast<s32>(gains[1] * source[i][1]);
+            expected[i][2] += static_cast<s32>(gains[2] * source[i][0]);
+            expected[i][3] += static_cast<s32>(gains[3] * source[i][1]);
+        }
+
+        MixStereoIntoQuad(dest, source, gains);
+        REQUIRE(dest == expected);
+    }
+}
+
+} // namespace AudioCore::HLE
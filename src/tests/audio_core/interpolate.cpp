@@ -0,0 +1,231 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/interpolate.h"
+
+namespace AudioCore::AudioInterp {
+
+using InterpFunction = std::size_t (*)(State&, const std::array<s16, 2>*, std::size_t, float,
+                                       StereoFrame16&, std::size_t&);
+
+constexpr double pi = 3.14159265358979323846;
+
+static std::vector<std::array<s16, 2>> GenerateSine(double period, std::size_t count) {
+    std::vector<std::array<s16, 2>> samples(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double value = 16000.0 * std::sin(2.0 * pi * i / period);
+        samples[i] = {static_cast<s16>(std::lround(value)), static_cast<s16>(std::lround(-value))};
+    }
+    return samples;
+}
+
+namespace Reference {
+
+// Straightforward versions of the interpolators, as they were written before they read their input
+// in place: the history is pushed onto the front of a deque and the consumed samples are erased.
+
+constexpr u64 scale_factor = 1 << 24;
+constexpr u64 scale_mask = scale_factor - 1;
+
+using Buffer = std::deque<std::array<s16, 2>>;
+
+template <std::size_t window_size>
+struct ReferenceState {
+    Buffer history = Buffer(window_size - 1);
+    u64 fposition = 0;
+};
+
+template <std::size_t window_size, typename Function>
+static void StepOverSamples(ReferenceState<window_size>& state, Buffer& input, float rate,
+                            StereoFrame16& output, std::size_t& outputi, Function fn) {
+    constexpr std::size_t lookbehind = window_size - 1;
+    if (input.empty())
+        return;
+
+    input.insert(input.begin(), state.history.begin(), state.history.end());
+
+    const u64 step_size = static_cast<u64>(rate * scale_factor);
+    u64 fposition = state.fposition;
+    std::size_t inputi = 0;
+
+    while (outputi < output.size()) {
+        inputi = static_cast<std::size_t>(fposition / scale_factor);
+
+        if (inputi + lookbehind >= input.size()) {
+            inputi = input.size() - lookbehind;
+            break;
+        }
+
+        std::array<std::array<s16, 2>, window_size> window;
+        std::copy_n(input.begin() + inputi, window_size, window.begin());
+        output[outputi++] = fn(fposition & scale_mask, window);
+
+        fposition += step_size;
+    }
+
+    state.history.assign(input.begin() + inputi, input.begin() + inputi + lookbehind);
+    state.fposition = fposition - inputi * scale_factor;
+
+    input.erase(input.begin(), input.begin() + inputi + lookbehind);
+}
+
+static std::array<s16, 2> None(u64 fraction, const std::array<std::array<s16, 2>, 3>& x) {
+    return x[0];
+}
+
+static std::array<s16, 2> Linear(u64 fraction, const std::array<std::array<s16, 2>, 3>& x) {
+    std::array<s16, 2> result;
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+        const s64 delta = std::clamp<s64>(x[1][channel] - x[0][channel], -32768, 32767);
+        result[channel] = static_cast<s16>(x[0][channel] + fraction * delta / scale_factor);
+    }
+    return result;
+}
+
+static std::array<s16, 2> Polyphase(u64 fraction, const std::array<std::array<s16, 2>, 8>& x) {
+    // Lanczos (a = 4) windowed sinc, quantized to Q14 with 256 phases, with the rounding error of
+    // each phase folded into its centre tap
+    constexpr double pi = 3.14159265358979323846;
+    const auto sinc = [pi](double v) { return v == 0.0 ? 1.0 : std::sin(pi * v) / (pi * v); };
+
+    const u64 phase = (fraction + (1 << 15)) >> 16;
+    const double offset = static_cast<double>(phase) / 256;
+    std::array<double, 8> taps;
+    double sum = 0.0;
+    for (std::size_t k = 0; k < 8; ++k) {
+        const double v = static_cast<double>(k) - 3 - offset;
+        taps[k] = std::abs(v) < 4 ? sinc(v) * sinc(v / 4) : 0.0;
+        sum += taps[k];
+    }
+    std::array<s32, 8> coeffs;
+    s32 total = 0;
+    for (std::size_t k = 0; k < 8; ++k) {
+        coeffs[k] = static_cast<s16>(std::lround(taps[k] / sum * 16384));
+        total += coeffs[k];
+    }
+    coeffs[offset < 0.5 ? 3 : 4] += 16384 - total;
+
+    std::array<s16, 2> result;
+    for (std::size_t channel = 0; channel < 2; ++channel) {
+        s32 acc = 1 << 13;
+        for (std::size_t k = 0; k < 8; ++k)
+            acc += coeffs[k] * x[k][channel];
+        result[channel] = static_cast<s16>(std::clamp(acc >> 14, -32768, 32767));
+    }
+    return result;
+}
+
+/// Resamples the whole input as one buffer, frame by frame.
+template <std::size_t window_size, typename Function>
+static std::vector<std::array<s16, 2>> Resample(Function fn, float rate,
+                                                const std::vector<std::array<s16, 2>>& input) {
+    ReferenceState<window_size> state;
+    Buffer buffer(input.begin(), input.end());
+    std::vector<std::array<s16, 2>> result;
+    while (!buffer.empty()) {
+        StereoFrame16 frame{};
+        std::size_t outputi = 0;
+        while (outputi < frame.size() && !buffer.empty()) {
+            StepOverSamples<window_size>(state, buffer, rate, frame, outputi, fn);
+        }
+        result.insert(result.end(), frame.begin(), frame.begin() + outputi);
+    }
+    return result;
+}
+
+} // namespace Reference
+
+/// Resamples input in chunks of chunk_size, as the HLE sources do with their buffers.
+static std::vector<std::array<s16, 2>> Resample(InterpFunction fn, float rate,
+                                                const std::vector<std::array<s16, 2>>& input,
+                                                std::size_t chunk_size) {
+    State state;
+    std::vector<std::array<s16, 2>> result;
+    std::size_t position = 0;
+    while (position < input.size()) {
+        StereoFrame16 frame{};
+        std::size_t outputi = 0;
+        while (outputi < frame.size() && position < input.size()) {
+            const std::size_t size = std::min(chunk_size, input.size() - position);
+            position += fn(state, input.data() + position, size, rate, frame, outputi);
+        }
+        result.insert(result.end(), frame.begin(), frame.begin() + outputi);
+    }
+    return result;
+}
+
+/// Signal-to-noise ratio of the left channel against the ideal resampled sine, in dB.
+static double MeasureSNR(const std::vector<std::array<s16, 2>>& output, double period, float rate,
+                         double predelay) {
+    double signal = 0.0;
+    double noise = 0.0;
+    // Skip the start, where the filter is still reading the zeroed history.
+    for (std::size_t i = 64; i < output.size(); ++i) {
+        const double position = i * static_cast<double>(rate) - predelay;
+        const double expected = 16000.0 * std::sin(2.0 * pi * position / period);
+        signal += expected * expected;
+        noise += (output[i][0] - expected) * (output[i][0] - expected);
+    }
+    return 10.0 * std::log10(signal / noise);
+}
+
+TEST_CASE("AudioInterp - Polyphase is more accurate than linear", "[audio_core]") {
+    const double period = 11.3;
+    const auto input = GenerateSine(period, 8192);
+
+    for (const float rate : {0.5f, 0.77f, 0.93f}) {
+        const auto linear = Resample(&Linear, rate, input, 8192);
+        const auto polyphase = Resample(&Polyphase, rate, input, 8192);
+
+        const double linear_snr = MeasureSNR(linear, period, rate, 2.0);
+        const double polyphase_snr = MeasureSNR(polyphase, period, rate, 4.0);
+        INFO("rate " << rate << ": linear " << linear_snr << " dB, polyphase " << polyphase_snr
+                     << " dB");
+        REQUIRE(polyphase_snr > 50.0);
+        REQUIRE(polyphase_snr > linear_snr);
+    }
+}
+
+TEST_CASE("AudioInterp - Output does not depend on input chunking", "[audio_core]") {
+    const auto input = GenerateSine(23.7, 4096);
+
+    for (const InterpFunction fn : {&None, &Linear, &Polyphase}) {
+        const auto whole = Resample(fn, 0.83f, input, input.size());
+        for (const std::size_t chunk_size : {1, 3, 7, 160}) {
+            REQUIRE(Resample(fn, 0.83f, input, chunk_size) == whole);
+        }
+    }
+}
+
+TEST_CASE("AudioInterp - Output matches the reference implementation", "[audio_core]") {
+    // Full scale noise, so that the saturating paths are exercised too
+    std::mt19937 rng(0x1A7E);
+    std::uniform_int_distribution<int> distribution(-32768, 32767);
+    std::vector<std::array<s16, 2>> input(2000);
+    for (auto& sample : input) {
+        sample = {static_cast<s16>(distribution(rng)), static_cast<s16>(distribution(rng))};
+    }
+
+    // Most rates leave a fractional position to carry into the next frame and the next chunk
+    for (const float rate : {0.25f, 0.5f, 0.77f, 1.0f, 1.3f, 2.71f}) {
+        INFO("rate " << rate);
+        const auto none = Reference::Resample<3>(&Reference::None, rate, input);
+        const auto linear = Reference::Resample<3>(&Reference::Linear, rate, input);
+        const auto polyphase = Reference::Resample<8>(&Reference::Polyphase, rate, input);
+        for (const std::size_t chunk_size : {1, 5, 160, 2000}) {
+            INFO("chunk size " << chunk_size);
+            REQUIRE(Resample(&None, rate, input, chunk_size) == none);
+            REQUIRE(Resample(&Linear, rate, input, chunk_size) == linear);
+            REQUIRE(Resample(&Polyphase, rate, input, chunk_size) == polyphase);
+        }
+    }
+}
+
+} // namespace AudioCore::AudioInterp
@@ -0,0 +1,58 @@
+// Copyright 2019 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "audio_core/audio_types.h"
+#include "audio_core/wave_sink.h"
+#include "common/file_util.h"
+
+namespace AudioCore {
+
+TEST_CASE("WaveSink - Writes a playable WAV file", "[audio_core]") {
+    const std::string path = "./wave_sink_test.wav";
+    std::array<s16, 2 * 4> frame{1, -1, 2, -2, 3, -3, 4, -4};
+
+    {
+        WaveSink sink(path);
+        REQUIRE(sink.IsEmulatedTime());
+        sink.PushSamples(frame.data(), 4, std::chrono::nanoseconds(1000));
+        sink.PushSamples(frame.data(), 2, std::chrono::nanoseconds(2000));
+    }
+
+    FileUtil::IOFile file(path, "rb");
+    std::vector<u8> data(static_cast<std::size_t>(file.GetSize()));
+    file.ReadBytes(data.data(), data.size());
+    file.Close();
+
+    const auto read_u32 = [&data](std::size_t offset) {
+        return static_cast<u32>(data[offset] | data[offset + 1] << 8 | data[offset + 2] << 16 |
+                                data[offset + 3] << 24);
+    };
+
+    constexpr std::size_t data_bytes = 6 * 2 * sizeof(s16);
+    REQUIRE(data.size() == 44 + data_bytes);
+    REQUIRE(std::string(data.begin(), data.begin() + 4) == "RIFF");
+    REQUIRE(read_u32(4) == 36 + data_bytes);
+    REQUIRE(std::string(data.begin() + 8, data.begin() + 12) == "WAVE");
+    REQUIRE(read_u32(24) == native_sample_rate);
+    REQUIRE(std::string(data.begin() + 36, data.begin() + 40) == "data");
+    REQUIRE(read_u32(40) == data_bytes);
+    REQUIRE(std::memcmp(data.data() + 44, frame.data(), sizeof(frame)) == 0);
+
+    FileUtil::IOFile timing(path + ".timing.csv", "rb");
+    std::string timing_text(static_cast<std::size_t>(timing.GetSize()), '\0');
+    timing.ReadBytes(timing_text.data(), timing_text.size());
+    timing.Close();
+    REQUIRE(timing_text == "frame,samples,dsp_ns\n0,4,1000\n1,2,2000\n");
+
+    FileUtil::Delete(path);
+    FileUtil::Delete(path + ".timing.csv");
+}
+
+} // namespace AudioCore
@@ -0,0 +1,85 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <deque>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/binary_log.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+
+namespace Log {
+
+TEST_CASE("TrimmedSourcePathLength", "[common][logging]") {
+    constexpr std::string_view path = "/home/user/citra/src/core/core.cpp";
+    static_assert(path.substr(TrimmedSourcePathLength(path)) == "core/core.cpp");
+    REQUIRE(TrimmedSourcePathLength("..\\..\\src\\common\\logging\\backend.cpp") ==
+            std::string_view("..\\..\\src\\").size());
+    REQUIRE(TrimmedSourcePathLength("src/srcfile.cpp") == 4);
+    REQUIRE(TrimmedSourcePathLength("core/core.cpp") == 0);
+}
+
+TEST_CASE("BinaryLog - Round trips messages", "[common][logging]") {
+    const std::string path = "./binary_log_test.bin";
+    SetGlobalFilter(Filter(Level::Trace));
+
+    REQUIRE(StartBinaryLog(path));
+    const std::string name = "name";
+    LOG_INFO(Common, "{} {} {:04X} {:.2f} {} {} {}", true, 'c', 0xAB, 1.5f, -7, name,
+             std::string_view("view"));
+    for (int i = 0; i < 3; ++i) {
+        LOG_DEBUG(Common_Filesystem, "iteration {:>3}", i);
+    }
+    LOG_INFO(Common, "{}", std::vector<int>{1, 2}.size());
+    StopBinaryLog();
+    SetGlobalFilter(Filter(Level::Info));
+
+    std::vector<Entry> entries;
+    REQUIRE(ReadBinaryLog(path, [&entries](const Entry& entry) {
+        Entry copy;
+        copy = entry;
+        entries.push_back(std::move(copy));
+    }));
+    FileUtil::Delete(path);
+
+    REQUIRE(entries.size() == 5);
+    REQUIRE(entries[0].message == "true c 00AB 1.50 -7 name view");
+    REQUIRE(entries[0].log_class == Class::Common);
+    REQUIRE(entries[0].log_level == Level::Info);
+    REQUIRE(entries[0].filename == "tests/common/logging.cpp");
+    REQUIRE(entries[1].message == "iteration   0");
+    REQUIRE(entries[3].message == "iteration   2");
+    REQUIRE(entries[3].line_num == entries[1].line_num);
+    REQUIRE(entries[4].message == "2");
+}
+
+TEST_CASE("BinaryLog - Writes sites registered during a write", "[common][logging]") {
+    const std::string path = "./binary_log_sites_test.bin";
+    constexpr int count = 20000;
+    // Every message has a new site, so that sites are registered while the writer drains the
+    // staging buffers
+    std::deque<SourceSite> sites(count);
+
+    REQUIRE(StartBinaryLog(path));
+    for (int i = 0; i < count; ++i) {
+        FmtLogMessage(sites[i], Class::Common, Level::Info, __FILE__, __LINE__, __func__,
+                      "site {}", i);
+    }
+    StopBinaryLog();
+
+    int decoded = 0;
+    bool in_order = true;
+    REQUIRE(ReadBinaryLog(path, [&decoded, &in_order](const Entry& entry) {
+        in_order &= entry.message == fmt::format("site {}", decoded);
+        ++decoded;
+    }));
+    FileUtil::Delete(path);
+    REQUIRE(decoded == count);
+    REQUIRE(in_order);
+}
+
+} // namespace Log
@@ -0,0 +1,52 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <string>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/metrics.h"
+
+namespace Common::Metrics {
+
+TEST_CASE("Metrics - Exports registered metrics", "[common]") {
+    Counter& counter = GetCounter("test_requests_total", "Test\\requests\nhandled");
+    Gauge& gauge = GetGauge("test_cache_bytes", "Test cache size");
+    Summary& summary = GetSummary("test_latency_seconds", "Test latency");
+    REQUIRE(&GetCounter("test_requests_total", "Ignored") == &counter);
+
+    counter.Increment();
+    counter.Increment(2);
+    gauge.Set(1.5);
+    gauge.Add(-1);
+    summary.Observe(0.25);
+    summary.Observe(0.5);
+    REQUIRE(counter.Get() == 3);
+    REQUIRE(gauge.Get() == 0.5);
+    REQUIRE(summary.GetSum() == 0.75);
+    REQUIRE(summary.GetCount() == 2);
+
+    const std::string text = ExportText();
+    REQUIRE(text.find("# HELP test_requests_total Test\\\\requests\\nhandled\n"
+                      "# TYPE test_requests_total counter\n"
+                      "test_requests_total 3\n") != std::string::npos);
+    REQUIRE(text.find("# HELP test_cache_bytes Test cache size\n"
+                      "# TYPE test_cache_bytes gauge\n"
+                      "test_cache_bytes 0.5\n") != std::string::npos);
+    REQUIRE(text.find("# HELP test_latency_seconds Test latency\n"
+                      "# TYPE test_latency_seconds summary\n"
+                      "test_latency_seconds_sum 0.75\n"
+                      "test_latency_seconds_count 2\n") != std::string::npos);
+    // Metrics are sorted by name
+    REQUIRE(text.find("test_cache_bytes") < text.find("test_requests_total"));
+
+    const std::string path = "./metrics_test.prom";
+    { FileExporter exporter(path, std::chrono::hours(1)); }
+    std::string exported;
+    FileUtil::ReadFileToString(false, path, exported);
+    FileUtil::Delete(path);
+    REQUIRE(exported == ExportText());
+}
+
+} // namespace Common::Metrics
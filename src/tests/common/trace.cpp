@@ -0,0 +1,62 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "common/trace.h"
+
+namespace Common::Trace {
+
+TEST_CASE("Trace - Dumps recent events", "[common]") {
+    const std::string path = "./trace_test.json";
+    Enable(2, std::chrono::milliseconds(0), "./");
+    SetThreadName("Test \"Thread\"");
+
+    { ScopedEvent event("Group", "Dropped"); }
+    { ScopedEvent event("Group", "First"); }
+    RecordEvent("Group", "Second", Now(), Now());
+
+    REQUIRE(Dump(path));
+    std::string json;
+    FileUtil::ReadFileToString(true, path, json);
+    FileUtil::Delete(path);
+    Disable();
+
+    REQUIRE(json.find("\"name\":\"Test \\\"Thread\\\"\"") != std::string::npos);
+    REQUIRE(json.find("\"name\":\"Dropped\"") == std::string::npos);
+    const auto first = json.find("\"name\":\"First\"");
+    const auto second = json.find("\"name\":\"Second\"");
+    REQUIRE(first != std::string::npos);
+    REQUIRE(second != std::string::npos);
+    REQUIRE(first < second);
+
+    { ScopedEvent event("Group", "Disabled"); }
+    REQUIRE(Dump(path));
+    FileUtil::ReadFileToString(true, path, json);
+    FileUtil::Delete(path);
+    REQUIRE(json.find("\"ph\":\"X\"") == std::string::npos);
+}
+
+TEST_CASE("Trace - Keeps events when enabled again", "[common]") {
+    const std::string path = "./trace_test.json";
+    Enable(4, std::chrono::milliseconds(0), "./");
+    { ScopedEvent event("Group", "Kept"); }
+
+    std::string json;
+    Enable(4, std::chrono::milliseconds(100), "./");
+    REQUIRE(Dump(path));
+    FileUtil::ReadFileToString(true, path, json);
+    REQUIRE(json.find("\"name\":\"Kept\"") != std::string::npos);
+
+    // A different buffer size starts over
+    Enable(8, std::chrono::milliseconds(100), "./");
+    REQUIRE(Dump(path));
+    FileUtil::ReadFileToString(true, path, json);
+    FileUtil::Delete(path);
+    Disable();
+    REQUIRE(json.find("\"name\":\"Kept\"") == std::string::npos);
+}
+
+} // namespace Common::Trace
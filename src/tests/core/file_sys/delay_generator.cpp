@@ -0,0 +1,49 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/file_sys/delay_generator.h"
+
+namespace FileSys {
+
+TEST_CASE("DelayProfile - Parses profiles", "[core][file_sys]") {
+    const auto profile = ParseDelayProfile("# Loads too fast otherwise\n"
+                                           "percentage = 150\n"
+                                           "\n"
+                                           "  read_base_ns=1000  \n"
+                                           "read_ns_per_byte = 2\n");
+    REQUIRE(profile.has_value());
+    REQUIRE(profile->percentage == 150u);
+    REQUIRE(!profile->open_ns.has_value());
+
+    // Unset values keep the timing of the archive
+    REQUIRE(profile->GetOpenDelayNs(5000) == 5000);
+    REQUIRE(profile->GetReadDelayNs(100, 5000) == 1000 + 100 * 2);
+
+    const auto empty = ParseDelayProfile("");
+    REQUIRE(empty.has_value());
+    REQUIRE(!empty->percentage.has_value());
+    REQUIRE(empty->GetReadDelayNs(100, 5000) == 5000);
+
+    REQUIRE(!ParseDelayProfile("percentage = fast\n").has_value());
+    REQUIRE(!ParseDelayProfile("percentage = 10 ms\n").has_value());
+    REQUIRE(!ParseDelayProfile("percentage\n").has_value());
+    REQUIRE(!ParseDelayProfile("unknown = 1\n").has_value());
+}
+
+TEST_CASE("DelayHistogram - Buckets sizes and latencies", "[core][file_sys]") {
+    DelayHistogram histogram;
+    histogram.Record(0x1000, 3000, 600000);
+    histogram.Record(0x1800, 0, 700000);
+
+    REQUIRE(histogram.count == 2);
+    REQUIRE(histogram.total_size == 0x2800);
+    REQUIRE(histogram.total_latency_ns == 3000);
+    REQUIRE(histogram.total_delay_ns == 1300000);
+    REQUIRE(histogram.size_buckets[12] == 2);
+    REQUIRE(histogram.latency_buckets[0] == 1);
+    REQUIRE(histogram.latency_buckets[1] == 1);
+}
+
+} // namespace FileSys
@@ -0,0 +1,122 @@
+// Copyright 2018 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <numeric>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "core/file_sys/disk_archive.h"
+#include "core/file_sys/errors.h"
+
+namespace FileSys {
+
+static std::unique_ptr<DiskFile> OpenDiskFile(const std::string& path, const char* open_mode) {
+    Mode mode{};
+    mode.read_flag.Assign(1);
+    mode.write_flag.Assign(1);
+    return std::make_unique<DiskFile>(FileUtil::IOFile(path, open_mode), mode,
+                                      std::make_unique<DefaultDelayGenerator>());
+}
+
+TEST_CASE("DiskFile - Write-back cache", "[core][file_sys]") {
+    const std::string test_file = "./test_disk_file.bin";
+
+    std::vector<u8> data(0x100);
+    std::iota(data.begin(), data.end(), 0);
+
+    {
+        auto file = OpenDiskFile(test_file, "w+b");
+
+        // Small contiguous writes are coalesced, but must still be visible to reads and GetSize
+        for (std::size_t offset = 0; offset < data.size(); offset += 0x10) {
+            REQUIRE(file->Write(offset, 0x10, true, data.data() + offset).Unwrap() == 0x10);
+        }
+        REQUIRE(file->GetSize() == data.size());
+
+        std::array<u8, 0x20> read{};
+        REQUIRE(file->Read(0x40, read.size(), read.data()).Unwrap() == read.size());
+        REQUIRE(std::equal(read.begin(), read.end(), data.begin() + 0x40));
+
+        // A non-contiguous write breaks the cached run
+        const std::array<u8, 4> patch{0xDE, 0xAD, 0xBE, 0xEF};
+        REQUIRE(file->Write(0x08, patch.size(), false, patch.data()).Unwrap() == patch.size());
+        std::copy(patch.begin(), patch.end(), data.begin() + 0x08);
+
+        // Writes past the end grow the file
+        REQUIRE(file->Write(data.size(), patch.size(), false, patch.data()).Unwrap() ==
+                patch.size());
+        data.insert(data.end(), patch.begin(), patch.end());
+        REQUIRE(file->GetSize() == data.size());
+
+        REQUIRE(file->Close());
+    }
+
+    {
+        auto file = OpenDiskFile(test_file, "r+b");
+        REQUIRE(file->GetSize() == data.size());
+
+        std::vector<u8> read(data.size());
+        REQUIRE(file->Read(0, read.size(), read.data()).Unwrap() == read.size());
+        REQUIRE(read == data);
+
+        // Pending writes are written out when the file is destroyed without being closed
+        const std::array<u8, 2> header{0xAA, 0x55};
+        REQUIRE(file->Write(0, header.size(), false, header.data()).Unwrap() == header.size());
+        std::copy(header.begin(), header.end(), data.begin());
+    }
+
+    {
+        auto file = OpenDiskFile(test_file, "rb");
+        std::vector<u8> read(data.size());
+        REQUIRE(file->Read(0, read.size(), read.data()).Unwrap() == read.size());
+        REQUIRE(read == data);
+    }
+
+    FileUtil::Delete(test_file);
+}
+
+TEST_CASE("DiskFile - Flushed writes reach the host file", "[core][file_sys]") {
+    const std::string test_file = "./test_disk_file_flush.bin";
+    auto file = OpenDiskFile(test_file, "w+b");
+
+    const std::array<u8, 4> data{1, 2, 3, 4};
+    REQUIRE(file->Write(0, 2, false, data.data()).Unwrap() == 2);
+    REQUIRE(FileUtil::GetSize(test_file) == 0);
+
+    // A flushed write also writes out the cached data before it, so other handles see both
+    REQUIRE(file->Write(2, 2, true, data.data() + 2).Unwrap() == 2);
+    REQUIRE(FileUtil::GetSize(test_file) == data.size());
+    std::array<u8, 4> read{};
+    FileUtil::IOFile other(test_file, "rb");
+    REQUIRE(other.ReadBytes(read.data(), read.size()) == read.size());
+    REQUIRE(read == data);
+
+    other.Close();
+    file->Close();
+    FileUtil::Delete(test_file);
+}
+
+TEST_CASE("DiskFile - Failed write-backs keep the cached data", "[core][file_sys]") {
+    const std::string test_file = "./test_disk_file_failure.bin";
+    FileUtil::IOFile(test_file, "wb").Close();
+
+    // The host file is read-only, so the cached data can't be written back
+    auto file = OpenDiskFile(test_file, "rb");
+    const std::array<u8, 4> data{1, 2, 3, 4};
+    REQUIRE(file->Write(0, data.size(), false, data.data()).Unwrap() == data.size());
+
+    std::array<u8, 4> read{};
+    REQUIRE(file->Read(0, read.size(), read.data()).Code() == ERROR_INSUFFICIENT_SPACE);
+    REQUIRE(!file->SetSize(0));
+    REQUIRE(!file->Flush());
+    REQUIRE(file->GetSize() == data.size());
+    REQUIRE(file->Write(0x10, data.size(), false, data.data()).Code() ==
+            ERROR_INSUFFICIENT_SPACE);
+    REQUIRE(!file->Close());
+
+    FileUtil::Delete(test_file);
+}
+
+} // namespace FileSys
@@ -0,0 +1,179 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/file_sys/lzss.h"
+
+namespace FileSys {
+
+namespace {
+
+struct Compressed {
+    std::vector<u8> buffer; ///< Compressed file, padded to the decompressed size
+    u32 compressed_size;
+    std::size_t uncompressed_size; ///< Size of the data at the start stored as it is
+    unsigned overlapping_references = 0;
+    unsigned block_references = 0;
+};
+
+/**
+ * Greedy reference encoder. The data is encoded from its end, and as much of it is compressed as
+ * possible without the output of the in-place decoder overtaking its input.
+ */
+Compressed Compress(const std::vector<u8>& data) {
+    struct Token {
+        std::size_t pos;         ///< Start of the data decoded so far
+        std::size_t stream_size; ///< Compressed bytes read so far
+        bool overlapping;
+        bool reference;
+    };
+
+    std::vector<u8> stream; // In the order the decoder reads it, i.e. from the top down
+    std::vector<Token> tokens;
+    std::size_t control_index = 0;
+    unsigned token = 8;
+
+    std::size_t pos = data.size();
+    while (pos > 0) {
+        if (token == 8) {
+            control_index = stream.size();
+            stream.push_back(0);
+            token = 0;
+        }
+
+        std::size_t best_size = 0;
+        std::size_t best_distance = 0;
+        for (std::size_t distance = 3; distance <= 0x1002 && pos - 1 + distance < data.size();
+             ++distance) {
+            std::size_t size = 0;
+            while (size < 18 && size < pos &&
+                   data[pos - 1 - size] == data[pos - 1 - size + distance]) {
+                ++size;
+            }
+            if (size > best_size) {
+                best_size = size;
+                best_distance = distance;
+            }
+        }
+
+        if (best_size >= 3) {
+            const u16 reference = static_cast<u16>((best_size - 3) << 12 | (best_distance - 3));
+            stream[control_index] |= 0x80 >> token;
+            stream.push_back(static_cast<u8>(reference >> 8));
+            stream.push_back(static_cast<u8>(reference & 0xFF));
+            pos -= best_size;
+        } else {
+            stream.push_back(data[--pos]);
+        }
+        tokens.push_back({pos, stream.size(), best_size >= 3 && best_distance < best_size,
+                          best_size >= 3});
+        ++token;
+    }
+
+    // Keep the longest run of tokens after each of which the decoder has written no further down
+    // than it has read. The data below the last one is stored as it is.
+    std::size_t token_count = tokens.size();
+    for (; token_count > 0; --token_count) {
+        const Token& last = tokens[token_count - 1];
+        const bool safe = std::all_of(tokens.begin(), tokens.begin() + token_count,
+                                      [&last](const Token& token) {
+                                          return token.pos - last.pos >=
+                                                 last.stream_size - token.stream_size;
+                                      });
+        if (safe) {
+            break;
+        }
+    }
+
+    Compressed result;
+    result.uncompressed_size = token_count > 0 ? tokens[token_count - 1].pos : data.size();
+    const std::size_t stream_size = token_count > 0 ? tokens[token_count - 1].stream_size : 0;
+    for (std::size_t i = 0; i < token_count; ++i) {
+        if (tokens[i].overlapping) {
+            ++result.overlapping_references;
+        } else if (tokens[i].reference) {
+            ++result.block_references;
+        }
+    }
+
+    const u32 top = static_cast<u32>(result.uncompressed_size + stream_size);
+    result.compressed_size = top + 8;
+    result.buffer.assign(std::max<std::size_t>(data.size(), result.compressed_size), 0);
+    std::memcpy(result.buffer.data(), data.data(), result.uncompressed_size);
+    std::reverse_copy(stream.begin(), stream.begin() + stream_size,
+                      result.buffer.begin() + result.uncompressed_size);
+
+    const u32 buffer_top_and_bottom =
+        8u << 24 | static_cast<u32>(result.compressed_size - result.uncompressed_size);
+    const u32 additional_size = static_cast<u32>(data.size() - result.compressed_size);
+    std::memcpy(&result.buffer[top], &buffer_top_and_bottom, sizeof(u32));
+    std::memcpy(&result.buffer[top + 4], &additional_size, sizeof(u32));
+    return result;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("LZSS - Round trips compressed data", "[core][file_sys]") {
+    std::mt19937 rng(0x125);
+    const auto random = [&rng](std::size_t min, std::size_t max) {
+        return std::uniform_int_distribution<std::size_t>(min, max)(rng);
+    };
+
+    // Random data that does not compress, followed by runs, repeated blocks and a few literals
+    std::vector<u8> data(64);
+    std::generate(data.begin(), data.end(), [&] { return static_cast<u8>(random(0, 255)); });
+    data.insert(data.end(), 16, 0);
+    while (data.size() < 0x2000) {
+        switch (random(0, 2)) {
+        case 0:
+            data.insert(data.end(), random(3, 40), static_cast<u8>(random(0, 255)));
+            break;
+        case 1: {
+            const std::size_t distance = random(3, std::min<std::size_t>(data.size() - 64, 100));
+            for (std::size_t i = random(3, 40); i > 0; --i) {
+                const u8 byte = data[data.size() - distance];
+                data.push_back(byte);
+            }
+            break;
+        }
+        default:
+            for (std::size_t i = random(1, 3); i > 0; --i) {
+                data.push_back(static_cast<u8>(random(0, 255)));
+            }
+            break;
+        }
+    }
+
+    Compressed compressed = Compress(data);
+    REQUIRE(compressed.uncompressed_size > 0);
+    REQUIRE(compressed.overlapping_references > 0);
+    REQUIRE(compressed.block_references > 0);
+    REQUIRE(compressed.buffer.size() == data.size());
+
+    u8* const buffer = compressed.buffer.data();
+    const u32 decompressed_size = LZSS_GetDecompressedSize(buffer, compressed.compressed_size);
+    REQUIRE(decompressed_size == data.size());
+    REQUIRE(LZSS_Decompress(buffer, compressed.compressed_size, decompressed_size));
+    REQUIRE(compressed.buffer == data);
+}
+
+TEST_CASE("LZSS - Handles empty input", "[core][file_sys]") {
+    std::vector<u8> buffer(8);
+    REQUIRE(LZSS_GetDecompressedSize(buffer.data(), 0) == 0);
+    REQUIRE(!LZSS_Decompress(buffer.data(), 0, 0));
+
+    // A file with an empty compressed region decompresses to itself
+    const u32 buffer_top_and_bottom = 8u << 24 | 8;
+    std::memcpy(buffer.data(), &buffer_top_and_bottom, sizeof(u32));
+    const std::vector<u8> expected = buffer;
+    REQUIRE(LZSS_GetDecompressedSize(buffer.data(), 8) == 8);
+    REQUIRE(LZSS_Decompress(buffer.data(), 8, 8));
+    REQUIRE(buffer == expected);
+}
+
+} // namespace FileSys
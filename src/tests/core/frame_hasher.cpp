@@ -0,0 +1,59 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <catch2/catch.hpp>
+#include "core/frame_hasher.h"
+#include "core/hw/gpu.h"
+#include "core/memory.h"
+
+TEST_CASE("FrameHasher::ReadScreen", "[core]") {
+    Memory::MemorySystem memory;
+    auto& framebuffer = GPU::g_regs.framebuffer_config[0];
+    std::memset(&framebuffer, 0, sizeof(framebuffer));
+
+    SECTION("returns nothing before the screen is set up") {
+        REQUIRE(Core::FrameHasher::ReadScreen(memory, 0).pixels.empty());
+    }
+
+    SECTION("rotates the framebuffer upright") {
+        // A 2x3 RGBA8 framebuffer, whose rows are the columns of a 3x2 screen
+        framebuffer.width.Assign(2);
+        framebuffer.height.Assign(3);
+        framebuffer.stride = 2 * 4;
+        framebuffer.color_format.Assign(GPU::Regs::PixelFormat::RGBA8);
+        framebuffer.address_left1 = Memory::VRAM_PADDR;
+        u8* data = memory.GetPhysicalPointer(Memory::VRAM_PADDR);
+        for (u8 i = 0; i < 6; ++i) {
+            // Stored as ABGR
+            const u8 pixel[] = {0, 0, 0, i};
+            std::memcpy(data + i * 4, pixel, sizeof(pixel));
+        }
+
+        const auto image = Core::FrameHasher::ReadScreen(memory, 0);
+        REQUIRE(image.width == 3);
+        REQUIRE(image.height == 2);
+        // The first pixel of the framebuffer is the bottom left one of the screen
+        const u8 expected_red[] = {1, 3, 5, 0, 2, 4};
+        for (int i = 0; i < 6; ++i) {
+            REQUIRE(image.pixels[i * 4] == expected_red[i]);
+            REQUIRE(image.pixels[i * 4 + 3] == 255);
+        }
+    }
+
+    SECTION("reads a framebuffer at the end of VRAM") {
+        framebuffer.width.Assign(2);
+        framebuffer.height.Assign(3);
+        framebuffer.stride = 2 * 4;
+        framebuffer.color_format.Assign(GPU::Regs::PixelFormat::RGBA8);
+        framebuffer.address_left1 = Memory::VRAM_PADDR + Memory::VRAM_SIZE - 2 * 4 * 3;
+
+        const auto image = Core::FrameHasher::ReadScreen(memory, 0);
+        REQUIRE(image.width == 3);
+        REQUIRE(image.height == 2);
+        REQUIRE(image.pixels.size() == 3 * 2 * 4);
+    }
+
+    std::memset(&framebuffer, 0, sizeof(framebuffer));
+}
@@ -0,0 +1,56 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/core.h"
+#include "core/core_timing.h"
+#include "core/guest_sampler.h"
+#include "core/hle/kernel/kernel.h"
+#include "core/hle/kernel/process.h"
+#include "core/memory.h"
+
+namespace Core {
+
+TEST_CASE("GuestSampler - Aggregates samples into folded stacks", "[core]") {
+    Timing timing;
+    Memory::MemorySystem memory;
+    Kernel::KernelSystem kernel(memory, timing, [] {}, 0);
+    GuestSampler sampler(System::GetInstance(), timing);
+
+    auto codeset = kernel.CreateCodeSet("game", 0);
+    codeset->CodeSegment().addr = 0x100000;
+    codeset->CodeSegment().size = 0x1000;
+    auto process = kernel.CreateProcess(codeset);
+    sampler.AddModule(process->process_id, "module", 0x200000, 0x800);
+
+    for (int i = 0; i < 4; ++i) {
+        sampler.RecordSample(nullptr, 0, 0, 0);
+    }
+    for (int i = 0; i < 3; ++i) {
+        sampler.RecordSample(process.get(), 1, 0x100010, 0x100100);
+    }
+    for (int i = 0; i < 2; ++i) {
+        sampler.RecordSample(process.get(), 1, 0x200010, 0x100200);
+    }
+    // Past the end of the module
+    sampler.RecordSample(process.get(), 2, 0x200800, 0x200004);
+
+    REQUIRE(sampler.GetSampleCount() == 10);
+    REQUIRE(sampler.GetFoldedStacks() == "[idle] 4\n"
+                                         "game;thread 1;game!0x00100100;game!0x00100010 3\n"
+                                         "game;thread 1;game!0x00100200;module+0x10 2\n"
+                                         "game;thread 2;module+0x4;0x00200800 1\n");
+
+    // Addresses of an unloaded module are no longer attributed to it
+    sampler.RemoveModule(process->process_id, 0x200000);
+    sampler.RecordSample(process.get(), 3, 0x200010, 0x100200);
+    REQUIRE(sampler.GetFoldedStacks().find("game;thread 3;game!0x00100200;0x00200010 1\n") !=
+            std::string::npos);
+
+    sampler.Clear();
+    REQUIRE(sampler.GetSampleCount() == 0);
+    REQUIRE(sampler.GetFoldedStacks().empty());
+}
+
+} // namespace Core
@@ -0,0 +1,44 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <catch2/catch.hpp>
+#include "core/hle/service/service_stats.h"
+
+namespace Service {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("CallStatistics", "[core][hle]") {
+    CallStatistics statistics;
+    CommandStatistics& read = statistics.Get("fs:USER", "Read");
+    CommandStatistics& open = statistics.Get("fs:USER", "OpenFile");
+    REQUIRE(&statistics.Get("fs:USER", "Read") == &read);
+
+    for (int i = 0; i < 99; ++i) {
+        read.Record(1000ns, std::nullopt);
+    }
+    read.Record(1ms, 5ms);
+    open.Record(100ns, -1ns);
+
+    const auto entries = statistics.GetEntries();
+    REQUIRE(entries.size() == 2);
+    REQUIRE(entries[0].function_name == "Read");
+    REQUIRE(entries[0].count == 100);
+    REQUIRE(entries[0].total_host_ns == 99 * 1000 + 1000000);
+    REQUIRE(entries[0].max_host_ns == 1000000);
+    REQUIRE(entries[0].sleep_count == 1);
+    REQUIRE(entries[0].total_sleep_ns == 5000000);
+    REQUIRE(entries[0].GetHostTimePercentile(50) == 1024);
+    REQUIRE(entries[0].GetHostTimePercentile(99.5) == 1000000);
+    REQUIRE(entries[1].sleep_count == 1);
+    REQUIRE(entries[1].total_sleep_ns == 0);
+
+    const std::string csv = statistics.FormatCSV();
+    REQUIRE(csv.find("fs:USER,Read,100,") != std::string::npos);
+
+    statistics.Reset();
+    REQUIRE(statistics.GetEntries().empty());
+}
+
+} // namespace Service
@@ -0,0 +1,50 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "core/movie.h"
+
+namespace Core {
+
+static Movie::InputState PadState(u16 buttons, s16 circle_x, s16 circle_y) {
+    return {0,
+            static_cast<u8>(buttons),
+            static_cast<u8>(buttons >> 8),
+            static_cast<u8>(circle_x),
+            static_cast<u8>(static_cast<u16>(circle_x) >> 8),
+            static_cast<u8>(circle_y),
+            static_cast<u8>(static_cast<u16>(circle_y) >> 8)};
+}
+
+TEST_CASE("Movie::MergeInputStates - Merges pad input", "[core][movie]") {
+    Movie::InputState state = PadState(0x0001, 10, 0);
+    Movie::MergeInputStates(state, PadState(0x0402, -100, 20));
+    REQUIRE(state == PadState(0x0403, -100, 20));
+}
+
+TEST_CASE("Movie::MergeInputStates - Does not depend on the order", "[core][movie]") {
+    std::vector<Movie::InputState> states{PadState(0x0001, 50, -50), PadState(0x0010, -50, 50),
+                                          PadState(0x0100, 0, 0), PadState(0x0001, 100, 0)};
+    std::sort(states.begin(), states.end());
+
+    Movie::InputState expected{};
+    bool first = true;
+    do {
+        Movie::InputState merged = states[0];
+        for (std::size_t i = 1; i < states.size(); ++i) {
+            Movie::MergeInputStates(merged, states[i]);
+        }
+        if (first) {
+            expected = merged;
+            first = false;
+        }
+        REQUIRE(merged == expected);
+    } while (std::next_permutation(states.begin(), states.end()));
+
+    REQUIRE(expected == PadState(0x0111, 100, 0));
+}
+
+} // namespace Core
@@ -0,0 +1,49 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <thread>
+#include <catch2/catch.hpp>
+#include "core/perf_stats.h"
+
+namespace Core {
+
+using namespace std::chrono_literals;
+
+TEST_CASE("PerfStats - Frame time statistics", "[core]") {
+    PerfStats perf_stats;
+    perf_stats.ResetFrameHistory();
+    REQUIRE(perf_stats.GetFrameTimeStats().frames == 0);
+
+    for (int i = 0; i < 10; ++i) {
+        perf_stats.BeginSystemFrame();
+        {
+            PerfStats::ScopedComponent cpu(perf_stats, PerfStats::Component::CPU);
+            std::this_thread::sleep_for(i == 9 ? 40ms : 2ms);
+            PerfStats::ScopedComponent gpu(perf_stats, PerfStats::Component::GPU);
+            std::this_thread::sleep_for(1ms);
+        }
+        perf_stats.EndSystemFrame();
+    }
+
+    const auto stats = perf_stats.GetFrameTimeStats();
+    REQUIRE(stats.frames == 10);
+    REQUIRE(stats.p50 >= 0.003);
+    REQUIRE(stats.p50 <= stats.p95);
+    REQUIRE(stats.p95 <= stats.p99);
+    REQUIRE(stats.max >= 0.041);
+    REQUIRE(stats.max == stats.p99);
+    REQUIRE(stats.hitches >= 1);
+
+    // Nested components are only counted in the innermost one
+    const double cpu = stats.component_time[static_cast<std::size_t>(PerfStats::Component::CPU)];
+    const double gpu = stats.component_time[static_cast<std::size_t>(PerfStats::Component::GPU)];
+    REQUIRE(cpu >= 0.0058);
+    REQUIRE(gpu >= 0.001);
+    REQUIRE(gpu < cpu);
+
+    REQUIRE(perf_stats.GetFrameTimeStats(1).frames == 1);
+    REQUIRE(perf_stats.GetFrameTimeStats(1).max >= 0.041);
+}
+
+} // namespace Core
@@ -0,0 +1,101 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <boost/asio.hpp>
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "core/rpc/local_server.h"
+#include "core/rpc/packet.h"
+
+namespace RPC {
+
+using boost::asio::local::stream_protocol;
+
+static std::string TestSocketPath() {
+    return "./citra-rpc-test-" + std::to_string(getpid()) + ".sock";
+}
+
+/// Replies to every request with its own data
+static void EchoRequest(std::unique_ptr<Packet> packet) {
+    packet->SendReply();
+}
+
+TEST_CASE("LocalServer - Replies to requests", "[core][rpc]") {
+    const std::string path = TestSocketPath();
+    {
+        LocalServer server(path, EchoRequest);
+
+        // Only the current user may connect
+        struct stat status;
+        REQUIRE(stat(path.c_str(), &status) == 0);
+        REQUIRE((status.st_mode & 0777) == 0600);
+
+        boost::asio::io_context io_context;
+        stream_protocol::socket client(io_context);
+        client.connect(stream_protocol::endpoint(path));
+
+        const std::vector<u8> data{1, 2, 3, 4, 5};
+        const PacketHeader header{CURRENT_VERSION, 42, PacketType::ReadMemoryBatch,
+                                  static_cast<u32>(data.size())};
+        boost::asio::write(client, boost::asio::buffer(&header, sizeof(header)));
+        boost::asio::write(client, boost::asio::buffer(data));
+
+        PacketHeader reply_header{};
+        std::vector<u8> reply_data(data.size());
+        boost::asio::read(client, boost::asio::buffer(&reply_header, sizeof(reply_header)));
+        boost::asio::read(client, boost::asio::buffer(reply_data));
+        REQUIRE(reply_header.id == 42);
+        REQUIRE(reply_header.packet_size == data.size());
+        REQUIRE(reply_data == data);
+    }
+    // The socket is removed when the server stops
+    struct stat status;
+    REQUIRE(stat(path.c_str(), &status) != 0);
+}
+
+TEST_CASE("LocalServer - Does not take over the socket of a running server", "[core][rpc]") {
+    const std::string path = TestSocketPath();
+    LocalServer server(path, EchoRequest);
+    REQUIRE_THROWS_AS(LocalServer(path, EchoRequest), std::runtime_error);
+
+    // The running server is still reachable
+    boost::asio::io_context io_context;
+    stream_protocol::socket client(io_context);
+    boost::system::error_code error;
+    client.connect(stream_protocol::endpoint(path), error);
+    REQUIRE(!error);
+}
+
+TEST_CASE("LocalServer - Replaces a stale socket", "[core][rpc]") {
+    const std::string path = TestSocketPath();
+    {
+        // A socket that nothing listens on, as left behind by a crashed instance
+        boost::asio::io_context io_context;
+        stream_protocol::acceptor stale(io_context);
+        stale.open(stream_protocol());
+        stale.bind(stream_protocol::endpoint(path));
+    }
+    REQUIRE_NOTHROW(LocalServer(path, EchoRequest));
+
+    // Other files are never removed
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    REQUIRE(file != nullptr);
+    std::fclose(file);
+    REQUIRE_THROWS_AS(LocalServer(path, EchoRequest), std::runtime_error);
+    REQUIRE(std::remove(path.c_str()) == 0);
+}
+
+} // namespace RPC
+
+#endif
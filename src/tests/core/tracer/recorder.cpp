@@ -0,0 +1,99 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/file_util.h"
+#include "core/tracer/reader.h"
+#include "core/tracer/recorder.h"
+
+namespace CiTrace {
+
+TEST_CASE("Recorder - Streamed recordings can be loaded", "[core][tracer]") {
+    const std::string path = "./citrace_test.ctf";
+
+    Recorder::InitialState state;
+    state.gpu_registers = {1, 2, 3};
+    state.vs_program_binary = {4, 5};
+
+    std::vector<u8> texture(0x1000, 0xAB);
+    std::vector<u8> command_list(0x10, 0x01);
+    {
+        Recorder recorder(state, path);
+        // Enough elements to span several chunks
+        for (u32 frame = 0; frame < 10; ++frame) {
+            recorder.MemoryAccessed(command_list.data(), static_cast<u32>(command_list.size()),
+                                    0x20000000);
+            recorder.MemoryAccessed(texture.data(), static_cast<u32>(texture.size()), 0x18000000);
+            for (u32 i = 0; i < 0x2000; ++i) {
+                recorder.RegisterWritten<u32>(0x10400000 + i * 4, frame);
+            }
+            recorder.RegisterWritten<u8>(0x10400018, 0xFF);
+            recorder.FrameFinished();
+        }
+        texture[0] = 0;
+        recorder.MemoryAccessed(texture.data(), static_cast<u32>(texture.size()), 0x18000000);
+        recorder.Finish();
+    }
+
+    const auto trace = LoadTrace(path);
+    FileUtil::Delete(path);
+    REQUIRE(trace.has_value());
+    REQUIRE(trace->initial_state.gpu_registers == state.gpu_registers);
+    REQUIRE(trace->initial_state.vs_program_binary == state.vs_program_binary);
+    REQUIRE(trace->initial_state.lcd_registers.empty());
+    REQUIRE(trace->stream.size() == 10 * (2 + 0x2000 + 2) + 1);
+
+    // Identical memory contents are only stored once
+    REQUIRE(trace->memory_contents.size() == 3);
+
+    const auto& first_load = trace->stream[1];
+    REQUIRE(first_load.type == MemoryLoad);
+    REQUIRE(first_load.memory_load.physical_address == 0x18000000);
+    REQUIRE(trace->memory_contents[first_load.memory_load.file_offset] ==
+            std::vector<u8>(0x1000, 0xAB));
+
+    const auto& last_load = trace->stream.back();
+    REQUIRE(last_load.type == MemoryLoad);
+    REQUIRE(trace->memory_contents[last_load.memory_load.file_offset] == texture);
+
+    const auto& write = trace->stream[2 + 0x2000];
+    REQUIRE(write.type == RegisterWrite);
+    REQUIRE(write.register_write.size == CTRegisterWrite::SIZE_8);
+    // The stream elements are packed, so copy the value before comparing it
+    const u64 value = write.register_write.value;
+    REQUIRE(value == 0xFF);
+    REQUIRE(trace->stream[2 + 0x2000 + 1].type == FrameMarker);
+    REQUIRE(trace->stream[trace->stream.size() - 2].type == FrameMarker);
+}
+
+TEST_CASE("Recorder - Waits for the writer when many chunks are pending", "[core][tracer]") {
+    const std::string path = "./citrace_queue_test.ctf";
+    // More chunks than are queued for the writer at once
+    constexpr u32 count = 0x10000 * 20;
+    {
+        Recorder recorder({}, path);
+        for (u32 i = 0; i < count; ++i) {
+            recorder.RegisterWritten<u32>(0x10400000, i);
+        }
+        recorder.Finish();
+    }
+
+    const auto trace = LoadTrace(path);
+    FileUtil::Delete(path);
+    REQUIRE(trace.has_value());
+    REQUIRE(trace->stream.size() == count);
+    const u64 value = trace->stream.back().register_write.value;
+    REQUIRE(value == count - 1);
+}
+
+TEST_CASE("Recorder - Aborted recordings are deleted", "[core][tracer]") {
+    const std::string path = "./citrace_abort_test.ctf";
+    Recorder recorder({}, path);
+    recorder.FrameFinished();
+    recorder.Abort();
+    REQUIRE(!FileUtil::Exists(path));
+}
+
+} // namespace CiTrace
@@ -0,0 +1,92 @@
+// Copyright 2020 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include "common/common_types.h"
+#include "network/packet.h"
+#include "network/room.h"
+
+namespace Network {
+
+TEST_CASE("Packet - Round trips values", "[network]") {
+    const std::vector<u8> frame{1, 2, 3, 4, 5};
+    const MacAddress mac{0x40, 0xF4, 0x07, 0x01, 0x02, 0x03};
+
+    Packet packet;
+    packet.Reserve(64);
+    packet << static_cast<u8>(7) << static_cast<u32>(0x12345678) << std::string("nick") << mac
+           << frame << static_cast<u64>(0x0123456789ABCDEF);
+
+    u8 id;
+    u32 value;
+    std::string nickname;
+    MacAddress read_mac;
+    std::vector<u8> read_frame;
+    u64 game_id;
+    packet >> id >> value >> nickname >> read_mac >> read_frame >> game_id;
+
+    REQUIRE(packet);
+    REQUIRE(packet.EndOfPacket());
+    REQUIRE(id == 7);
+    REQUIRE(value == 0x12345678);
+    REQUIRE(nickname == "nick");
+    REQUIRE(read_mac == mac);
+    REQUIRE(read_frame == frame);
+    REQUIRE(game_id == 0x0123456789ABCDEF);
+}
+
+TEST_CASE("Packet - Reads external data in place", "[network]") {
+    Packet source;
+    source << static_cast<u8>(IdWifiPacket) << std::vector<u8>(300, 0xAB);
+
+    std::vector<u8> received(static_cast<const u8*>(source.GetData()),
+                             static_cast<const u8*>(source.GetData()) + source.GetDataSize());
+    Packet packet(received.data(), received.size());
+    REQUIRE(packet.GetData() == received.data());
+    REQUIRE(packet.GetDataSize() == received.size());
+
+    u8 id;
+    std::vector<u8> frame;
+    packet >> id >> frame;
+    REQUIRE(packet);
+    REQUIRE(id == IdWifiPacket);
+    REQUIRE(frame == std::vector<u8>(300, 0xAB));
+
+    // Writing copies the external data instead of modifying it
+    packet << static_cast<u8>(1);
+    REQUIRE(packet.GetData() != received.data());
+    REQUIRE(packet.GetDataSize() == received.size() + 1);
+}
+
+TEST_CASE("Packet - Releases its data without a copy", "[network]") {
+    Packet packet;
+    packet << std::vector<u8>(300, 0xCD);
+    const void* data = packet.GetData();
+    const std::size_t size = packet.GetDataSize();
+
+    const std::vector<char> released = packet.ReleaseData();
+    REQUIRE(static_cast<const void*>(released.data()) == data);
+    REQUIRE(released.size() == size);
+    REQUIRE(packet.GetDataSize() == 0);
+
+    // External data is copied first
+    const u8 received[] = {1, 2, 3};
+    Packet view(received, sizeof(received));
+    REQUIRE(view.ReleaseData() == std::vector<char>{1, 2, 3});
+}
+
+TEST_CASE("Packet - Rejects truncated byte vectors", "[network]") {
+    Packet source;
+    source << std::vector<u8>(16, 1);
+
+    Packet packet(source.GetData(), source.GetDataSize() - 1);
+    std::vector<u8> frame;
+    packet >> frame;
+    REQUIRE(!packet);
+    REQUIRE(frame.empty());
+}
+
+} // namespace Network
@@ -15,6 +15,7 @@
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/vector_math.h"
+#include "core/core.h"
 #include "core/hw/gpu.h"
 #include "video_core/pica_state.h"
 #include "video_core/regs_framebuffer.h"
@@ -1351,21 +1352,29 @@ void RasterizerOpenGL::NotifyPicaRegisterChanged(u32 id) {
 
 void RasterizerOpenGL::FlushAll() {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    Core::PerfStats::ScopedComponent perf_component(Core::System::GetInstance().perf_stats,
+                                                    Core::PerfStats::Component::RasterizerFlush);
     res_cache.FlushAll();
 }
 
 void RasterizerOpenGL::FlushRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    Core::PerfStats::ScopedComponent perf_component(Core::System::GetInstance().perf_stats,
+                                                    Core::PerfStats::Component::RasterizerFlush);
     res_cache.FlushRegion(addr, size);
 }
 
 void RasterizerOpenGL::InvalidateRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    Core::PerfStats::ScopedComponent perf_component(Core::System::GetInstance().perf_stats,
+                                                    Core::PerfStats::Component::RasterizerFlush);
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
 
 void RasterizerOpenGL::FlushAndInvalidateRegion(PAddr addr, u32 size) {
     MICROPROFILE_SCOPE(OpenGL_CacheManagement);
+    Core::PerfStats::ScopedComponent perf_component(Core::System::GetInstance().perf_stats,
+                                                    Core::PerfStats::Component::RasterizerFlush);
     res_cache.FlushRegion(addr, size);
     res_cache.InvalidateRegion(addr, size, nullptr);
 }
@@ -19,6 +19,7 @@
 #include "common/color.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
+#include "common/metrics.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
 #include "common/vector_math.h"
@@ -1227,8 +1228,40 @@ void RasterizerCacheOpenGL::ConvertD24S8toABGR(GLuint src_tex,
     glBindTexture(GL_TEXTURE_BUFFER, 0);
 }
 
+/// Counts a lookup of a surface, whose rate of hits is the hit rate of the surface cache.
+static void CountSurfaceLookup(bool hit) {
+    static auto& hits_metric = Common::Metrics::GetCounter(
+        "citra_surface_cache_hits_total", "Surface lookups that found a cached surface");
+    static auto& misses_metric = Common::Metrics::GetCounter(
+        "citra_surface_cache_misses_total", "Surface lookups that had to create a surface");
+    (hit ? hits_metric : misses_metric).Increment();
+}
+
 Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatch match_res_scale,
                                           bool load_if_create) {
+    bool is_hit = false;
+    Surface surface = FindOrCreateSurface(params, match_res_scale, load_if_create, is_hit);
+    if (surface != nullptr) {
+        CountSurfaceLookup(is_hit);
+    }
+    return surface;
+}
+
+SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams& params,
+                                                           ScaleMatch match_res_scale,
+                                                           bool load_if_create) {
+    bool is_hit = false;
+    SurfaceRect_Tuple result =
+        FindOrCreateSurfaceSubRect(params, match_res_scale, load_if_create, is_hit);
+    if (std::get<Surface>(result) != nullptr) {
+        CountSurfaceLookup(is_hit);
+    }
+    return result;
+}
+
+Surface RasterizerCacheOpenGL::FindOrCreateSurface(const SurfaceParams& params,
+                                                   ScaleMatch match_res_scale, bool load_if_create,
+                                                   bool& is_hit) {
     if (params.addr == 0 || params.height * params.width == 0) {
         return nullptr;
     }
@@ -1240,6 +1273,7 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
     // Check for an exact match in existing surfaces
     Surface surface =
         FindMatch<MatchFlags::Exact | MatchFlags::Invalid>(surface_cache, params, match_res_scale);
+    is_hit = surface != nullptr;
 
     if (surface == nullptr) {
         u16 target_res_scale = params.res_scale;
@@ -1275,9 +1309,10 @@ Surface RasterizerCacheOpenGL::GetSurface(const SurfaceParams& params, ScaleMatc
     return surface;
 }
 
-SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams& params,
-                                                           ScaleMatch match_res_scale,
-                                                           bool load_if_create) {
+SurfaceRect_Tuple RasterizerCacheOpenGL::FindOrCreateSurfaceSubRect(const SurfaceParams& params,
+                                                                    ScaleMatch match_res_scale,
+                                                                    bool load_if_create,
+                                                                    bool& is_hit) {
     if (params.addr == 0 || params.height * params.width == 0) {
         return std::make_tuple(nullptr, Common::Rectangle<u32>{});
     }
@@ -1285,6 +1320,7 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
     // Attempt to find encompassing surface
     Surface surface = FindMatch<MatchFlags::SubRect | MatchFlags::Invalid>(surface_cache, params,
                                                                            match_res_scale);
+    is_hit = surface != nullptr;
 
     // Check if FindMatch failed because of res scaling
     // If that's the case create a new surface with
@@ -1346,8 +1382,10 @@ SurfaceRect_Tuple RasterizerCacheOpenGL::GetSurfaceSubRect(const SurfaceParams&
         // Can't have gaps in a surface
         new_params.width = aligned_params.stride;
         new_params.UpdateParams();
-        // GetSurface will create the new surface and possibly adjust res_scale if necessary
-        surface = GetSurface(new_params, match_res_scale, load_if_create);
+        // FindOrCreateSurface will create the new surface and possibly adjust res_scale if
+        // necessary
+        bool is_exact_hit = false;
+        surface = FindOrCreateSurface(new_params, match_res_scale, load_if_create, is_exact_hit);
     } else if (load_if_create) {
         ValidateSurface(surface, aligned_params.addr, aligned_params.size);
     }
@@ -1434,7 +1472,10 @@ Surface RasterizerCacheOpenGL::GetTextureSurface(const Pica::Texture::TextureInf
             params.UpdateParams();
             auto& watcher = surface->level_watchers[level - 1];
             if (!watcher || !watcher->Get()) {
-                auto level_surface = GetSurface(params, ScaleMatch::Ignore, true);
+                // Levels are part of the texture lookup and are not counted separately
+                bool is_level_hit = false;
+                auto level_surface =
+                    FindOrCreateSurface(params, ScaleMatch::Ignore, true, is_level_hit);
                 if (level_surface) {
                     watcher = level_surface->CreateWatcher();
                 } else {
@@ -1631,8 +1672,10 @@ SurfaceSurfaceRect_Tuple RasterizerCacheOpenGL::GetFramebufferSurfaces(
         // Color and Depth surfaces must have the same dimensions and offsets
         if (color_rect.bottom != depth_rect.bottom || color_rect.top != depth_rect.top ||
             color_rect.left != depth_rect.left || color_rect.right != depth_rect.right) {
-            color_surface = GetSurface(color_params, ScaleMatch::Exact, false);
-            depth_surface = GetSurface(depth_params, ScaleMatch::Exact, false);
+            // The surfaces were already counted by the lookups above
+            bool is_hit = false;
+            color_surface = FindOrCreateSurface(color_params, ScaleMatch::Exact, false, is_hit);
+            depth_surface = FindOrCreateSurface(depth_params, ScaleMatch::Exact, false, is_hit);
             fb_rect = color_surface->GetScaledRect();
         }
     } else if (color_surface != nullptr) {
@@ -1897,11 +1940,21 @@ Surface RasterizerCacheOpenGL::CreateSurface(const SurfaceParams& params) {
     return surface;
 }
 
+static void UpdateSurfaceCacheSize(const Surface& surface, int delta) {
+    static auto& surfaces_metric =
+        Common::Metrics::GetGauge("citra_surface_cache_surfaces", "Surfaces in the surface cache");
+    static auto& bytes_metric = Common::Metrics::GetGauge(
+        "citra_surface_cache_bytes", "Guest memory covered by the surfaces in the surface cache");
+    surfaces_metric.Add(delta);
+    bytes_metric.Add(static_cast<double>(delta) * surface->size);
+}
+
 void RasterizerCacheOpenGL::RegisterSurface(const Surface& surface) {
     if (surface->registered) {
         return;
     }
     surface->registered = true;
+    UpdateSurfaceCacheSize(surface, 1);
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
     UpdatePagesCachedCount(surface->addr, surface->size, 1);
 }
@@ -1911,6 +1964,7 @@ void RasterizerCacheOpenGL::UnregisterSurface(const Surface& surface) {
         return;
     }
     surface->registered = false;
+    UpdateSurfaceCacheSize(surface, -1);
     UpdatePagesCachedCount(surface->addr, surface->size, -1);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
 }
@@ -474,6 +474,17 @@ public:
     void FlushAll();
 
 private:
+    /// Implementation of GetSurface that does not count the lookup. is_hit is set to whether an
+    /// exact match was cached.
+    Surface FindOrCreateSurface(const SurfaceParams& params, ScaleMatch match_res_scale,
+                                bool load_if_create, bool& is_hit);
+
+    /// Implementation of GetSurfaceSubRect that does not count the lookup. is_hit is set to whether
+    /// an encompassing surface was cached.
+    SurfaceRect_Tuple FindOrCreateSurfaceSubRect(const SurfaceParams& params,
+                                                 ScaleMatch match_res_scale, bool load_if_create,
+                                                 bool& is_hit);
+
     void DuplicateSurface(const Surface& src_surface, const Surface& dest_surface);
 
     /// Update surface's texture for given region when necessary
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
 #include <boost/variant.hpp>
+#include "common/metrics.h"
 #include "video_core/renderer_opengl/gl_shader_manager.h"
 
 namespace OpenGL {
@@ -139,6 +140,12 @@ private:
     OGLShaderStage program;
 };
 
+static void CountShaderCacheMiss() {
+    static auto& misses_metric = Common::Metrics::GetCounter(
+        "citra_gl_shader_cache_misses_total", "Shaders the OpenGL renderer had to generate");
+    misses_metric.Increment();
+}
+
 template <typename KeyConfigType, std::string (*CodeGenerator)(const KeyConfigType&, bool),
           GLenum ShaderType>
 class ShaderCache {
@@ -148,6 +155,7 @@ public:
         auto [iter, new_shader] = shaders.emplace(config, OGLShaderStage{separable});
         OGLShaderStage& cached_shader = iter->second;
         if (new_shader) {
+            CountShaderCacheMiss();
             cached_shader.Create(CodeGenerator(config, separable).c_str(), ShaderType);
         }
         return cached_shader.GetHandle();
@@ -173,6 +181,7 @@ public:
     GLuint Get(const KeyConfigType& key, const Pica::Shader::ShaderSetup& setup) {
         auto map_it = shader_map.find(key);
         if (map_it == shader_map.end()) {
+            CountShaderCacheMiss();
             auto program_opt = CodeGenerator(setup, key, separable);
             if (!program_opt) {
                 shader_map[key] = nullptr;
@@ -175,10 +175,14 @@ void RendererOpenGL::SwapBuffers() {
 
     // Swap buffers
     render_window.PollEvents();
-    render_window.SwapBuffers();
+    {
+        Core::PerfStats::ScopedComponent perf_component(
+            Core::System::GetInstance().perf_stats, Core::PerfStats::Component::FrameLimiting);
+        render_window.SwapBuffers();
 
-    Core::System::GetInstance().frame_limiter.DoFrameLimiting(
-        Core::System::GetInstance().CoreTiming().GetGlobalTimeUs());
+        Core::System::GetInstance().frame_limiter.DoFrameLimiting(
+            Core::System::GetInstance().CoreTiming().GetGlobalTimeUs());
+    }
     Core::System::GetInstance().perf_stats.BeginSystemFrame();
 
     prev_state.Apply();
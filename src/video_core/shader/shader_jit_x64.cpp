@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/metrics.h"
 #include "common/microprofile.h"
 #include "video_core/shader/shader.h"
 #include "video_core/shader/shader_jit_x64.h"
@@ -9,8 +10,17 @@
 
 namespace Pica::Shader {
 
+static Common::Metrics::Gauge& CacheEntriesMetric() {
+    static auto& metric = Common::Metrics::GetGauge("citra_shader_jit_cache_entries",
+                                                    "PICA shaders compiled by the shader JIT");
+    return metric;
+}
+
 JitX64Engine::JitX64Engine() = default;
-JitX64Engine::~JitX64Engine() = default;
+
+JitX64Engine::~JitX64Engine() {
+    CacheEntriesMetric().Add(-static_cast<double>(cache.size()));
+}
 
 void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
     ASSERT(entry_point < MAX_PROGRAM_CODE_LENGTH);
@@ -28,6 +38,7 @@ void JitX64Engine::SetupBatch(ShaderSetup& setup, unsigned int entry_point) {
         shader->Compile(&setup.program_code, &setup.swizzle_data);
         setup.engine_data.cached_shader = shader.get();
         cache.emplace_hint(iter, cache_key, std::move(shader));
+        CacheEntriesMetric().Add(1);
     }
 }
 